@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <bigx/writer.hpp>
+
+namespace bigx::bench {
+
+// Shape of a synthetic archive
+struct ArchiveSpec {
+  size_t entryCount = 1000;
+  size_t minPathLength = 16;  // Shortest generated path, in characters
+  size_t maxPathLength = 64;  // Longest generated path, in characters
+  size_t minPayload = 256;    // Smallest payload, in bytes
+  size_t maxPayload = 16384;  // Largest payload, in bytes
+  uint32_t seed = 0x5EED;     // Same spec and seed always produce the same archive
+};
+
+// Deterministic set of archive paths and payloads
+struct SyntheticFiles {
+  std::vector<std::string> paths;
+  std::vector<std::vector<uint8_t>> payloads;
+  size_t payloadBytes = 0;
+};
+
+// Generate unique, game-like paths ("Art/Textures/ab12cd.tga") and random payloads
+inline SyntheticFiles generateFiles(const ArchiveSpec &spec) {
+  static constexpr const char *dirs[] = {"Art/Textures/", "Art/W3D/", "Data/INI/", "Audio/Sounds/",
+                                        "Maps/", "Window/"};
+  static constexpr const char *exts[] = {".tga", ".w3d", ".ini", ".wav", ".map", ".wnd"};
+  static constexpr char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789_";
+
+  std::mt19937 rng(spec.seed);
+  std::uniform_int_distribution<size_t> pathLength(spec.minPathLength, spec.maxPathLength);
+  std::uniform_int_distribution<size_t> payloadSize(spec.minPayload, spec.maxPayload);
+  std::uniform_int_distribution<size_t> pick(0, std::size(dirs) - 1);
+  std::uniform_int_distribution<size_t> letter(0, sizeof(alphabet) - 2);
+
+  SyntheticFiles files;
+  files.paths.reserve(spec.entryCount);
+  files.payloads.reserve(spec.entryCount);
+
+  for (size_t i = 0; i < spec.entryCount; ++i) {
+    size_t kind = pick(rng);
+    // The index suffix keeps paths unique however short they are
+    std::string suffix(1, '_');
+    suffix += std::to_string(i);
+    suffix += exts[kind];
+    std::string path = dirs[kind];
+    size_t target = pathLength(rng);
+    while (path.size() + suffix.size() < target) {
+      path += alphabet[letter(rng)];
+    }
+    path += suffix;
+    files.paths.push_back(std::move(path));
+
+    std::vector<uint8_t> payload(payloadSize(rng));
+    for (auto &byte : payload) {
+      byte = static_cast<uint8_t>(rng());
+    }
+    files.payloadBytes += payload.size();
+    files.payloads.push_back(std::move(payload));
+  }
+  return files;
+}
+
+// Load generated files into a writer without copying the payloads
+inline bool addToWriter(Writer &writer, const SyntheticFiles &files, std::string *outError) {
+  writer.reserve(files.paths.size());
+  for (size_t i = 0; i < files.paths.size(); ++i) {
+    if (!writer.addFileView(files.payloads[i], files.paths[i], outError)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Write a synthetic archive to path
+inline bool writeArchive(const std::filesystem::path &path, const SyntheticFiles &files,
+                         std::string *outError, const WriteOptions &options = {}) {
+  Writer writer;
+  return addToWriter(writer, files, outError) && writer.write(path, options, outError);
+}
+
+} // namespace bigx::bench
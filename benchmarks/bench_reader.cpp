@@ -0,0 +1,232 @@
+#include <cctype>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <system_error>
+#include <vector>
+
+#include <bigx/reader.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "archive_generator.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Archive generated once per entry count and shared by every benchmark using it
+struct Fixture {
+  fs::path path;
+  bigx::bench::SyntheticFiles files;
+
+  ~Fixture() {
+    std::error_code ec;
+    fs::remove(path, ec);
+  }
+};
+
+const Fixture &fixture(size_t entryCount, bool indexTrailer = false) {
+  static std::map<std::pair<size_t, bool>, std::unique_ptr<Fixture>> fixtures;
+  auto &slot = fixtures[{entryCount, indexTrailer}];
+  if (!slot) {
+    slot = std::make_unique<Fixture>();
+    bigx::bench::ArchiveSpec spec;
+    spec.entryCount = entryCount;
+    slot->files = bigx::bench::generateFiles(spec);
+    slot->path = fs::temp_directory_path() /
+                 std::format("bigx_bench_{}{}.big", entryCount, indexTrailer ? "_indexed" : "");
+    bigx::WriteOptions options;
+    options.indexTrailer = indexTrailer;
+    std::string error;
+    if (!bigx::bench::writeArchive(slot->path, slot->files, &error, options)) {
+      throw std::runtime_error("Failed to generate benchmark archive: " + error);
+    }
+  }
+  return *slot;
+}
+
+bigx::Reader openOrSkip(benchmark::State &state, const Fixture &fx,
+                        const bigx::OpenOptions &options = {}) {
+  std::string error;
+  auto reader = bigx::Reader::open(fx.path, options, &error);
+  if (!reader) {
+    state.SkipWithError(error.c_str());
+    return bigx::Reader();
+  }
+  return std::move(*reader);
+}
+
+void setEntryRate(benchmark::State &state, size_t entriesPerIteration) {
+  state.counters["entries/s"] = benchmark::Counter(
+      static_cast<double>(entriesPerIteration * state.iterations()), benchmark::Counter::kIsRate);
+}
+
+// Open and parse the directory (mapping, header, names, index)
+void BM_Open(benchmark::State &state, bigx::IndexMode mode) {
+  const Fixture &fx = fixture(static_cast<size_t>(state.range(0)));
+  bigx::OpenOptions options;
+  options.index = mode;
+  for (auto _ : state) {
+    auto reader = bigx::Reader::open(fx.path, options);
+    benchmark::DoNotOptimize(reader);
+  }
+  setEntryRate(state, fx.files.paths.size());
+}
+BENCHMARK_CAPTURE(BM_Open, standard, bigx::IndexMode::Standard)->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Open, flat, bigx::IndexMode::Flat)->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_Open, lazy, bigx::IndexMode::Lazy)->Range(1 << 10, 1 << 16);
+
+// Open an archive carrying a prebuilt index trailer, which replaces hashing the directory
+void BM_OpenIndexTrailer(benchmark::State &state) {
+  const Fixture &fx = fixture(static_cast<size_t>(state.range(0)), true);
+  bigx::OpenOptions options;
+  options.index = bigx::IndexMode::Flat;
+  for (auto _ : state) {
+    auto reader = bigx::Reader::open(fx.path, options);
+    benchmark::DoNotOptimize(reader);
+  }
+  setEntryRate(state, fx.files.paths.size());
+}
+BENCHMARK(BM_OpenIndexTrailer)->Range(1 << 10, 1 << 16);
+
+// Directory parse rate: the archive is in memory and the index comes from the trailer, so what
+// remains is the record scan, the name copy and the trailer's checksum pass
+void BM_ParseDirectory(benchmark::State &state) {
+  const Fixture &fx = fixture(static_cast<size_t>(state.range(0)), true);
+  std::ifstream in(fx.path, std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                            std::istreambuf_iterator<char>());
+  size_t directoryBytes = 0;
+  for (const std::string &path : fx.files.paths) {
+    directoryBytes += 2 * 4 + path.size() + 1;
+  }
+  bigx::OpenOptions options;
+  options.index = bigx::IndexMode::Flat;
+  for (auto _ : state) {
+    auto reader = bigx::Reader::openFromMemory(bytes, options);
+    benchmark::DoNotOptimize(reader);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(directoryBytes * state.iterations()));
+  setEntryRate(state, fx.files.paths.size());
+}
+BENCHMARK(BM_ParseDirectory)->Range(1 << 10, 1 << 16);
+
+// Case-insensitive lookup of paths that exist, upper-cased to exercise folding
+void BM_FindFileHit(benchmark::State &state) {
+  const Fixture &fx = fixture(static_cast<size_t>(state.range(0)));
+  bigx::Reader reader = openOrSkip(state, fx);
+  std::vector<std::string> queries;
+  for (const auto &path : fx.files.paths) {
+    std::string query = path;
+    for (char &c : query) {
+      c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    queries.push_back(std::move(query));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(reader.findFile(queries[i]));
+    i = (i + 1 == queries.size()) ? 0 : i + 1;
+  }
+  setEntryRate(state, 1);
+}
+BENCHMARK(BM_FindFileHit)->Range(1 << 10, 1 << 16);
+
+// Lookup of paths that share prefixes with real entries but are absent
+void BM_FindFileMiss(benchmark::State &state) {
+  const Fixture &fx = fixture(static_cast<size_t>(state.range(0)));
+  bigx::Reader reader = openOrSkip(state, fx);
+  std::vector<std::string> queries;
+  for (const auto &path : fx.files.paths) {
+    queries.push_back(std::format("{}.missing", path));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(reader.findFile(queries[i]));
+    i = (i + 1 == queries.size()) ? 0 : i + 1;
+  }
+  setEntryRate(state, 1);
+}
+BENCHMARK(BM_FindFileMiss)->Range(1 << 10, 1 << 16);
+
+// Zero-copy views over every entry, touching one byte per page
+void BM_GetFileView(benchmark::State &state) {
+  const Fixture &fx = fixture(static_cast<size_t>(state.range(0)));
+  bigx::Reader reader = openOrSkip(state, fx);
+  for (auto _ : state) {
+    uint8_t sum = 0;
+    for (const auto &entry : reader.files()) {
+      auto view = reader.getFileView(entry);
+      for (size_t at = 0; at < view.size(); at += 4096) {
+        sum = static_cast<uint8_t>(sum + view[at]);
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  setEntryRate(state, fx.files.paths.size());
+  state.SetBytesProcessed(static_cast<int64_t>(fx.files.payloadBytes * state.iterations()));
+}
+BENCHMARK(BM_GetFileView)->Range(1 << 10, 1 << 14);
+
+// Copy every payload into a fresh buffer
+void BM_ExtractToMemory(benchmark::State &state) {
+  const Fixture &fx = fixture(static_cast<size_t>(state.range(0)));
+  bigx::Reader reader = openOrSkip(state, fx);
+  for (auto _ : state) {
+    for (const auto &entry : reader.files()) {
+      auto data = reader.extractToMemory(entry);
+      benchmark::DoNotOptimize(data);
+    }
+  }
+  setEntryRate(state, fx.files.paths.size());
+  state.SetBytesProcessed(static_cast<int64_t>(fx.files.payloadBytes * state.iterations()));
+}
+BENCHMARK(BM_ExtractToMemory)->Range(1 << 10, 1 << 14);
+
+// Extract every entry to disk, one at a time (range(1) == 0) or via extractAll with threads
+// range(2) selects the extractAll backend: 0 = Portable, 1 = Batched (native batched I/O)
+void BM_Extract(benchmark::State &state) {
+  const Fixture &fx = fixture(static_cast<size_t>(state.range(0)));
+  const auto threads = static_cast<unsigned>(state.range(1));
+  bigx::Reader reader = openOrSkip(state, fx);
+  fs::path outDir = fs::temp_directory_path() / "bigx_bench_extract";
+
+  bigx::ExtractOptions options;
+  options.threads = threads;
+  options.backend =
+      state.range(2) == 0 ? bigx::ExtractBackend::Portable : bigx::ExtractBackend::Batched;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    fs::remove_all(outDir);
+    state.ResumeTiming();
+
+    if (threads == 0) {
+      for (const auto &entry : reader.files()) {
+        reader.extract(entry, outDir / entry.path);
+      }
+    } else {
+      benchmark::DoNotOptimize(reader.extractAll(outDir, options));
+    }
+  }
+  fs::remove_all(outDir);
+  setEntryRate(state, fx.files.paths.size());
+  state.SetBytesProcessed(static_cast<int64_t>(fx.files.payloadBytes * state.iterations()));
+}
+BENCHMARK(BM_Extract)
+    ->Args({1 << 10, 0, 0})
+    ->ArgsProduct({{1 << 10, 1 << 14}, {1, 4}, {0, 1}})
+    ->ArgNames({"entries", "threads", "batched"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
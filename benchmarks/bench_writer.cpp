@@ -0,0 +1,85 @@
+#include <filesystem>
+#include <string>
+
+#include <bigx/reader.hpp>
+#include <bigx/writer.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "archive_generator.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Write an archive from borrowed in-memory payloads: range(0) entries, range(1) threads
+void BM_WriteFromMemory(benchmark::State &state) {
+  bigx::bench::ArchiveSpec spec;
+  spec.entryCount = static_cast<size_t>(state.range(0));
+  const auto files = bigx::bench::generateFiles(spec);
+  fs::path outPath = fs::temp_directory_path() / "bigx_bench_write.big";
+
+  bigx::WriteOptions options;
+  options.threads = static_cast<unsigned>(state.range(1));
+
+  for (auto _ : state) {
+    bigx::Writer writer;
+    std::string error;
+    if (!bigx::bench::addToWriter(writer, files, &error) ||
+        !writer.write(outPath, options, &error)) {
+      state.SkipWithError(error.c_str());
+      break;
+    }
+  }
+  fs::remove(outPath);
+  state.counters["entries/s"] =
+      benchmark::Counter(static_cast<double>(spec.entryCount * state.iterations()),
+                         benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(static_cast<int64_t>(files.payloadBytes * state.iterations()));
+}
+BENCHMARK(BM_WriteFromMemory)
+    ->ArgsProduct({{1 << 10, 1 << 14}, {1, 4}})
+    ->ArgNames({"entries", "threads"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Write an archive streamed from a directory tree on disk
+void BM_WriteFromDirectory(benchmark::State &state) {
+  bigx::bench::ArchiveSpec spec;
+  spec.entryCount = static_cast<size_t>(state.range(0));
+  const auto files = bigx::bench::generateFiles(spec);
+
+  fs::path sourceDir = fs::temp_directory_path() / "bigx_bench_source";
+  fs::remove_all(sourceDir);
+  std::string error;
+  // Materialize the generated files once, outside the timed loop
+  fs::create_directories(sourceDir);
+  if (!bigx::bench::writeArchive(sourceDir / "staging.big", files, &error)) {
+    state.SkipWithError(error.c_str());
+    return;
+  }
+  auto reader = bigx::Reader::open(sourceDir / "staging.big", &error);
+  if (!reader || !reader->extractAll(sourceDir / "tree").ok()) {
+    state.SkipWithError("Failed to materialize source tree");
+    return;
+  }
+  fs::path outPath = fs::temp_directory_path() / "bigx_bench_write_dir.big";
+
+  for (auto _ : state) {
+    bigx::Writer writer;
+    if (!writer.addDirectory(sourceDir / "tree", "", &error) || !writer.write(outPath, &error)) {
+      state.SkipWithError(error.c_str());
+      break;
+    }
+  }
+  reader->close();
+  fs::remove_all(sourceDir);
+  fs::remove(outPath);
+  state.counters["entries/s"] =
+      benchmark::Counter(static_cast<double>(spec.entryCount * state.iterations()),
+                         benchmark::Counter::kIsRate);
+  state.SetBytesProcessed(static_cast<int64_t>(files.payloadBytes * state.iterations()));
+}
+BENCHMARK(BM_WriteFromDirectory)->Arg(1 << 10)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -1,11 +1,12 @@
 #include <filesystem>
 #include <iostream>
+#include <string>
 
 #include <bigx/bigx.hpp>
 
 int main(int argc, char *argv[]) {
   if (argc < 3) {
-    std::cerr << "Usage: " << argv[0] << " <archive.big> <output_dir>\n";
+    std::cerr << "Usage: " << argv[0] << " <archive.big> <output_dir> [threads]\n";
     return 1;
   }
 
@@ -20,17 +21,17 @@ int main(int argc, char *argv[]) {
   std::filesystem::path outputDir = argv[2];
   std::filesystem::create_directories(outputDir);
 
-  int extractedCount = 0;
-  for (const auto &file : archive->files()) {
-    std::filesystem::path outputPath = outputDir / file.path;
+  bigx::ExtractOptions options;
+  if (argc > 3) {
+    options.threads = static_cast<unsigned>(std::stoul(argv[3]));
+  }
 
-    if (!archive->extract(file, outputPath, &error)) {
-      std::cerr << "Failed to extract " << file.path << ": " << error << "\n";
-      continue;
-    }
-    ++extractedCount;
+  auto result = archive->extractAll(outputDir, options);
+  for (const auto &failure : result.failures) {
+    std::cerr << "Failed to extract " << (failure.entry ? failure.entry->path : "<archive>")
+              << ": " << failure.error << "\n";
   }
 
-  std::cout << "Extracted " << extractedCount << " files to " << outputDir << "\n";
+  std::cout << "Extracted " << result.extracted << " files to " << outputDir << "\n";
   return 0;
 }
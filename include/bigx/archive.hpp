@@ -1,10 +1,14 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
+#include <future>
 #include <memory>
+#include <memory_resource>
 #include <optional>
 #include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "types.hpp"
@@ -12,7 +16,9 @@
 namespace bigx {
 
 // Forward declarations
+class Executor;
 class Reader;
+class Updater;
 class Writer;
 
 // High-level archive interface that combines reading and writing capabilities
@@ -32,9 +38,19 @@ public:
   static std::optional<Archive> open(const std::filesystem::path &path,
                                      std::string *outError = nullptr);
 
+  // Open existing BIG archive for reading with explicit options (index mode, ...)
+  static std::optional<Archive> open(const std::filesystem::path &path, const OpenOptions &options,
+                                     std::string *outError = nullptr);
+
   // Create new BIG archive for writing
   static Archive create();
 
+  // Open existing BIG archive for in-place update (see Updater)
+  // addFile()/addFileView() stage additions; replaceFile()/removeFile() stage edits; commit()
+  // applies them. Returns std::nullopt on failure, with error message in outError if provided
+  static std::optional<Archive> openForUpdate(const std::filesystem::path &path,
+                                              std::string *outError = nullptr);
+
   // Add file to archive (from disk)
   bool addFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
                std::string *outError = nullptr);
@@ -43,37 +59,112 @@ public:
   bool addFile(std::span<const uint8_t> data, const std::string &archivePath,
                std::string *outError = nullptr);
 
+  // Add every regular file below root, stored under archivePrefix
+  bool addDirectory(const std::filesystem::path &root, const std::string &archivePrefix = "",
+                    std::string *outError = nullptr);
+
+  // Add file to archive from caller-owned memory without copying (must outlive write())
+  bool addFileView(std::span<const uint8_t> data, const std::string &archivePath,
+                   std::string *outError = nullptr);
+
+  // Stage new contents for an existing file from disk (only available when updating)
+  bool replaceFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
+                   std::string *outError = nullptr);
+
+  // Stage new contents for an existing file from memory (only available when updating)
+  bool replaceFile(std::span<const uint8_t> data, const std::string &archivePath,
+                   std::string *outError = nullptr);
+
+  // Stage removal of a file (only available when updating)
+  bool removeFile(const std::string &archivePath, std::string *outError = nullptr);
+
+  // Apply staged changes in place (only available when updating)
+  bool commit(const UpdateOptions &options = {}, std::string *outError = nullptr);
+
+  // Commit, then rewrite the archive without dead space (only available when updating)
+  bool compact(const UpdateOptions &options = {}, std::string *outError = nullptr);
+
   // Write archive to disk
   bool write(const std::filesystem::path &destPath, std::string *outError = nullptr);
 
-  // Get list of all files (only available when reading)
+  // Write archive to disk with explicit options (worker threads, ...)
+  bool write(const std::filesystem::path &destPath, const WriteOptions &options,
+             std::string *outError = nullptr);
+
+  // Get list of all files (when updating: the directory as of the last commit)
   const std::vector<FileEntry> &files() const;
 
   // Get file count
   size_t fileCount() const;
 
   // Case-insensitive file lookup (only available when reading)
-  const FileEntry *findFile(const std::string &path) const;
+  const FileEntry *findFile(std::string_view path) const;
 
   // Extract file to disk (only available when reading)
   bool extract(const FileEntry &entry, const std::filesystem::path &destPath,
                std::string *outError = nullptr) const;
 
+  // Extract all files into destDir in parallel (only available when reading)
+  ExtractResult extractAll(const std::filesystem::path &destDir,
+                           const ExtractOptions &options = {}) const;
+
+  // Extract the given entries into destDir in parallel (only available when reading)
+  ExtractResult extractAll(const std::filesystem::path &destDir,
+                           std::span<const FileEntry *const> entries,
+                           const ExtractOptions &options = {}) const;
+
+  // Extract entries accepted by predicate into destDir in parallel (only available when reading)
+  ExtractResult extractAll(const std::filesystem::path &destDir,
+                           const std::function<bool(const FileEntry &)> &predicate,
+                           const ExtractOptions &options = {}) const;
+
   // Extract file to memory (only available when reading)
   std::optional<std::vector<uint8_t>> extractToMemory(const FileEntry &entry,
                                                       std::string *outError) const;
 
+  // Extract file to memory allocated from resource (only available when reading)
+  std::optional<std::pmr::vector<uint8_t>> extractToMemory(const FileEntry &entry,
+                                                           std::pmr::memory_resource &resource,
+                                                           std::string *outError = nullptr) const;
+
+  // Extract file into a caller-owned buffer, returning bytes written (only available when reading)
+  std::optional<size_t> extractTo(const FileEntry &entry, std::span<uint8_t> out,
+                                  std::string *outError = nullptr) const;
+
+  // Get the number of bytes extraction produces for an entry (0 when not reading)
+  size_t extractedSize(const FileEntry &entry) const;
+
+  // Extract file to memory on executor (defaultExecutor() if nullptr, only available when reading)
+  // When not reading, the returned future is already ready with an error
+  std::future<ExtractedFile> extractAsync(const FileEntry &entry,
+                                          Executor *executor = nullptr) const;
+
+  // Extract file to memory on executor and hand the result to onComplete (see Reader)
+  // When not reading, onComplete is called immediately with an error
+  void extractAsync(const FileEntry &entry, ExtractCallback onComplete,
+                    Executor *executor = nullptr) const;
+
+  // Extract several files as independent tasks (see Reader)
+  void extractAsync(std::span<const FileEntry *const> entries, ExtractCallback onComplete,
+                    Executor *executor = nullptr) const;
+
   // Get file view (zero-copy if memory-mapped, only available when reading)
   std::span<const uint8_t> getFileView(const FileEntry &entry) const;
 
+  // Get the variant of the archive being read or updated (ArchiveFormat::BigF otherwise)
+  ArchiveFormat format() const;
+
   // Check if archive is open for reading
   bool isReading() const { return reader_.get() != nullptr; }
 
   // Check if archive is open for writing
   bool isWriting() const { return writer_.get() != nullptr; }
 
-  // Check if archive is open (either mode)
-  bool isOpen() const { return isReading() || isWriting(); }
+  // Check if archive is open for in-place update
+  bool isUpdating() const { return updater_.get() != nullptr; }
+
+  // Check if archive is open (any mode)
+  bool isOpen() const { return isReading() || isWriting() || isUpdating(); }
 
   // Close archive
   void close();
@@ -84,6 +175,7 @@ public:
 private:
   std::unique_ptr<Reader> reader_;
   std::unique_ptr<Writer> writer_;
+  std::unique_ptr<Updater> updater_;
 };
 
 } // namespace bigx
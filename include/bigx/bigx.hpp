@@ -5,8 +5,16 @@
 // used by Command & Conquer Generals and other Westwood Studios games.
 
 #include "archive.hpp"
+#include "byte_source.hpp"
+#include "cache.hpp"
+#include "directory_tree.hpp"
+#include "executor.hpp"
 #include "reader.hpp"
+#include "stats.hpp"
+#include "trace.hpp"
 #include "types.hpp"
+#include "updater.hpp"
+#include "virtualfs.hpp"
 #include "writer.hpp"
 
 // The library provides three levels of abstraction:
@@ -19,6 +27,10 @@
 // 2. High-level: Archive class
 //    - Unified interface for both reading and writing
 //    - Use Archive::open() to read, Archive::create() to write
+//    - Use Archive::openForUpdate() to patch an archive in place (see Updater)
+//
+// 3. Multi-archive: VirtualFS class
+//    - Mounts many archives with override priorities, like the game's loader
 //
 // Example usage:
 //
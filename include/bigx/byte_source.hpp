@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace bigx {
+
+// Positioned-read access to an archive that is not a local file (Reader::openFromSource)
+// Implement this to serve archives from HTTP range requests, a decrypting stream, a region of
+// another container and so on. The reader fetches the header and directory at open and each
+// payload when it is extracted, so only the bytes actually used are transferred. read() may be
+// called from several threads at once.
+class ByteSource {
+public:
+  virtual ~ByteSource() = default;
+
+  // Total size of the archive in bytes
+  virtual uint64_t size() const = 0;
+
+  // Fill out with the bytes at [offset, offset + out.size()), a range that lies within size()
+  // Returns true on success, false on failure (error in outError if provided)
+  virtual bool read(uint64_t offset, std::span<uint8_t> out, std::string *outError) const = 0;
+};
+
+} // namespace bigx
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "types.hpp"
+
+namespace bigx {
+
+class Reader;
+
+// Immutable extracted payload shared between cache and callers
+using SharedBuffer = std::shared_ptr<const std::vector<uint8_t>>;
+
+// Snapshot of cache counters
+struct CacheStats {
+  uint64_t hits = 0;      // Requests served from the cache
+  uint64_t misses = 0;    // Requests that had to extract
+  uint64_t evictions = 0; // Buffers dropped to stay within budget
+  size_t bytes = 0;       // Bytes currently cached
+  size_t entries = 0;     // Buffers currently cached
+};
+
+// Size-bounded LRU cache in front of Reader::extractToMemory()
+// Buffers are keyed by (reader, entry offset, entry size) and handed out as shared immutable
+// vectors, so hot files are extracted (and decompressed, if the reader decodes RefPack) once.
+// Evicted buffers stay alive for callers still holding them. All methods are thread-safe;
+// extraction on a miss runs outside the lock so loader threads do not serialize on it.
+class ExtractCache {
+public:
+  // Create a cache holding at most byteBudget bytes of payload
+  explicit ExtractCache(size_t byteBudget);
+
+  // Delete copy and move (shared between threads by reference)
+  ExtractCache(const ExtractCache &) = delete;
+  ExtractCache &operator=(const ExtractCache &) = delete;
+
+  // Get an entry's contents, extracting through reader on a miss
+  // Payloads larger than the budget are returned but not cached
+  // Returns nullptr on failure, with error message in outError if provided
+  SharedBuffer get(const Reader &reader, const FileEntry &entry, std::string *outError = nullptr);
+
+  // Drop every buffer extracted from reader (call before closing or destroying it)
+  void evict(const Reader &reader);
+
+  // Drop everything
+  void clear();
+
+  // Change the byte budget, evicting as needed
+  void setBudget(size_t byteBudget);
+
+  // Get the byte budget
+  size_t budget() const;
+
+  // Get a snapshot of the counters
+  CacheStats stats() const;
+
+private:
+  struct Key {
+    const Reader *reader = nullptr;
+    uint64_t offset = 0;
+    uint64_t size = 0;
+
+    bool operator==(const Key &) const = default;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const noexcept;
+  };
+
+  struct Node {
+    Key key;
+    SharedBuffer buffer;
+  };
+
+  // Evict least recently used buffers until within budget (lock must be held)
+  void trim();
+
+  mutable std::mutex mutex_;
+  size_t budget_ = 0;
+  std::list<Node> lru_; // Most recently used at the front
+  std::unordered_map<Key, std::list<Node>::iterator, KeyHash> index_;
+  CacheStats stats_;
+};
+
+} // namespace bigx
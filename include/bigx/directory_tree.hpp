@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "types.hpp"
+
+namespace bigx {
+
+// Immediate contents of one directory, each list sorted case-insensitively
+struct DirectoryListing {
+  std::vector<std::string_view> directories; // Names of the subdirectories
+  std::vector<const EntryView *> files;      // Files directly inside the directory
+};
+
+// Hierarchical index over a directory's paths, for listing and pattern enumeration
+// Built once over a span of entries; every node keeps its subdirectories and files sorted, so a
+// query only touches the directories on its way and the nodes whose contents it returns. Paths
+// are matched case-insensitively and either slash style is accepted. The tree stores views into
+// the entries, which must outlive it.
+class DirectoryTree {
+public:
+  // Build the tree over entries (paths with forward slashes, as in Reader::entries())
+  void build(std::span<const EntryView> entries);
+
+  // Remove all nodes
+  void clear();
+
+  // List a directory ("Data/INI", trailing slash optional, empty for the root)
+  // Returns std::nullopt if there is no such directory
+  std::optional<DirectoryListing> list(std::string_view directory) const;
+
+  // Visit every file below a directory, depth first: a directory's files come before its
+  // subdirectories, and both in sorted order. Returns false if there is no such directory.
+  bool forEachFile(std::string_view directory,
+                   const std::function<void(const EntryView &)> &visitor) const;
+
+  // Collect the files matching a glob pattern, in forEachFile() order
+  // '*' and '?' match within one path segment and a "**" segment matches any number of
+  // directories, so "Art/Textures/*.dds" lists one directory and "Data/**/*.ini" a subtree.
+  std::vector<const EntryView *> glob(std::string_view pattern) const;
+
+  // Number of directories, not counting the root
+  size_t directoryCount() const { return nodes_.empty() ? 0 : nodes_.size() - 1; }
+
+private:
+  struct Node {
+    std::string_view name;  // Last path segment, in the case of the first entry seen
+    uint32_t firstDir = 0;  // Subdirectories: childDirs_[firstDir, firstDir + dirCount)
+    uint32_t dirCount = 0;
+    uint32_t firstFile = 0; // Files: childFiles_[firstFile, firstFile + fileCount)
+    uint32_t fileCount = 0;
+  };
+
+  // Find the node for a directory path, or nullopt
+  std::optional<uint32_t> findDirectory(std::string_view directory) const;
+
+  // Find a subdirectory of node by name, or nullopt
+  std::optional<uint32_t> findChild(uint32_t node, std::string_view name) const;
+
+  // Visit every file below node in forEachFile() order
+  void visit(uint32_t node, const std::function<void(const EntryView &)> &visitor) const;
+
+  // Append the files below node matching the remaining pattern segments
+  void match(uint32_t node, std::span<const std::string_view> segments,
+             std::vector<const EntryView *> &out) const;
+
+  std::vector<Node> nodes_;                  // nodes_[0] is the root
+  std::vector<uint32_t> childDirs_;          // Node indices, grouped by parent, sorted by name
+  std::vector<const EntryView *> childFiles_; // Entries, grouped by parent, sorted by name
+};
+
+// Check one path against a glob pattern, with the same rules as DirectoryTree::glob()
+// Useful for filtering paths that are not in a tree, such as files about to be packed.
+bool globMatch(std::string_view pattern, std::string_view path);
+
+} // namespace bigx
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+namespace bigx {
+
+// Runs tasks submitted by bigx's asynchronous APIs (Reader::extractAsync, ...)
+// Implement this to route bigx work onto an existing job system. submit() may be called from
+// any thread; tasks must eventually run exactly once and may run in any order.
+class Executor {
+public:
+  virtual ~Executor() = default;
+
+  // Schedule task for execution
+  virtual void submit(std::function<void()> task) = 0;
+};
+
+// Fixed-size pool of worker threads fed from one FIFO queue
+class ThreadPool final : public Executor {
+public:
+  // Start threads workers (0 = hardware concurrency)
+  explicit ThreadPool(unsigned threads = 0);
+
+  // Run every task already queued, then join the workers
+  ~ThreadPool() override;
+
+  // Delete copy and move (workers reference the pool)
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  void submit(std::function<void()> task) override;
+
+  // Number of worker threads
+  size_t threadCount() const { return workers_.size(); }
+
+private:
+  void run();
+
+  std::mutex mutex_;
+  std::deque<std::function<void()>> queue_;
+  std::counting_semaphore<> tokens_{0}; // One per queued task, plus one per worker at shutdown
+  std::vector<std::thread> workers_;
+};
+
+// Process-wide pool used when no executor is supplied; started on first use
+Executor &defaultExecutor();
+
+} // namespace bigx
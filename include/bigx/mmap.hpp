@@ -3,6 +3,9 @@
 #include <cstdint>
 #include <filesystem>
 #include <span>
+#include <string>
+
+#include "types.hpp"
 
 namespace bigx {
 
@@ -33,6 +36,18 @@ public:
   // Get mapped data (mutable view for write mode)
   std::span<uint8_t> data() { return std::span<uint8_t>(static_cast<uint8_t *>(data_), size_); }
 
+  // Hint the expected access pattern for a range (madvise on POSIX)
+  // The range is widened to page boundaries and clamped to the mapping. Hints are advisory:
+  // returns false only if the file is not open or the OS rejected the hint.
+  bool advise(AccessPattern pattern, size_t offset = 0, size_t length = SIZE_MAX);
+
+  // Ask the OS to start reading a range into memory ahead of use
+  // (MADV_WILLNEED on POSIX, PrefetchVirtualMemory on Windows)
+  bool prefetch(size_t offset, size_t length);
+
+  // Prefetch several ranges with as few system calls as the OS allows
+  bool prefetch(std::span<const MappedRange> ranges);
+
   // Flush changes to disk (write mode only)
   bool flush(std::string *outError = nullptr);
 
@@ -48,6 +63,10 @@ public:
 private:
   void cleanup() noexcept;
 
+  // Clamp a range to the mapping and widen it to page boundaries
+  // Returns false if the range is empty after clamping
+  bool pageRange(size_t offset, size_t length, void **outStart, size_t *outLength) const;
+
 #ifdef _WIN32
   void *fileHandle_ = nullptr;    // HANDLE on Windows
   void *mappingHandle_ = nullptr; // HANDLE on Windows
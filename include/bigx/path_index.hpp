@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "types.hpp"
+
+namespace bigx::detail {
+
+// Case-insensitive path hash (ASCII case folding, backslashes hashed as forward slashes)
+uint64_t hashPath(std::string_view path) noexcept;
+
+// Case-insensitive path comparison using the same folding rules as hashPath
+bool pathEquals(std::string_view a, std::string_view b) noexcept;
+
+// Transparent case-insensitive hash and equality for maps keyed by paths
+// Any std::string_view of any case and slash style can probe such a map without being copied.
+struct PathHash {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view path) const noexcept {
+    return static_cast<size_t>(hashPath(path));
+  }
+};
+
+struct PathEqual {
+  using is_transparent = void;
+
+  bool operator()(std::string_view a, std::string_view b) const noexcept {
+    return pathEquals(a, b);
+  }
+};
+
+// Open-addressing hash table mapping case-folded paths to entry indices
+// The table only stores hashes and indices; names are read from the EntryView span passed to
+// build() and find(), so the whole index is a single allocation regardless of entry count.
+class PathIndex {
+public:
+  // Build the table over entries
+  // Returns false if two entries fold to the same path (index of the later one in outDuplicate)
+  bool build(std::span<const EntryView> entries, size_t *outDuplicate = nullptr);
+
+  // Look up path (any case, either slash style); returns the entry index if present
+  std::optional<uint32_t> find(std::span<const EntryView> entries, std::string_view path) const;
+
+  // Look up path, reading candidate names through nameOf(index) -> std::string_view
+  // For tables adopted by load() before the directory has been parsed
+  template <typename NameOf>
+  std::optional<uint32_t> find(std::string_view path, NameOf &&nameOf) const;
+
+  // Remove all slots
+  void clear();
+
+  // Number of slots (a power of two, or zero before build()/load())
+  size_t slotCount() const { return slots_.size(); }
+
+  // Serialize the slots into slotCount() * slotBytes bytes of big-endian (hash, index) pairs
+  void store(uint8_t *out) const;
+
+  // Adopt slots serialized by store() for a directory of entryCount entries
+  // Returns false, leaving the table empty, unless the table is well-formed: a power-of-two size
+  // of at least 16, exactly entryCount used slots and every index below entryCount.
+  bool load(const uint8_t *data, size_t slotCount, size_t entryCount);
+
+  static constexpr size_t slotBytes = 8;
+
+private:
+  static constexpr uint32_t emptySlot = UINT32_MAX;
+
+  struct Slot {
+    uint32_t hash = 0;          // Low 32 bits of hashPath()
+    uint32_t index = emptySlot; // Entry index, emptySlot if unused
+  };
+
+  std::vector<Slot> slots_; // Power-of-two sized, linear probing
+};
+
+template <typename NameOf>
+std::optional<uint32_t> PathIndex::find(std::string_view path, NameOf &&nameOf) const {
+  if (slots_.empty()) {
+    return std::nullopt;
+  }
+
+  const size_t mask = slots_.size() - 1;
+  uint32_t hash = static_cast<uint32_t>(hashPath(path));
+
+  for (size_t slot = hash & mask; slots_[slot].index != emptySlot; slot = (slot + 1) & mask) {
+    const Slot &candidate = slots_[slot];
+    if (candidate.hash == hash && pathEquals(nameOf(candidate.index), path)) {
+      return candidate.index;
+    }
+  }
+
+  return std::nullopt;
+}
+
+} // namespace bigx::detail
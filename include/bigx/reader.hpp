@@ -1,17 +1,38 @@
 #pragma once
 
+#include <array>
 #include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
+#include "byte_source.hpp"
+#include "directory_tree.hpp"
 #include "mmap.hpp"
+#include "path_index.hpp"
+#include "trace.hpp"
 #include "types.hpp"
 
 namespace bigx {
 
+class Executor;
+
+// Read-only access to a memory-mapped BIG archive
+// Thread safety: once open() returns, every const member may be called concurrently from any
+// number of threads without external locking. The directory, lookup index, FileEntry list and
+// directory tree are immutable after they are built: at open, or (IndexMode::Flat/Lazy) exactly
+// once on first use under std::call_once, after which each call costs a single acquire check.
+// Lookups and views take no lock; extraction only allocates or writes caller-owned storage;
+// counters are relaxed atomics, and only an attached AccessTrace serializes on its own mutex.
+// Returned pointers, views and entries stay valid until the reader is closed, moved from or
+// destroyed, which (like every non-const member) must not race with any other call.
 class Reader {
 public:
   Reader() = default;
@@ -28,48 +49,293 @@ public:
   static std::optional<Reader> open(const std::filesystem::path &path,
                                     std::string *outError = nullptr);
 
+  // Open BIG archive from file with explicit options (index mode, ...)
+  static std::optional<Reader> open(const std::filesystem::path &path, const OpenOptions &options,
+                                    std::string *outError = nullptr);
+
+  // Open BIG archive held in memory, without copying it
+  // The memory must stay valid and unchanged until the reader is closed. Opening a nested
+  // archive straight from its parent's getFileView() this way costs no copy and no temp file.
+  // Returns std::nullopt on failure, with error message in outError if provided
+  static std::optional<Reader> openFromMemory(std::span<const uint8_t> data,
+                                              std::string *outError = nullptr);
+
+  // Open BIG archive held in memory with explicit options (index mode, ...)
+  static std::optional<Reader> openFromMemory(std::span<const uint8_t> data,
+                                              const OpenOptions &options,
+                                              std::string *outError = nullptr);
+
+  // Open BIG archive through positioned reads (see ByteSource)
+  // Only the header and directory are read at open; each payload is read when it is extracted,
+  // so getFileView() returns an empty span for payloads. Index and checksum trailers are not
+  // read, and verify() checks the directory only.
+  // Returns std::nullopt on failure, with error message in outError if provided
+  static std::optional<Reader> openFromSource(std::shared_ptr<const ByteSource> source,
+                                              std::string *outError = nullptr);
+
+  // Open BIG archive through positioned reads with explicit options (index mode, ...)
+  static std::optional<Reader> openFromSource(std::shared_ptr<const ByteSource> source,
+                                              const OpenOptions &options,
+                                              std::string *outError = nullptr);
+
   // Get list of all files
-  const std::vector<FileEntry> &files() const { return files_; }
+  // With IndexMode::Flat or IndexMode::Lazy the FileEntry objects are built on the first call
+  const std::vector<FileEntry> &files() const;
+
+  // Get allocation-free views of all directory entries (same order as files())
+  std::span<const EntryView> entries() const;
 
   // Get total number of files
-  size_t fileCount() const { return files_.size(); }
+  size_t fileCount() const;
+
+  // Case-insensitive file lookup; the path is hashed and compared in place, never copied
+  // Returns nullptr if file not found
+  const FileEntry *findFile(std::string_view path) const;
 
-  // Case-insensitive file lookup
+  // Case-insensitive lookup that never materializes FileEntry objects
   // Returns nullptr if file not found
-  const FileEntry *findFile(const std::string &path) const;
+  const EntryView *findEntry(std::string_view path) const;
+
+  // Case-insensitive lookup by linear scan over the raw directory records
+  // Never builds the index, so it is the cheapest way to fetch one or two known files from an
+  // archive opened with IndexMode::Lazy; with an adopted index trailer it probes the trailer's
+  // table instead of scanning. The returned path points into the mapping as stored (slashes not
+  // normalized). Returns std::nullopt if not found or the directory is malformed.
+  std::optional<EntryView> scanFor(std::string_view path) const;
+
+  // Get the directory tree over entries(), built on the first call
+  const DirectoryTree &tree() const;
+
+  // List a directory's subdirectories and files ("Data/INI"; see DirectoryTree::list)
+  std::optional<DirectoryListing> listDirectory(std::string_view directory) const;
+
+  // Collect the entries matching a pattern such as "Art/Textures/*.dds" (see DirectoryTree::glob)
+  std::vector<const EntryView *> glob(std::string_view pattern) const;
+
+  // Check whether open() adopted a prebuilt index trailer (WriteOptions::indexTrailer)
+  // Such a reader skips hashing the directory, and scanFor() becomes a hash probe.
+  bool hasIndexTrailer() const { return !trailerRecords_.empty(); }
+
+  // Error from a deferred (IndexMode::Lazy) directory parse, empty if none
+  // A lazily opened archive whose directory turns out to be malformed behaves as empty.
+  const std::string &indexError() const;
 
   // Extract file to disk
   // Returns true on success, false on failure (error in outError if provided)
   bool extract(const FileEntry &entry, const std::filesystem::path &destPath,
                std::string *outError = nullptr) const;
 
+  // Extract every file into destDir, preserving archive paths
+  // Parent directories are created once up front, then files are written on options.threads
+  // workers (optionally batching open/write/close through io_uring or overlapped I/O, see
+  // ExtractBackend). Failures are collected per entry in the result instead of stopping the run.
+  ExtractResult extractAll(const std::filesystem::path &destDir,
+                           const ExtractOptions &options = {}) const;
+
+  // Check whether ExtractBackend::Batched uses native batched I/O on this system
+  // (false means it silently falls back to the portable path)
+  static bool batchedExtractSupported();
+
+  // Extract the given entries into destDir (see extractAll above)
+  ExtractResult extractAll(const std::filesystem::path &destDir,
+                           std::span<const FileEntry *const> entries,
+                           const ExtractOptions &options = {}) const;
+
+  // Extract the entries accepted by predicate into destDir (see extractAll above)
+  ExtractResult extractAll(const std::filesystem::path &destDir,
+                           const std::function<bool(const FileEntry &)> &predicate,
+                           const ExtractOptions &options = {}) const;
+
   // Extract file to memory
   // Returns std::nullopt on failure, with error message in outError if provided
   std::optional<std::vector<uint8_t>> extractToMemory(const FileEntry &entry,
                                                       std::string *outError = nullptr) const;
 
+  // Extract file to memory, allocating the result from resource (e.g. a per-frame arena)
+  // Returns std::nullopt on failure, with error message in outError if provided
+  std::optional<std::pmr::vector<uint8_t>> extractToMemory(const FileEntry &entry,
+                                                           std::pmr::memory_resource &resource,
+                                                           std::string *outError = nullptr) const;
+
+  // Extract file into a caller-owned buffer without allocating
+  // out must hold at least extractedSize(entry) bytes; extra space is left untouched
+  // A payload that starts with a RefPack header but does not decode is extracted as stored
+  // Returns the number of bytes written, or std::nullopt on failure (error in outError)
+  std::optional<size_t> extractTo(const FileEntry &entry, std::span<uint8_t> out,
+                                  std::string *outError = nullptr) const;
+
+  // Get the number of bytes extraction produces for an entry
+  // (uncompressedSize() when decoding RefPack, entry.size otherwise; 0 for invalid bounds)
+  size_t extractedSize(const FileEntry &entry) const;
+
+  // Extract file to memory on executor (defaultExecutor() if nullptr)
+  // The reader and entry must stay valid and open until the result is ready
+  std::future<ExtractedFile> extractAsync(const FileEntry &entry,
+                                          Executor *executor = nullptr) const;
+
+  // Extract file to memory on executor and hand the result to onComplete
+  void extractAsync(const FileEntry &entry, ExtractCallback onComplete,
+                    Executor *executor = nullptr) const;
+
+  // Extract several files as independent tasks; onComplete runs once per entry as each finishes,
+  // possibly concurrently, so it must be thread-safe
+  void extractAsync(std::span<const FileEntry *const> entries, ExtractCallback onComplete,
+                    Executor *executor = nullptr) const;
+
+  // Check the archive's integrity straight off the mapping
+  // Always validates the directory in one sorted pass: every payload must lie behind the directory
+  // and two entries may only overlap by sharing the exact same range. With a checksum trailer
+  // (WriteOptions::checksums) every payload's CRC-32C is also checked, on options.threads workers.
+  VerifyResult verify(const VerifyOptions &options = {}) const;
+
+  // Check whether the archive carries a valid checksum trailer for verify()
+  bool hasChecksums() const;
+
+  // Check whether an entry's payload is RefPack-compressed
+  bool isCompressed(const FileEntry &entry) const;
+
+  // Get an entry's decoded size (declared RefPack size, or entry.size if stored raw)
+  size_t uncompressedSize(const FileEntry &entry) const;
+
   // Get file view (zero-copy if memory-mapped)
-  // Returns empty span if file bounds are invalid
+  // Always returns the stored bytes, even when OpenOptions::decompress is set
+  // Returns empty span if file bounds are invalid or the reader was opened with openFromSource()
   std::span<const uint8_t> getFileView(const FileEntry &entry) const;
 
+  // Get file view for an entry from entries()/findEntry()
+  std::span<const uint8_t> getFileView(const EntryView &entry) const;
+
+  // Hint how the archive will be read (see MappedFile::advise)
+  bool advise(AccessPattern pattern) const;
+
+  // Start paging in an entry's payload ahead of use
+  // Returns false if the hint could not be issued (closed or unmapped archive, invalid bounds)
+  bool prefetch(const FileEntry &entry) const;
+
+  // Start paging in several entries' payloads, e.g. the next level's assets
+  bool prefetch(std::span<const FileEntry *const> entries) const;
+
+  // Start paging in archive byte ranges, e.g. a prefetchList() built from an access trace
+  bool prefetch(std::span<const MappedRange> ranges) const;
+
+  // Get the archive variant (BIGF, BIG4 or the 64-bit BIGX extension)
+  ArchiveFormat format() const;
+
   // Check if archive is open
   bool isOpen() const;
 
-  // Close archive
+  // Close archive (counters are kept)
   void close();
 
+  // Get a snapshot of the instrumentation counters (all zero unless built with BIGX_ENABLE_STATS)
+  ReaderStats stats() const;
+
 private:
-  bool parse(std::string *outError);
+  // Read the header and complete directory from source_ into sourceBytes_
+  bool loadFromSource(std::string *outError);
+
+  // Shared body of the open functions; load() makes data_ and archiveSize_ available
+  static std::optional<Reader> openWith(const OpenOptions &options, std::string *outError,
+                                        const std::function<bool(Reader &, std::string *)> &load);
+
+  // Validate header and record the directory entry count
+  bool parseHeader(std::string *outError);
+
+  // Parse directory records into entries_/names_ and build the lookup index
+  bool parseDirectory(std::string *outError) const;
+
+  // Run the directory parse once if it was deferred (IndexMode::Lazy)
+  void ensureIndexed() const;
+
+  // Phase callback given at open (nullptr without stats)
+  const PhaseCallback *phaseCallback() const;
+
+  // Copy or decode an entry's payload into buffer (a std::vector or std::pmr::vector)
+  template <typename Buffer>
+  std::optional<Buffer> materialize(const FileEntry &entry, Buffer buffer,
+                                    std::string *outError) const;
+
+  // Synchronous body of extractAsync()
+  ExtractedFile extractEntry(const FileEntry &entry) const;
+
+  // Check that entry payload lies within the archive
+  bool inBounds(const FileEntry &entry) const;
+
+  // getFileView() without recording the access, for internal reads
+  std::span<const uint8_t> viewOf(const FileEntry &entry) const;
+  std::span<const uint8_t> viewOf(const EntryView &entry) const;
+
+  // Stored bytes of an in-bounds entry: its view, or for source-backed readers a read into
+  // scratch. Returns std::nullopt if the read fails (error in outError if provided)
+  std::optional<std::span<const uint8_t>> payloadOf(const FileEntry &entry,
+                                                    std::vector<uint8_t> &scratch,
+                                                    std::string *outError) const;
+
+  // Up to the first 16 stored bytes of an entry (enough for a RefPack header), empty on failure
+  std::span<const uint8_t> headOf(const FileEntry &entry, std::array<uint8_t, 16> &scratch) const;
+
+  // Record an access when tracing (OpenOptions::trace)
+  void traceAccess(TraceOp op, std::string_view path) const {
+    if (trace_) {
+      trace_->record(op, path);
+    }
+  }
+
+  // Write entry payload to destPath (decoded if decompress_); parent directory must exist
+  // The number of bytes written is stored in outWritten if provided
+  bool writeFile(const FileEntry &entry, const std::filesystem::path &destPath,
+                 std::string *outError, size_t *outWritten = nullptr) const;
+
+  // Write entries[i] to destPaths[i] through per-thread batched native I/O
+  // Slots with a non-empty error are skipped; failures are stored in errors
+  // Returns the total number of bytes written
+  size_t writeFilesBatched(std::span<const FileEntry *const> entries,
+                           std::span<const std::filesystem::path> destPaths,
+                           std::span<std::string> errors, unsigned threads) const;
+
+  // Check that an archive path stays inside the extraction directory
+  static bool isSafeRelativePath(const std::string &path);
+
+  // One-time initialization state for deferred index and FileEntry construction
+  struct LazyState {
+    std::once_flag indexOnce;
+    std::once_flag filesOnce;
+    std::once_flag treeOnce;
+    std::string indexError;
+  };
+
+  // Archive bytes: data_ is the whole mapping or borrowed buffer, or for openFromSource() the
+  // header and directory copied into sourceBytes_, with payloads read from source_ on demand
+  mutable MappedFile mappedFile_; // Mutable only for advisory calls (advise/prefetch)
+  std::span<const uint8_t> data_;
+  uint64_t archiveSize_ = 0;
+  std::shared_ptr<const ByteSource> source_;
+  std::vector<uint8_t> sourceBytes_;
+
+  ArchiveFormat format_ = ArchiveFormat::BigF; // Variant identified by the header
+  uint32_t directoryCount_ = 0;                // Entry count from the header
+  mutable size_t directoryEnd_ = 0;            // End of the last directory record, once parsed
+  bool decompress_ = false;                    // Decode RefPack payloads on extraction
+
+  // Directory index, built by parseDirectory() (at open unless IndexMode::Lazy)
+  mutable std::vector<char> names_;        // Normalized entry names stored back to back
+  mutable std::vector<EntryView> entries_; // Directory entries, paths point into names_
+  mutable detail::PathIndex index_;        // Case-insensitive path -> entry index
+
+  // Prebuilt table adopted from an index trailer at open; names are read from the mapping
+  detail::PathIndex trailerIndex_;
+  std::span<const uint8_t> trailerRecords_; // Big-endian directory record offsets, empty if none
 
-  // Normalize slashes only (backslashes to forward slashes), preserving case
-  static std::string normalizeSlashes(const std::string &path);
+  // FileEntry objects, built once from entries_ (at open only with IndexMode::Standard)
+  mutable std::vector<FileEntry> files_;
 
-  // Normalize path to lowercase with forward slashes for lookup
-  static std::string normalizePath(const std::string &path);
+  // Directory tree over entries_, built on the first tree() call
+  mutable DirectoryTree tree_;
+  std::unique_ptr<LazyState> lazy_ = std::make_unique<LazyState>();
 
-  MappedFile mappedFile_;
-  std::vector<FileEntry> files_;
-  std::unordered_map<std::string, size_t> lookup_; // lowercase path -> index
+  // Instrumentation, allocated by open() only when stats are compiled in
+  std::unique_ptr<detail::ReaderCounters> stats_;
+  std::shared_ptr<AccessTrace> trace_; // Access recorder, null unless tracing
 };
 
 } // namespace bigx
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace bigx::refpack {
+
+// RefPack (EA "QFS"/0x10FB) compression, used for many payloads in Generals/Zero Hour archives
+//
+// Stream layout: 2-byte header (flags, 0xFB), optional compressed size, uncompressed size
+// (3 bytes, or 4 bytes when flag 0x80 is set), then a sequence of literal/match commands.
+
+// Check whether data starts with a RefPack header
+// A header declaring more output than the stream could expand to is rejected.
+bool isCompressed(std::span<const uint8_t> data) noexcept;
+
+// Check a header when only the first bytes of a streamSize-byte stream are at hand
+bool isCompressed(std::span<const uint8_t> head, size_t streamSize) noexcept;
+
+// Get the declared uncompressed size
+// Returns std::nullopt if data is not RefPack-compressed
+std::optional<size_t> uncompressedSize(std::span<const uint8_t> data) noexcept;
+
+// Get the declared uncompressed size from the first bytes of a streamSize-byte stream
+std::optional<size_t> uncompressedSize(std::span<const uint8_t> head, size_t streamSize) noexcept;
+
+// Decompress into out, which must hold at least uncompressedSize(data) bytes
+// Returns true on success, false on corrupt input (error in outError if provided)
+bool decompress(std::span<const uint8_t> data, std::span<uint8_t> out,
+                std::string *outError = nullptr);
+
+// Decompress into a new buffer sized from the header
+// Returns std::nullopt on failure, with error message in outError if provided
+std::optional<std::vector<uint8_t>> decompress(std::span<const uint8_t> data,
+                                               std::string *outError = nullptr);
+
+// Compress data into a RefPack stream
+// Returns an empty vector if data is too large for the format (over 4 GiB)
+std::vector<uint8_t> compress(std::span<const uint8_t> data);
+
+} // namespace bigx::refpack
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+// Instrumentation is compiled in only when the library is built with BIGX_ENABLE_STATS
+// (CMake option of the same name). Otherwise counters stay zero, phase callbacks are never
+// invoked, and the hooks in the hot paths compile to nothing.
+#ifndef BIGX_ENABLE_STATS
+#define BIGX_ENABLE_STATS 0
+#endif
+
+namespace bigx {
+
+// Whether this build of the library collects stats
+inline constexpr bool statsEnabled = BIGX_ENABLE_STATS != 0;
+
+// Timed phases of Reader::open() and Writer::write()
+enum class Phase {
+  Map,              // Map the archive (read) or create the output mapping (write)
+  ParseHeader,      // Validate the 16-byte header
+  ParseDirectory,   // Walk directory records and copy names into the arena
+  BuildIndex,       // Hash paths into the lookup table
+  LoadIndex,        // Validate and adopt a prebuilt index trailer
+  BuildFileEntries, // Build FileEntry objects from the directory
+  BuildTree,        // Build the directory tree (first Reader::tree() call)
+  SizeSources,      // Stat pending disk files
+  Compress,         // RefPack-compress pending payloads
+  Deduplicate,      // Hash and compare pending payloads to find identical ones
+  WriteDirectory,   // Write header and directory, lay out payloads
+  CopyPayloads,     // Copy payload bytes into the output
+  Flush,            // Flush the output mapping to disk
+};
+
+// Get a short, stable name for a phase ("parse-directory", ...)
+const char *phaseName(Phase phase) noexcept;
+
+// Receives each completed phase with its wall-clock duration
+// May be called from whichever thread runs the phase (e.g. a deferred IndexMode::Lazy parse)
+using PhaseCallback = std::function<void(Phase, std::chrono::nanoseconds)>;
+
+// Snapshot of a Reader's counters
+struct ReaderStats {
+  uint64_t openNanos = 0;      // Time spent in open(), including any eager indexing
+  uint64_t lookupHits = 0;     // findFile()/findEntry() calls that found the path
+  uint64_t lookupMisses = 0;   // ... and calls that did not
+  uint64_t filesExtracted = 0; // Successful extract()/extractAll()/extractToMemory() payloads
+  uint64_t bytesExtracted = 0; // Bytes produced by those payloads (after decompression)
+  uint64_t ioErrors = 0;       // Output files that could not be created or written
+};
+
+// Snapshot of a Writer's counters
+struct WriterStats {
+  uint64_t writeNanos = 0;   // Time spent in successful write() calls
+  uint64_t filesWritten = 0; // Entries in successfully written archives
+  uint64_t bytesWritten = 0; // Size of successfully written archives
+  uint64_t ioErrors = 0;     // Failed source reads, output mappings and flushes
+};
+
+namespace detail {
+
+// Live counters shared by concurrent readers of one archive (relaxed atomics)
+struct ReaderCounters {
+  std::atomic<uint64_t> openNanos{0};
+  std::atomic<uint64_t> lookupHits{0};
+  std::atomic<uint64_t> lookupMisses{0};
+  std::atomic<uint64_t> filesExtracted{0};
+  std::atomic<uint64_t> bytesExtracted{0};
+  std::atomic<uint64_t> ioErrors{0};
+  PhaseCallback onPhase; // Set at open, kept for deferred indexing
+
+  ReaderStats snapshot() const noexcept;
+};
+
+// Live counters of one Writer
+struct WriterCounters {
+  std::atomic<uint64_t> writeNanos{0};
+  std::atomic<uint64_t> filesWritten{0};
+  std::atomic<uint64_t> bytesWritten{0};
+  std::atomic<uint64_t> ioErrors{0};
+
+  WriterStats snapshot() const noexcept;
+};
+
+} // namespace detail
+
+} // namespace bigx
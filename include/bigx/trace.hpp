@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "path_index.hpp"
+#include "types.hpp"
+
+namespace bigx {
+
+class Reader;
+
+// Kind of archive access recorded in a trace
+enum class TraceOp : uint8_t {
+  Find,    // findFile()/findEntry() hit
+  View,    // getFileView()
+  Extract, // extract(), extractToMemory(), extractTo() or extractAsync()
+};
+
+// One recorded access
+struct TraceEvent {
+  uint64_t nanos = 0;  // Time since the recorder was created
+  uint32_t thread = 0; // Recorder-local thread number, in order of first access
+  TraceOp op = TraceOp::Find;
+  uint32_t path = 0; // Index into AccessLog::paths
+};
+
+// Recorded accesses, in the order they happened
+struct AccessLog {
+  std::vector<std::string> paths; // Distinct paths (as stored), in order of first access
+  std::vector<TraceEvent> events;
+};
+
+// Thread-safe recorder of archive accesses, attached to readers through OpenOptions::trace
+// Several readers may share one recorder; paths are interned case-insensitively so each distinct
+// file is stored once. Recording takes a lock, so tracing is meant for profiling runs rather
+// than shipping builds.
+class AccessTrace {
+public:
+  AccessTrace() = default;
+
+  // Record one access of path
+  void record(TraceOp op, std::string_view path);
+
+  // Copy of everything recorded so far
+  AccessLog snapshot() const;
+
+  // Forget the recorded accesses (the clock keeps running)
+  void clear();
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  mutable std::mutex mutex_;
+  Clock::time_point start_ = Clock::now();
+  AccessLog log_;
+  std::unordered_map<std::string, uint32_t, detail::PathHash, detail::PathEqual> pathIds_;
+  std::unordered_map<std::thread::id, uint32_t> threadIds_;
+};
+
+// Save a log in the compact binary trace format
+//   "BIGXTRC1", uint32 pathCount, uint64 eventCount
+//   pathCount x (uint32 length, bytes)
+//   eventCount x (uint64 nanos, uint32 thread, uint8 op, uint32 path)
+// All fields are big-endian.
+// Returns true on success, false on failure (error in outError if provided)
+bool saveAccessLog(const AccessLog &log, const std::filesystem::path &path,
+                   std::string *outError = nullptr);
+
+// Load a log written by saveAccessLog()
+// Returns std::nullopt on failure, with error message in outError if provided
+std::optional<AccessLog> loadAccessLog(const std::filesystem::path &path,
+                                       std::string *outError = nullptr);
+
+// Paths in order of first access, ready for WriteOptions::accessOrder with PayloadOrder::Profile
+std::vector<std::string> layoutProfile(const AccessLog &log);
+
+// Payload ranges of reader's files in order of first access, for Reader::prefetch() or
+// MappedFile::prefetch(); paths the archive does not contain and empty files are skipped, and
+// ranges past the end of the archive are clamped by the prefetch call
+std::vector<MappedRange> prefetchList(const AccessLog &log, const Reader &reader);
+
+} // namespace bigx
@@ -1,20 +1,123 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "stats.hpp"
 
 namespace bigx {
 
+class AccessTrace;
+
 // File entry in the BIG archive
 struct FileEntry {
   std::string path;          // Original case, normalized to forward slashes
   std::string lowercasePath; // For case-insensitive lookup
-  uint32_t offset = 0;       // Offset within archive (big-endian when stored)
-  uint32_t size = 0;         // File size in bytes (big-endian when stored)
+  uint64_t offset = 0;       // Offset within archive (big-endian when stored)
+  uint64_t size = 0;         // File size in bytes (big-endian when stored)
+};
+
+// On-disk archive variant
+enum class ArchiveFormat {
+  BigF,  // "BIGF" (Generals / Zero Hour): 32-bit archive size, offsets and sizes
+  Big4,  // "BIG4" (Battle for Middle-earth): BIGF layout under a different magic
+  Big64, // "BIGX" (bigx extension): 64-bit archive size, offsets and sizes for archives over 4 GiB
+};
+
+// Order in which Writer::write stores payloads (the directory always keeps insertion order)
+enum class PayloadOrder {
+  Insertion, // As the files were added
+  Path,      // Sorted case-insensitively by path, so each directory's payloads are contiguous
+  Size,      // Smallest first, packing small files together ahead of large ones
+  Profile,   // Paths in WriteOptions::accessOrder first, in that order, then the rest as added
+};
+
+// Options for writing an archive (Writer::write)
+// Writes stream payloads in constant memory, except with compress: every payload is compressed
+// before layout, and the compressed bytes stay in memory until copied into the archive, so peak
+// memory grows with the total compressed size.
+struct WriteOptions {
+  unsigned threads = 1;  // Worker threads for compression and copying (0 = hardware concurrency)
+  bool compress = false; // RefPack-compress payloads (kept raw when that would not shrink them)
+  PhaseCallback onPhase; // Phase timings (BIGX_ENABLE_STATS only)
+  ArchiveFormat format = ArchiveFormat::BigF; // Layout to write
+  bool promoteLarge = false; // Write Big64 instead of failing when a 32-bit format would overflow
+  size_t directorySlack = 0; // Zero bytes left after the directory so in-place updates can grow it
+  bool indexTrailer = false; // Append the prebuilt lookup table for Reader::open() to adopt
+  bool deduplicate = false;  // Store byte-identical payloads once, shared by all their entries
+  PayloadOrder payloadOrder = PayloadOrder::Insertion; // Payload placement for locality
+  std::vector<std::string> accessOrder; // Expected load order of paths (PayloadOrder::Profile)
+  size_t payloadAlignment = 0; // Start payloads on this power-of-two boundary (0 or 1 = packed),
+  size_t alignThreshold = 0;   // but only those of at least this many bytes
+  bool checksums = false; // Append a CRC-32C of every payload for Reader::verify() to check
+};
+
+// Options for applying staged changes to an archive in place (Updater::commit/compact)
+struct UpdateOptions {
+  size_t directorySlack = 0; // Free bytes to keep after the directory whenever it is moved or
+                             // rewritten from scratch
+  std::optional<ArchiveFormat> format; // compact() only: convert to this variant
+};
+
+// Allocation-free view of a directory entry
+// The path points into storage owned by the Reader and stays valid until it is closed.
+struct EntryView {
+  std::string_view path; // Original case, normalized to forward slashes
+  uint64_t offset = 0;   // Offset within archive
+  uint64_t size = 0;     // File size in bytes
+};
+
+// How Writer::addArchive() resolves an incoming path that is already pending
+enum class MergeConflict {
+  Fail,         // Stop with a duplicate path error
+  KeepExisting, // Skip the incoming entry
+  Replace,      // Replace the pending file with the incoming entry
+};
+
+// Options for merging an open archive into a Writer (Writer::addArchive)
+struct MergeOptions {
+  MergeConflict onConflict = MergeConflict::Fail;
+  std::string prefix; // Prepended to every incoming path
+  std::function<bool(const EntryView &)> filter; // Entries to take (all when empty)
+};
+
+// Directory index strategy used when opening an archive
+enum class IndexMode {
+  Standard, // Build FileEntry objects (path + lowercasePath strings) at open time
+  Flat,     // Keep names in one contiguous arena; FileEntry objects are built on first files()
+  Lazy,     // Validate the header only; the Flat index is built on first lookup or enumeration
+};
+
+// Expected access pattern for mapped archive data (kernel readahead hint)
+enum class AccessPattern {
+  Normal,     // Default readahead
+  Sequential, // Aggressive readahead, e.g. bulk extraction
+  Random,     // No readahead, e.g. scattered single-file reads
+};
+
+// Byte range within a mapped file
+struct MappedRange {
+  size_t offset = 0;
+  size_t length = 0;
 };
 
-// Archive header (16 bytes)
+// Options for opening an archive (Reader::open)
+struct OpenOptions {
+  IndexMode index = IndexMode::Standard;
+  AccessPattern access = AccessPattern::Normal; // Applied to the whole mapping after open
+  bool decompress = false;  // Decode RefPack payloads in extract()/extractToMemory()/extractAll()
+  PhaseCallback onPhase;    // Phase timings, incl. deferred indexing (BIGX_ENABLE_STATS only)
+  bool indexTrailer = true; // Adopt a valid index trailer instead of hashing the directory
+  std::shared_ptr<AccessTrace> trace; // Record lookups, views and extractions (see trace.hpp)
+};
+
+// Archive header (16 bytes, BigF/Big4 layout; Big64 stores fileCount at +4, archiveSize at +8)
 struct ArchiveHeader {
   char magic[4] = {'B', 'I', 'G', 'F'}; // File identifier
   uint32_t archiveSize = 0;             // Total archive size (big-endian, mostly unused)
@@ -24,6 +127,70 @@ struct ArchiveHeader {
   static constexpr size_t headerSize = 16;
 };
 
+// How bulk extraction writes files to disk
+enum class ExtractBackend {
+  Portable, // One std::ofstream per file
+  Batched,  // Batched native I/O (io_uring on Linux, overlapped I/O on Windows); falls back to
+            // Portable where unavailable
+};
+
+// Options for bulk extraction (Reader::extractAll)
+struct ExtractOptions {
+  unsigned threads = 0;                              // Worker threads (0 = hardware concurrency)
+  ExtractBackend backend = ExtractBackend::Portable; // How files are written
+};
+
+// Per-entry failure reported by bulk extraction
+struct ExtractFailure {
+  const FileEntry *entry = nullptr; // Entry that failed to extract
+  std::string error;                // Error message
+};
+
+// Result of bulk extraction
+struct ExtractResult {
+  size_t extracted = 0;                 // Number of files written successfully
+  size_t bytesWritten = 0;              // Total payload bytes written
+  std::vector<ExtractFailure> failures; // Failed entries, in archive order
+
+  bool ok() const { return failures.empty(); }
+};
+
+// Result of an asynchronous in-memory extraction (Reader::extractAsync)
+struct ExtractedFile {
+  const FileEntry *entry = nullptr;         // Entry that was requested
+  std::optional<std::vector<uint8_t>> data; // Payload (decoded if decompressing), or nullopt
+  std::string error;                        // Failure reason when data is empty
+
+  bool ok() const { return data.has_value(); }
+};
+
+// Completion callback for Reader::extractAsync, called on the executor thread
+using ExtractCallback = std::function<void(ExtractedFile)>;
+
+// Options for checking an archive's integrity (Reader::verify)
+struct VerifyOptions {
+  unsigned threads = 0;    // Worker threads for checksumming (0 = hardware concurrency)
+  size_t maxFailures = 16; // Corrupt entries to report in detail
+};
+
+// Corrupt entry reported by Reader::verify
+struct VerifyFailure {
+  const EntryView *entry = nullptr; // Entry that failed
+  std::string error;                // What is wrong with it
+};
+
+// Result of Reader::verify
+struct VerifyResult {
+  bool checksummed = false;            // Payloads were checked against a checksum trailer
+  size_t checked = 0;                  // Number of entries checked
+  size_t bytesChecked = 0;             // Payload bytes checksummed
+  size_t corrupt = 0;                  // Number of corrupt entries (may exceed failures.size())
+  std::vector<VerifyFailure> failures; // First VerifyOptions::maxFailures, in directory order
+  std::string error;                   // Directory-level failure, empty if the directory is sound
+
+  bool ok() const { return corrupt == 0 && error.empty(); }
+};
+
 // Exception for parsing errors
 class ParseError : public std::runtime_error {
 public:
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "path_index.hpp"
+#include "types.hpp"
+
+namespace bigx {
+
+// In-place editor for an existing archive
+// Additions, replacements and removals are staged in memory and applied by commit(), which
+// appends new payloads to the end of the file and then rewrites only the header and directory.
+// Replaced and removed payloads become dead space until compact() rewrites the archive. If the
+// grown directory no longer fits in front of the first payload, the payloads in its way are moved
+// to the end of the file. Not thread-safe; the file must not be open in a Reader meanwhile.
+class Updater {
+public:
+  Updater() = default;
+  ~Updater() = default;
+
+  // Delete copy, enable move
+  Updater(const Updater &) = delete;
+  Updater &operator=(const Updater &) = delete;
+  Updater(Updater &&) noexcept = default;
+  Updater &operator=(Updater &&) noexcept = default;
+
+  // Open an existing archive for update
+  // Returns std::nullopt on failure, with error message in outError if provided
+  static std::optional<Updater> open(const std::filesystem::path &path,
+                                     std::string *outError = nullptr);
+
+  // Stage a new file from disk (read during commit())
+  // Returns true on success, false if the path is already in use (error in outError if provided)
+  bool addFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
+               std::string *outError = nullptr);
+
+  // Stage a new file from memory (copied)
+  // Returns true on success, false if the path is already in use (error in outError if provided)
+  bool addFile(std::span<const uint8_t> data, const std::string &archivePath,
+               std::string *outError = nullptr);
+
+  // Stage a new file from caller-owned memory without copying (must outlive commit())
+  // Returns true on success, false if the path is already in use (error in outError if provided)
+  bool addFileView(std::span<const uint8_t> data, const std::string &archivePath,
+                   std::string *outError = nullptr);
+
+  // Stage new contents for an existing file from disk, keeping its directory position
+  // Returns true on success, false if there is no such file (error in outError if provided)
+  bool replaceFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
+                   std::string *outError = nullptr);
+
+  // Stage new contents for an existing file from memory (copied)
+  // Returns true on success, false if there is no such file (error in outError if provided)
+  bool replaceFile(std::span<const uint8_t> data, const std::string &archivePath,
+                   std::string *outError = nullptr);
+
+  // Stage removal of a file
+  // Returns true on success, false if there is no such file (error in outError if provided)
+  bool removeFile(const std::string &archivePath, std::string *outError = nullptr);
+
+  // Check whether a path exists, including staged changes (case-insensitive)
+  bool contains(std::string_view archivePath) const;
+
+  // Check whether any changes are staged
+  bool hasPendingChanges() const { return dirty_; }
+
+  // Drop all staged changes
+  void discard();
+
+  // Apply staged changes: append payloads, then rewrite header and directory
+  // Nothing is written if the result would not fit the archive's format
+  // Returns true on success, false on failure (error in outError if provided)
+  bool commit(std::string *outError = nullptr);
+
+  // Apply staged changes with explicit options (directory slack, ...)
+  bool commit(const UpdateOptions &options, std::string *outError = nullptr);
+
+  // Commit staged changes, then rewrite the archive without dead space
+  // The new archive is written next to the original and renamed over it. Checksum and index
+  // trailers present when the archive was opened are written again.
+  // Returns true on success, false on failure (error in outError if provided)
+  bool compact(const UpdateOptions &options = {}, std::string *outError = nullptr);
+
+  // Get the directory as of the last commit
+  const std::vector<FileEntry> &files() const { return entries_; }
+
+  // Get the number of files, including staged changes
+  size_t fileCount() const { return items_.size() - removedCount_; }
+
+  // Get the archive variant
+  ArchiveFormat format() const { return format_; }
+
+  // Get the archive size as of the last commit
+  uint64_t archiveSize() const { return archiveSize_; }
+
+  // Get the bytes not referenced by the committed directory (dead payloads and slack)
+  uint64_t deadBytes() const;
+
+  // Get the archive path
+  const std::filesystem::path &path() const { return path_; }
+
+private:
+  // Where a staged payload comes from
+  enum class Source {
+    Memory, // Owned copy in data
+    View,   // Borrowed caller memory in view
+    Disk,   // Streamed from sourcePath during commit()
+  };
+
+  struct Payload {
+    std::vector<uint8_t> data;        // File data if owned copy
+    std::span<const uint8_t> view;    // File data if borrowed
+    std::filesystem::path sourcePath; // Empty if from memory
+    Source source = Source::Memory;
+  };
+
+  // Directory entry with the payload it will receive on commit(), if any
+  struct Item {
+    FileEntry entry;                // Offset and size are final unless staged is set
+    std::optional<Payload> staged;  // New contents to append
+    bool removed = false;           // Dropped by removeFile(); erased once by commit()
+  };
+
+  // Load the directory of the archive at path_
+  bool load(std::string *outError);
+
+  // Stage payload under archivePath, as a new entry or replacing an existing one
+  bool stage(const std::string &archivePath, Payload payload, bool replace,
+             std::string *outError);
+
+  // Rebuild lookup_ after items_ changed shape
+  void reindex();
+
+  // Erase removed items and reindex, so removals cost one pass per commit rather than each
+  void compactItems();
+
+  // Size of the directory (header included) for the current items with the given field width
+  uint64_t directorySize(size_t fieldSize) const;
+
+  // Check whether two committed entries point at the same payload
+  bool hasSharedPayloads() const;
+
+  std::filesystem::path path_;
+  ArchiveFormat format_ = ArchiveFormat::BigF;
+  bool checksums_ = false;                         // Archive had a checksum trailer when loaded
+  bool indexTrailer_ = false;                      // Archive had an index trailer when loaded
+  uint64_t archiveSize_ = 0;                       // File size as of the last commit
+  std::vector<FileEntry> entries_;                 // Committed directory
+  std::vector<Item> items_;                        // Directory with staged changes applied
+  std::unordered_map<std::string, size_t, detail::PathHash, detail::PathEqual>
+      lookup_; // Lowercase path -> index in items_ (removed items are not listed)
+  size_t removedCount_ = 0; // Items marked removed since the last compaction
+  bool dirty_ = false;
+};
+
+} // namespace bigx
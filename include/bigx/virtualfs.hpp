@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "path_index.hpp"
+#include "types.hpp"
+
+namespace bigx {
+
+class Reader;
+
+// Identifier returned by VirtualFS::mount()
+using MountId = uint32_t;
+
+// File resolved through a VirtualFS: the winning archive and its entry
+struct ResolvedFile {
+  const Reader *reader = nullptr;   // Archive that provides the file
+  const FileEntry *entry = nullptr; // Entry within that archive
+  MountId mount = 0;                // Mount the file was resolved from
+};
+
+// Layered view over many archives, mirroring how the game loads its .big files
+// Archives mounted with a higher priority shadow lower ones; for equal priorities the most
+// recently mounted archive wins. All mounts share one merged lookup table, so resolving a path
+// is a single hash probe regardless of how many archives are mounted, and mount()/unmount()
+// only touch the entries of the archive being changed.
+//
+// Not thread-safe for concurrent mount()/unmount(); concurrent lookups are fine.
+class VirtualFS {
+public:
+  VirtualFS();
+  ~VirtualFS();
+
+  // Delete copy, enable move
+  VirtualFS(const VirtualFS &) = delete;
+  VirtualFS &operator=(const VirtualFS &) = delete;
+  VirtualFS(VirtualFS &&) noexcept;
+  VirtualFS &operator=(VirtualFS &&) noexcept;
+
+  // Mount an open reader (ownership is transferred)
+  MountId mount(Reader &&reader, int priority = 0);
+
+  // Open and mount an archive from disk
+  // Returns std::nullopt on failure, with error message in outError if provided
+  std::optional<MountId> mount(const std::filesystem::path &path, int priority = 0,
+                               std::string *outError = nullptr);
+
+  // Unmount an archive; files it shadowed become visible again
+  // Returns false if id is not mounted
+  bool unmount(MountId id);
+
+  // Unmount everything
+  void clear();
+
+  // Case-insensitive lookup of the winning entry for path
+  std::optional<ResolvedFile> findFile(std::string_view path) const;
+
+  // Get reader for a mount (nullptr if not mounted)
+  const Reader *reader(MountId id) const;
+
+  // Visit every visible file once (winning entry only), in unspecified order
+  void forEachFile(const std::function<void(const ResolvedFile &)> &visitor) const;
+
+  // Number of distinct visible paths
+  size_t fileCount() const { return lookup_.size(); }
+
+  // Number of mounted archives
+  size_t mountCount() const { return mounts_.size(); }
+
+private:
+  struct Mount {
+    std::unique_ptr<Reader> reader;
+    int priority = 0;
+    uint64_t sequence = 0; // Mount order, breaks priority ties
+  };
+
+  // One archive's claim on a path
+  struct Candidate {
+    int priority = 0;
+    uint64_t sequence = 0;
+    ResolvedFile file;
+  };
+
+  // Ordering used to keep the winner at the front of each candidate list
+  static bool outranks(const Candidate &a, const Candidate &b);
+
+  std::map<MountId, Mount> mounts_;
+  // Lowercase path -> claims
+  std::unordered_map<std::string, std::vector<Candidate>, detail::PathHash, detail::PathEqual>
+      lookup_;
+  MountId nextId_ = 1;
+  uint64_t nextSequence_ = 0;
+};
+
+} // namespace bigx
@@ -1,14 +1,25 @@
 #pragma once
 
 #include <filesystem>
+#include <memory>
 #include <span>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "types.hpp"
 
 namespace bigx {
 
+class MappedFile;
+class Reader;
+
+// Disk file to be added to an archive (Writer::addFiles)
+struct FileSource {
+  std::filesystem::path sourcePath; // File on disk
+  std::string archivePath;          // Path stored in the archive
+};
+
 class Writer {
 public:
   Writer() = default;
@@ -32,10 +43,52 @@ public:
   bool addFile(std::span<const uint8_t> data, const std::string &archivePath,
                std::string *outError = nullptr);
 
+  // Add file to archive from caller-owned memory without copying it
+  // The data must stay valid and unchanged until write() returns
+  // Returns true on success, false on failure (error in outError if provided)
+  bool addFileView(std::span<const uint8_t> data, const std::string &archivePath,
+                   std::string *outError = nullptr);
+
+  // Add an entry of an open archive, stored as archivePath
+  // The payload is copied as stored (compressed payloads stay compressed) straight from the
+  // reader's mapping into the output, so the reader must stay open until write() returns and the
+  // destination must not be the reader's own file (use Updater for in-place changes). Readers
+  // opened with openFromSource() have no view of their payloads and are rejected.
+  // Returns true on success, false on failure (error in outError if provided)
+  bool addFromReader(const Reader &reader, const FileEntry &entry, const std::string &archivePath,
+                     std::string *outError = nullptr);
+
+  // Add every entry of an open archive that passes options.filter, in directory order
+  // Incoming paths already pending are resolved by options.onConflict; a replaced file keeps its
+  // position. The same lifetime rules as addFromReader() apply. On failure, entries added before
+  // it remain pending.
+  // Returns true on success, false on failure (error in outError if provided)
+  bool addArchive(const Reader &reader, const MergeOptions &options = {},
+                  std::string *outError = nullptr);
+
+  // Add many files from disk, reserving capacity up front
+  // Stops at the first failure; files added before it remain pending
+  // Returns true on success, false on failure (error in outError if provided)
+  bool addFiles(std::span<const FileSource> files, std::string *outError = nullptr);
+
+  // Add every regular file below root, stored as archivePrefix + path relative to root
+  // Files are added in sorted path order so the result does not depend on directory iteration
+  // Returns true on success, false on failure (error in outError if provided)
+  bool addDirectory(const std::filesystem::path &root, const std::string &archivePrefix = "",
+                    std::string *outError = nullptr);
+
+  // Reserve capacity for count additional files
+  void reserve(size_t count);
+
   // Write archive to disk
   // Returns true on success, false on failure (error in outError if provided)
   bool write(const std::filesystem::path &destPath, std::string *outError = nullptr);
 
+  // Write archive to disk with explicit options (worker threads, ...)
+  // Returns true on success, false on failure (error in outError if provided)
+  bool write(const std::filesystem::path &destPath, const WriteOptions &options,
+             std::string *outError = nullptr);
+
   // Clear all files
   void clear();
 
@@ -45,22 +98,72 @@ public:
   // Get number of files to be written
   size_t fileCount() const { return pendingFiles_.size(); }
 
-private:
-  // Normalize slashes only (backslashes to forward slashes), preserving case
-  static std::string normalizeSlashes(const std::string &path);
+  // Get a snapshot of the instrumentation counters (all zero unless built with BIGX_ENABLE_STATS)
+  WriterStats stats() const { return stats_ ? stats_->snapshot() : WriterStats{}; }
 
-  // Normalize path to lowercase with forward slashes for lookup
-  static std::string normalizePath(const std::string &path);
+private:
+  // Where a pending file's payload comes from
+  enum class Source {
+    Memory, // Owned copy in data
+    View,   // Borrowed caller memory in view
+    Disk,   // Streamed from sourcePath during write()
+  };
 
   struct PendingFile {
     std::string archivePath;          // Normalized path (forward slashes)
     std::filesystem::path sourcePath; // Empty if from memory
-    std::vector<uint8_t> data;        // File data if from memory
-    bool fromDisk = false;            // True if file should be read from sourcePath
+    std::vector<uint8_t> data;        // File data if owned copy
+    std::span<const uint8_t> view;    // File data if borrowed
+    Source source = Source::Memory;
   };
 
+  // Record archivePath as used; fails on a case-insensitive duplicate
+  bool claimPath(const std::string &archivePath, std::string *outError);
+
+  // Add a disk source without checking that it exists
+  bool addDiskFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
+                   std::string *outError);
+
+  // Body of write(); the archive size is stored in outSize on success
+  bool writeArchive(const std::filesystem::path &destPath, const WriteOptions &options,
+                    size_t *outSize, std::string *outError);
+
+  // Pending file indices in the order their payloads are stored, given their final sizes
+  std::vector<size_t> payloadOrder(const WriteOptions &options,
+                                   std::span<const size_t> sizes) const;
+
+  // Copy one pending file's payload into its destination range
+  static bool copyPayload(const PendingFile &pending, std::span<uint8_t> dest,
+                          std::string *outError);
+
+  // RefPack-compress one pending file of the given raw size
+  // Leaves outCompressed empty when the payload should be stored raw
+  static bool compressPayload(const PendingFile &pending, size_t size,
+                              std::vector<uint8_t> &outCompressed, std::string *outError);
+
+  // Final bytes of pending file i: its compressed copy if it has one, otherwise its source
+  // Disk sources are mapped into mapping; returns an empty span if that fails
+  std::span<const uint8_t> payloadBytes(size_t i,
+                                        const std::vector<std::vector<uint8_t>> &compressed,
+                                        MappedFile &mapping) const;
+
+  // Find byte-identical payloads among pending files with the given final sizes
+  // outSharedWith[i] is the first pending file whose content equals file i's, or i itself
+  void findDuplicates(std::span<const size_t> sizes,
+                      const std::vector<std::vector<uint8_t>> &compressed, unsigned threads,
+                      std::vector<size_t> &outSharedWith) const;
+
+  // Copy a disk source straight into the output mapping in bounded chunks
+  static bool copyFromDisk(const std::filesystem::path &sourcePath, std::span<uint8_t> dest,
+                           std::string *outError);
+
   std::vector<PendingFile> pendingFiles_;
+  std::unordered_map<std::string, size_t> lowercasePaths_; // Claimed path -> pendingFiles_ index
   std::vector<FileEntry> entries_;
+
+  // Instrumentation, allocated only when stats are compiled in
+  std::unique_ptr<detail::WriterCounters> stats_ =
+      statsEnabled ? std::make_unique<detail::WriterCounters>() : nullptr;
 };
 
 } // namespace bigx
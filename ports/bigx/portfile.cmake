@@ -5,9 +5,15 @@ vcpkg_from_github(
     SHA512 0  # TODO: Update this hash when creating a release (run CI or download and hash the release tarball)
 )
 
+vcpkg_check_features(OUT_FEATURE_OPTIONS FEATURE_OPTIONS
+    FEATURES
+        tools BUILD_TOOLS
+)
+
 vcpkg_cmake_configure(
     SOURCE_PATH "${SOURCE_PATH}"
     OPTIONS
+        ${FEATURE_OPTIONS}
         -DINSTALL_STANDALONE=ON
         -DBUILD_TESTING=OFF
         -DBUILD_EXAMPLES=OFF
@@ -17,6 +23,10 @@ vcpkg_cmake_install()
 
 vcpkg_cmake_config_fixup(PACKAGE_NAME bigx CONFIG_PATH lib/cmake/bigx)
 
+if("tools" IN_LIST FEATURES)
+    vcpkg_copy_tools(TOOL_NAMES bigx AUTO_CLEAN)
+endif()
+
 file(REMOVE_RECURSE "${CURRENT_PACKAGES_DIR}/debug/include")
 
 vcpkg_install_copyright(FILE_LIST "${SOURCE_PATH}/LICENSE")
\ No newline at end of file
@@ -1,9 +1,34 @@
 #include <bigx/archive.hpp>
 #include <bigx/reader.hpp>
+#include <bigx/updater.hpp>
 #include <bigx/writer.hpp>
 
 namespace bigx {
 
+namespace {
+
+ExtractResult notReadingResult() {
+  ExtractResult result;
+  result.failures.push_back({nullptr, "Archive not open for reading"});
+  return result;
+}
+
+bool notUpdating(std::string *outError) {
+  if (outError) {
+    *outError = "Archive not open for update";
+  }
+  return false;
+}
+
+ExtractedFile notReadingFile(const FileEntry *entry) {
+  ExtractedFile result;
+  result.entry = entry;
+  result.error = "Archive not open for reading";
+  return result;
+}
+
+} // namespace
+
 // Special member functions defined here where Reader/Writer are complete types
 // This fixes the incomplete type issue when using std::unique_ptr with forward declarations
 Archive::Archive() = default;
@@ -12,7 +37,12 @@ Archive::Archive(Archive &&) noexcept = default;
 Archive &Archive::operator=(Archive &&) noexcept = default;
 
 std::optional<Archive> Archive::open(const std::filesystem::path &path, std::string *outError) {
-  auto reader = Reader::open(path, outError);
+  return open(path, OpenOptions{}, outError);
+}
+
+std::optional<Archive> Archive::open(const std::filesystem::path &path, const OpenOptions &options,
+                                     std::string *outError) {
+  auto reader = Reader::open(path, options, outError);
   if (!reader) {
     return std::nullopt;
   }
@@ -28,8 +58,23 @@ Archive Archive::create() {
   return archive;
 }
 
+std::optional<Archive> Archive::openForUpdate(const std::filesystem::path &path,
+                                              std::string *outError) {
+  auto updater = Updater::open(path, outError);
+  if (!updater) {
+    return std::nullopt;
+  }
+
+  Archive archive;
+  archive.updater_ = std::make_unique<Updater>(std::move(*updater));
+  return archive;
+}
+
 bool Archive::addFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
                       std::string *outError) {
+  if (updater_) {
+    return updater_->addFile(sourcePath, archivePath, outError);
+  }
   if (!writer_) {
     if (outError) {
       *outError = "Archive not open for writing";
@@ -41,6 +86,9 @@ bool Archive::addFile(const std::filesystem::path &sourcePath, const std::string
 
 bool Archive::addFile(std::span<const uint8_t> data, const std::string &archivePath,
                       std::string *outError) {
+  if (updater_) {
+    return updater_->addFile(data, archivePath, outError);
+  }
   if (!writer_) {
     if (outError) {
       *outError = "Archive not open for writing";
@@ -50,6 +98,68 @@ bool Archive::addFile(std::span<const uint8_t> data, const std::string &archiveP
   return writer_->addFile(data, archivePath, outError);
 }
 
+bool Archive::addDirectory(const std::filesystem::path &root, const std::string &archivePrefix,
+                           std::string *outError) {
+  if (!writer_) {
+    if (outError) {
+      *outError = "Archive not open for writing";
+    }
+    return false;
+  }
+  return writer_->addDirectory(root, archivePrefix, outError);
+}
+
+bool Archive::addFileView(std::span<const uint8_t> data, const std::string &archivePath,
+                          std::string *outError) {
+  if (updater_) {
+    return updater_->addFileView(data, archivePath, outError);
+  }
+  if (!writer_) {
+    if (outError) {
+      *outError = "Archive not open for writing";
+    }
+    return false;
+  }
+  return writer_->addFileView(data, archivePath, outError);
+}
+
+bool Archive::replaceFile(const std::filesystem::path &sourcePath,
+                          const std::string &archivePath, std::string *outError) {
+  if (!updater_) {
+    return notUpdating(outError);
+  }
+  return updater_->replaceFile(sourcePath, archivePath, outError);
+}
+
+bool Archive::replaceFile(std::span<const uint8_t> data, const std::string &archivePath,
+                          std::string *outError) {
+  if (!updater_) {
+    return notUpdating(outError);
+  }
+  return updater_->replaceFile(data, archivePath, outError);
+}
+
+bool Archive::removeFile(const std::string &archivePath, std::string *outError) {
+  if (!updater_) {
+    return notUpdating(outError);
+  }
+  return updater_->removeFile(archivePath, outError);
+}
+
+bool Archive::commit(const UpdateOptions &options, std::string *outError) {
+  if (!updater_) {
+    return notUpdating(outError);
+  }
+  return updater_->commit(options, outError);
+}
+
+bool Archive::compact(const UpdateOptions &options, std::string *outError) {
+  if (!updater_) {
+    return notUpdating(outError);
+  }
+  return updater_->compact(options, outError);
+}
+
 bool Archive::write(const std::filesystem::path &destPath, std::string *outError) {
   if (!writer_) {
     if (outError) {
@@ -60,6 +170,17 @@ bool Archive::write(const std::filesystem::path &destPath, std::string *outError
   return writer_->write(destPath, outError);
 }
 
+bool Archive::write(const std::filesystem::path &destPath, const WriteOptions &options,
+                    std::string *outError) {
+  if (!writer_) {
+    if (outError) {
+      *outError = "Archive not open for writing";
+    }
+    return false;
+  }
+  return writer_->write(destPath, options, outError);
+}
+
 const std::vector<FileEntry> &Archive::files() const {
   static const std::vector<FileEntry> empty;
   if (reader_) {
@@ -68,6 +189,9 @@ const std::vector<FileEntry> &Archive::files() const {
   if (writer_) {
     return writer_->files();
   }
+  if (updater_) {
+    return updater_->files();
+  }
   return empty;
 }
 
@@ -78,10 +202,13 @@ size_t Archive::fileCount() const {
   if (writer_) {
     return writer_->fileCount();
   }
+  if (updater_) {
+    return updater_->fileCount();
+  }
   return 0;
 }
 
-const FileEntry *Archive::findFile(const std::string &path) const {
+const FileEntry *Archive::findFile(std::string_view path) const {
   if (!reader_) {
     return nullptr;
   }
@@ -99,6 +226,32 @@ bool Archive::extract(const FileEntry &entry, const std::filesystem::path &destP
   return reader_->extract(entry, destPath, outError);
 }
 
+ExtractResult Archive::extractAll(const std::filesystem::path &destDir,
+                                  const ExtractOptions &options) const {
+  if (!reader_) {
+    return notReadingResult();
+  }
+  return reader_->extractAll(destDir, options);
+}
+
+ExtractResult Archive::extractAll(const std::filesystem::path &destDir,
+                                  std::span<const FileEntry *const> entries,
+                                  const ExtractOptions &options) const {
+  if (!reader_) {
+    return notReadingResult();
+  }
+  return reader_->extractAll(destDir, entries, options);
+}
+
+ExtractResult Archive::extractAll(const std::filesystem::path &destDir,
+                                  const std::function<bool(const FileEntry &)> &predicate,
+                                  const ExtractOptions &options) const {
+  if (!reader_) {
+    return notReadingResult();
+  }
+  return reader_->extractAll(destDir, predicate, options);
+}
+
 std::optional<std::vector<uint8_t>> Archive::extractToMemory(const FileEntry &entry,
                                                              std::string *outError) const {
   if (!reader_) {
@@ -110,6 +263,70 @@ std::optional<std::vector<uint8_t>> Archive::extractToMemory(const FileEntry &en
   return reader_->extractToMemory(entry, outError);
 }
 
+std::optional<std::pmr::vector<uint8_t>>
+Archive::extractToMemory(const FileEntry &entry, std::pmr::memory_resource &resource,
+                         std::string *outError) const {
+  if (!reader_) {
+    if (outError) {
+      *outError = "Archive not open for reading";
+    }
+    return std::nullopt;
+  }
+  return reader_->extractToMemory(entry, resource, outError);
+}
+
+std::optional<size_t> Archive::extractTo(const FileEntry &entry, std::span<uint8_t> out,
+                                         std::string *outError) const {
+  if (!reader_) {
+    if (outError) {
+      *outError = "Archive not open for reading";
+    }
+    return std::nullopt;
+  }
+  return reader_->extractTo(entry, out, outError);
+}
+
+size_t Archive::extractedSize(const FileEntry &entry) const {
+  return reader_ ? reader_->extractedSize(entry) : 0;
+}
+
+ArchiveFormat Archive::format() const {
+  if (reader_) {
+    return reader_->format();
+  }
+  return updater_ ? updater_->format() : ArchiveFormat::BigF;
+}
+
+std::future<ExtractedFile> Archive::extractAsync(const FileEntry &entry,
+                                                 Executor *executor) const {
+  if (!reader_) {
+    std::promise<ExtractedFile> promise;
+    promise.set_value(notReadingFile(&entry));
+    return promise.get_future();
+  }
+  return reader_->extractAsync(entry, executor);
+}
+
+void Archive::extractAsync(const FileEntry &entry, ExtractCallback onComplete,
+                           Executor *executor) const {
+  if (!reader_) {
+    onComplete(notReadingFile(&entry));
+    return;
+  }
+  reader_->extractAsync(entry, std::move(onComplete), executor);
+}
+
+void Archive::extractAsync(std::span<const FileEntry *const> entries, ExtractCallback onComplete,
+                           Executor *executor) const {
+  if (!reader_) {
+    for (const FileEntry *entry : entries) {
+      onComplete(notReadingFile(entry));
+    }
+    return;
+  }
+  reader_->extractAsync(entries, std::move(onComplete), executor);
+}
+
 std::span<const uint8_t> Archive::getFileView(const FileEntry &entry) const {
   if (!reader_) {
     return {};
@@ -120,6 +337,7 @@ std::span<const uint8_t> Archive::getFileView(const FileEntry &entry) const {
 void Archive::close() {
   reader_.reset();
   writer_.reset();
+  updater_.reset();
 }
 
 void Archive::clear() {
@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <initializer_list>
+#include <vector>
+
+#include "batch_io.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define BIGX_HAVE_IO_URING 1
+#include <cerrno>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX // Keep std::min/std::max usable
+#endif
+#include <windows.h>
+#endif
+
+namespace bigx::detail {
+
+namespace {
+
+// Largest single write request; longer payloads are written in several rounds
+constexpr size_t maxWriteChunk = size_t{1} << 30;
+
+std::string createError(const FileWriteJob &job) {
+  return std::format("Failed to create output file: {}", job.path->string());
+}
+
+std::string writeError(const FileWriteJob &job) {
+  return std::format("Failed to write to output file: {}", job.path->string());
+}
+
+} // namespace
+
+#ifdef BIGX_HAVE_IO_URING
+
+// Minimal io_uring driver over the raw syscalls (no liburing dependency)
+// Every phase fills the submission queue once, then submits and waits in a single
+// io_uring_enter(), so a batch of N files costs a handful of syscalls instead of ~3N.
+struct BatchFileWriter::Impl {
+  static constexpr unsigned queueDepth = 256;
+
+  int ringFd = -1;
+  void *sqRing = nullptr;
+  size_t sqRingSize = 0;
+  void *cqRing = nullptr; // Same as sqRing with IORING_FEAT_SINGLE_MMAP
+  size_t cqRingSize = 0;
+  io_uring_sqe *sqes = nullptr;
+  size_t sqesSize = 0;
+
+  unsigned *sqTail = nullptr;
+  unsigned *sqMask = nullptr;
+  unsigned *sqArray = nullptr;
+  unsigned sqEntries = 0;
+  unsigned *cqHead = nullptr;
+  unsigned *cqTail = nullptr;
+  unsigned *cqMask = nullptr;
+  io_uring_cqe *cqes = nullptr;
+
+  unsigned queued = 0; // SQEs filled since the last submit
+  bool broken = false; // Set after a failed io_uring_enter()
+
+  ~Impl() {
+    if (sqes) {
+      munmap(sqes, sqesSize);
+    }
+    if (cqRing && cqRing != sqRing) {
+      munmap(cqRing, cqRingSize);
+    }
+    if (sqRing) {
+      munmap(sqRing, sqRingSize);
+    }
+    if (ringFd >= 0) {
+      ::close(ringFd);
+    }
+  }
+
+  bool setup() {
+    io_uring_params params{};
+    ringFd = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+    if (ringFd < 0) {
+      return false;
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMap) {
+      sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    }
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd,
+                  IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+      sqRing = nullptr;
+      return false;
+    }
+    if (singleMap) {
+      cqRing = sqRing;
+    } else {
+      cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    ringFd, IORING_OFF_CQ_RING);
+      if (cqRing == MAP_FAILED) {
+        cqRing = nullptr;
+        return false;
+      }
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqeMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ringFd, IORING_OFF_SQES);
+    if (sqeMap == MAP_FAILED) {
+      return false;
+    }
+    sqes = static_cast<io_uring_sqe *>(sqeMap);
+
+    auto *sq = static_cast<uint8_t *>(sqRing);
+    auto *cq = static_cast<uint8_t *>(cqRing);
+    sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sqEntries = params.sq_entries;
+    cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    return supports({IORING_OP_OPENAT, IORING_OP_WRITE, IORING_OP_CLOSE});
+  }
+
+  // Check that the kernel implements every opcode (IORING_REGISTER_PROBE, Linux 5.6+)
+  bool supports(std::initializer_list<unsigned> opcodes) const {
+    constexpr unsigned probeOps = 256;
+    std::vector<uint8_t> buffer(sizeof(io_uring_probe) + probeOps * sizeof(io_uring_probe_op));
+    auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, probeOps) < 0) {
+      return false;
+    }
+    return std::all_of(opcodes.begin(), opcodes.end(), [&](unsigned op) {
+      return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    });
+  }
+
+  // Get the next free SQE (at most sqEntries may be queued between submits)
+  io_uring_sqe *next(uint64_t userData) {
+    unsigned tail = *sqTail + queued;
+    unsigned index = tail & *sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->user_data = userData;
+    sqArray[index] = index;
+    ++queued;
+    return sqe;
+  }
+
+  // Submit every queued SQE and wait for all of their completions
+  // onComplete(userData, result) is called once per completion
+  template <typename Fn>
+  bool submitAndWait(Fn &&onComplete) {
+    unsigned count = queued;
+    queued = 0;
+    std::atomic_ref<unsigned>(*sqTail).store(*sqTail + count, std::memory_order_release);
+
+    unsigned pending = count; // Not yet accepted by the kernel
+    unsigned reaped = 0;
+    while (reaped < count) {
+      long ret = syscall(__NR_io_uring_enter, ringFd, pending, count - reaped,
+                         IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return false;
+      }
+      pending -= static_cast<unsigned>(ret);
+
+      unsigned head = *cqHead;
+      unsigned tail = std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire);
+      if (head == tail && pending > 0 && ret == 0) {
+        return false; // Kernel refused the remaining submissions
+      }
+      for (; head != tail; ++head, ++reaped) {
+        const io_uring_cqe &cqe = cqes[head & *cqMask];
+        onComplete(cqe.user_data, cqe.res);
+      }
+      std::atomic_ref<unsigned>(*cqHead).store(head, std::memory_order_release);
+    }
+    return true;
+  }
+
+  void writeBatch(std::span<const FileWriteJob> jobs, std::span<std::string> errors) {
+    std::vector<int> fds(jobs.size(), -1);
+    std::vector<size_t> written(jobs.size(), 0);
+    // A failed io_uring_enter() leaves the rings in an unknown state, so the writer gives up
+    // on the rest of the batch and on later batches rather than misattributing completions
+    auto abandon = [&]() {
+      broken = true;
+      for (size_t i = 0; i < jobs.size(); ++i) {
+        if (fds[i] >= 0) {
+          ::close(fds[i]);
+        }
+        if (errors[i].empty()) {
+          errors[i] = std::format("Batched I/O failed for: {}", jobs[i].path->string());
+        }
+      }
+    };
+    if (broken) {
+      abandon();
+      return;
+    }
+
+    // Phase 1: open every file
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      io_uring_sqe *sqe = next(i);
+      sqe->opcode = IORING_OP_OPENAT;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = reinterpret_cast<uintptr_t>(jobs[i].path->c_str());
+      sqe->len = 0644;
+      sqe->open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    }
+    bool ok = submitAndWait([&](uint64_t i, int res) {
+      if (res >= 0) {
+        fds[i] = res;
+      } else {
+        errors[i] = createError(jobs[i]);
+      }
+    });
+    if (!ok) {
+      abandon();
+      return;
+    }
+
+    // Phase 2: write payloads; short writes are continued in further rounds
+    for (;;) {
+      for (size_t i = 0; i < jobs.size(); ++i) {
+        if (fds[i] < 0 || !errors[i].empty() || written[i] == jobs[i].data.size()) {
+          continue;
+        }
+        size_t chunk = std::min(maxWriteChunk, jobs[i].data.size() - written[i]);
+        io_uring_sqe *sqe = next(i);
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = fds[i];
+        sqe->addr = reinterpret_cast<uintptr_t>(jobs[i].data.data() + written[i]);
+        sqe->len = static_cast<uint32_t>(chunk);
+        sqe->off = written[i];
+      }
+      if (queued == 0) {
+        break;
+      }
+      ok = submitAndWait([&](uint64_t i, int res) {
+        if (res > 0) {
+          written[i] += static_cast<size_t>(res);
+        } else {
+          errors[i] = writeError(jobs[i]);
+        }
+      });
+      if (!ok) {
+        abandon();
+        return;
+      }
+    }
+
+    // Phase 3: close everything that was opened, including files whose write failed
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      if (fds[i] >= 0) {
+        io_uring_sqe *sqe = next(i);
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->fd = fds[i];
+      }
+    }
+    ok = submitAndWait([&](uint64_t i, int res) {
+      if (res < 0 && errors[i].empty()) {
+        errors[i] = writeError(jobs[i]);
+      }
+      fds[i] = -1;
+    });
+    if (!ok) {
+      abandon();
+    }
+  }
+};
+
+std::unique_ptr<BatchFileWriter> BatchFileWriter::create() {
+  auto impl = std::make_unique<Impl>();
+  if (!impl->setup()) {
+    return nullptr;
+  }
+  return std::unique_ptr<BatchFileWriter>(new BatchFileWriter(std::move(impl)));
+}
+
+size_t BatchFileWriter::batchSize() const {
+  return impl_->sqEntries;
+}
+
+void BatchFileWriter::writeAll(std::span<const FileWriteJob> jobs, std::span<std::string> errors) {
+  for (size_t start = 0; start < jobs.size(); start += batchSize()) {
+    size_t count = std::min(batchSize(), jobs.size() - start);
+    impl_->writeBatch(jobs.subspan(start, count), errors.subspan(start, count));
+  }
+}
+
+#elif defined(_WIN32)
+
+// Overlapped writes: every file of a batch has one write in flight at a time, and all of them
+// are issued before the first wait
+struct BatchFileWriter::Impl {
+  static constexpr size_t batchSize = 256;
+
+  void writeBatch(std::span<const FileWriteJob> jobs, std::span<std::string> errors) {
+    std::vector<HANDLE> handles(jobs.size(), INVALID_HANDLE_VALUE);
+    std::vector<OVERLAPPED> overlapped(jobs.size());
+    std::vector<size_t> written(jobs.size(), 0);
+    std::vector<bool> inFlight(jobs.size(), false);
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      handles[i] = CreateFileW(jobs[i].path->c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                               FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+      if (handles[i] == INVALID_HANDLE_VALUE) {
+        errors[i] = createError(jobs[i]);
+      }
+    }
+
+    for (bool issued = true; issued;) {
+      issued = false;
+      for (size_t i = 0; i < jobs.size(); ++i) {
+        inFlight[i] = false;
+        if (handles[i] == INVALID_HANDLE_VALUE || !errors[i].empty() ||
+            written[i] == jobs[i].data.size()) {
+          continue;
+        }
+        size_t remaining = jobs[i].data.size() - written[i];
+        auto chunk = static_cast<DWORD>(std::min(maxWriteChunk, remaining));
+        overlapped[i] = OVERLAPPED{};
+        overlapped[i].Offset = static_cast<DWORD>(written[i]);
+        overlapped[i].OffsetHigh = static_cast<DWORD>(static_cast<uint64_t>(written[i]) >> 32);
+        if (!WriteFile(handles[i], jobs[i].data.data() + written[i], chunk, nullptr,
+                       &overlapped[i]) &&
+            GetLastError() != ERROR_IO_PENDING) {
+          errors[i] = writeError(jobs[i]);
+          continue;
+        }
+        inFlight[i] = true;
+        issued = true;
+      }
+      for (size_t i = 0; i < jobs.size(); ++i) {
+        if (!inFlight[i]) {
+          continue;
+        }
+        DWORD done = 0;
+        if (!GetOverlappedResult(handles[i], &overlapped[i], &done, TRUE) || done == 0) {
+          errors[i] = writeError(jobs[i]);
+        } else {
+          written[i] += done;
+        }
+      }
+    }
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+      if (handles[i] != INVALID_HANDLE_VALUE) {
+        CloseHandle(handles[i]);
+      }
+    }
+  }
+};
+
+std::unique_ptr<BatchFileWriter> BatchFileWriter::create() {
+  return std::unique_ptr<BatchFileWriter>(new BatchFileWriter(std::make_unique<Impl>()));
+}
+
+size_t BatchFileWriter::batchSize() const {
+  return Impl::batchSize;
+}
+
+void BatchFileWriter::writeAll(std::span<const FileWriteJob> jobs, std::span<std::string> errors) {
+  for (size_t start = 0; start < jobs.size(); start += batchSize()) {
+    size_t count = std::min(batchSize(), jobs.size() - start);
+    impl_->writeBatch(jobs.subspan(start, count), errors.subspan(start, count));
+  }
+}
+
+#else
+
+// No batched interface on this platform; callers use the portable path
+struct BatchFileWriter::Impl {};
+
+std::unique_ptr<BatchFileWriter> BatchFileWriter::create() {
+  return nullptr;
+}
+
+size_t BatchFileWriter::batchSize() const {
+  return 0;
+}
+
+void BatchFileWriter::writeAll(std::span<const FileWriteJob>, std::span<std::string>) {}
+
+#endif
+
+BatchFileWriter::BatchFileWriter(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
+
+BatchFileWriter::~BatchFileWriter() = default;
+
+bool batchFileWriterAvailable() {
+  static const bool available = BatchFileWriter::create() != nullptr;
+  return available;
+}
+
+} // namespace bigx::detail
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+
+namespace bigx::detail {
+
+// One whole file to create (or truncate) and fill
+struct FileWriteJob {
+  const std::filesystem::path *path = nullptr;
+  std::span<const uint8_t> data;
+};
+
+// Writes many files through the platform's batched I/O interface
+// Linux: io_uring, with one submission per phase (open, write, close) for a whole batch.
+// Windows: overlapped writes, all in flight at once, noticed with one wait per file.
+// Not thread-safe; use one writer per thread.
+class BatchFileWriter {
+public:
+  // Create a writer, or nullptr if the interface is unavailable (old kernel, seccomp, ...)
+  static std::unique_ptr<BatchFileWriter> create();
+
+  ~BatchFileWriter();
+
+  BatchFileWriter(const BatchFileWriter &) = delete;
+  BatchFileWriter &operator=(const BatchFileWriter &) = delete;
+
+  // Largest number of jobs submitted together; writeAll() splits longer spans
+  size_t batchSize() const;
+
+  // Write every job; errors[i] receives the failure for jobs[i] and is left empty on success
+  void writeAll(std::span<const FileWriteJob> jobs, std::span<std::string> errors);
+
+private:
+  struct Impl;
+
+  explicit BatchFileWriter(std::unique_ptr<Impl> impl);
+
+  std::unique_ptr<Impl> impl_;
+};
+
+// Check (once per process) whether BatchFileWriter::create() can succeed
+bool batchFileWriterAvailable();
+
+} // namespace bigx::detail
@@ -0,0 +1,109 @@
+#include <functional>
+
+#include <bigx/cache.hpp>
+#include <bigx/reader.hpp>
+
+namespace bigx {
+
+size_t ExtractCache::KeyHash::operator()(const Key &key) const noexcept {
+  auto combine = [](size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+  };
+  size_t hash = std::hash<const void *>{}(key.reader);
+  hash = combine(hash, std::hash<uint64_t>{}(key.offset));
+  return combine(hash, std::hash<uint64_t>{}(key.size));
+}
+
+ExtractCache::ExtractCache(size_t byteBudget) : budget_(byteBudget) {}
+
+SharedBuffer ExtractCache::get(const Reader &reader, const FileEntry &entry,
+                               std::string *outError) {
+  Key key{&reader, entry.offset, entry.size};
+
+  {
+    std::lock_guard lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      ++stats_.hits;
+      return it->second->buffer;
+    }
+    ++stats_.misses;
+  }
+
+  // Extract without holding the lock
+  auto data = reader.extractToMemory(entry, outError);
+  if (!data) {
+    return nullptr;
+  }
+  auto buffer = std::make_shared<const std::vector<uint8_t>>(std::move(*data));
+
+  std::lock_guard lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // Another thread loaded it meanwhile; share its copy
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->buffer;
+  }
+  if (buffer->size() > budget_) {
+    return buffer;
+  }
+
+  lru_.push_front(Node{key, buffer});
+  index_.emplace(key, lru_.begin());
+  stats_.bytes += buffer->size();
+  ++stats_.entries;
+  trim();
+  return buffer;
+}
+
+void ExtractCache::evict(const Reader &reader) {
+  std::lock_guard lock(mutex_);
+  for (auto it = lru_.begin(); it != lru_.end();) {
+    if (it->key.reader == &reader) {
+      stats_.bytes -= it->buffer->size();
+      --stats_.entries;
+      index_.erase(it->key);
+      it = lru_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ExtractCache::clear() {
+  std::lock_guard lock(mutex_);
+  lru_.clear();
+  index_.clear();
+  stats_.bytes = 0;
+  stats_.entries = 0;
+}
+
+void ExtractCache::setBudget(size_t byteBudget) {
+  std::lock_guard lock(mutex_);
+  budget_ = byteBudget;
+  trim();
+}
+
+size_t ExtractCache::budget() const {
+  std::lock_guard lock(mutex_);
+  return budget_;
+}
+
+CacheStats ExtractCache::stats() const {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+void ExtractCache::trim() {
+  while (stats_.bytes > budget_ && !lru_.empty()) {
+    const Node &victim = lru_.back();
+    stats_.bytes -= victim.buffer->size();
+    --stats_.entries;
+    ++stats_.evictions;
+    index_.erase(victim.key);
+    lru_.pop_back();
+  }
+}
+
+} // namespace bigx
@@ -0,0 +1,51 @@
+#include <cstring>
+
+#include "checksum_trailer.hpp"
+#include "crc32c.hpp"
+#include "index_trailer.hpp"
+
+namespace bigx::detail {
+
+namespace {
+
+constexpr char footerMagic[8] = {'B', 'I', 'G', 'X', 'C', 'R', 'C', '1'};
+
+} // namespace
+
+void storeChecksumTrailer(std::span<const uint8_t> directory, std::span<const uint32_t> checksums,
+                          std::span<uint8_t> out) {
+  uint8_t *pos = out.data();
+  for (uint32_t checksum : checksums) {
+    storeField(pos, 4, checksum);
+    pos += 4;
+  }
+
+  std::memcpy(pos, footerMagic, sizeof(footerMagic));
+  storeField(pos + 8, 4, checksums.size());
+  storeField(pos + 12, 4, crc32c(crc32c(0, directory), out.first(4 * checksums.size())));
+  storeField(pos + 16, 8, directory.size());
+}
+
+std::span<const uint8_t> loadChecksumTrailer(std::span<const uint8_t> data, uint32_t entryCount,
+                                             size_t directoryEnd) {
+  // An index trailer, if any, comes last
+  data = data.first(data.size() - indexTrailerExtent(data));
+  size_t trailerSize = checksumTrailerSize(entryCount);
+  if (directoryEnd > data.size() || trailerSize > data.size() - directoryEnd) {
+    return {};
+  }
+
+  const uint8_t *footer = data.data() + data.size() - checksumFooterSize;
+  if (std::memcmp(footer, footerMagic, sizeof(footerMagic)) != 0 ||
+      loadField(footer + 8, 4) != entryCount || loadField(footer + 16, 8) != directoryEnd) {
+    return {};
+  }
+
+  auto table = data.subspan(data.size() - trailerSize, 4 * static_cast<size_t>(entryCount));
+  if (loadField(footer + 12, 4) != crc32c(crc32c(0, data.first(directoryEnd)), table)) {
+    return {};
+  }
+  return table;
+}
+
+} // namespace bigx::detail
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "format.hpp"
+
+// Private layout of the per-entry checksums that Writer appends with WriteOptions::checksums
+//   table    entryCount x uint32 CRC-32C of the entry's stored payload bytes
+//   footer   "BIGXCRC1", uint32 entryCount, uint32 CRC-32C of directory and table,
+//            uint64 directoryEnd
+// All fields are big-endian. The trailer follows the payloads and ends the file, unless an index
+// trailer follows it. Like the index trailer it is counted in the archive size but referenced by
+// no entry, and a rewritten directory no longer matches the footer checksum, so a stale table is
+// ignored rather than reported as corruption.
+namespace bigx::detail {
+
+inline constexpr size_t checksumFooterSize = 24;
+
+// Trailer size for a directory of entryCount entries
+inline size_t checksumTrailerSize(size_t entryCount) noexcept {
+  return 4 * entryCount + checksumFooterSize;
+}
+
+// Write the trailer for the finished header and directory in directory into out
+// checksums holds each entry's payload CRC; out must be checksumTrailerSize() bytes
+void storeChecksumTrailer(std::span<const uint8_t> directory, std::span<const uint32_t> checksums,
+                          std::span<uint8_t> out);
+
+// Find and validate the trailer of an archive whose directory of entryCount entries ends at
+// directoryEnd; returns the table (entryCount big-endian uint32 values), or an empty span
+std::span<const uint8_t> loadChecksumTrailer(std::span<const uint8_t> data, uint32_t entryCount,
+                                             size_t directoryEnd);
+
+// Read checksum i from the span returned by loadChecksumTrailer()
+inline uint32_t trailerChecksum(std::span<const uint8_t> table, size_t i) noexcept {
+  return static_cast<uint32_t>(loadField(table.data() + 4 * i, 4));
+}
+
+} // namespace bigx::detail
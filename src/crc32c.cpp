@@ -0,0 +1,86 @@
+#include <array>
+#include <cstring>
+
+#include "crc32c.hpp"
+
+#if defined(__SSE4_2__) && (defined(__x86_64__) || defined(_M_X64))
+#define BIGX_CRC_SSE42 1
+#include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32) && defined(__aarch64__)
+#define BIGX_CRC_ARM 1
+#include <arm_acle.h>
+#endif
+
+namespace bigx::detail {
+
+namespace {
+
+#if !BIGX_CRC_SSE42 && !BIGX_CRC_ARM
+constexpr uint32_t polynomial = 0x82f63b78; // Reflected Castagnoli polynomial
+
+// tables[k][b]: CRC of byte b followed by k zero bytes
+constexpr std::array<std::array<uint32_t, 256>, 8> makeTables() {
+  std::array<std::array<uint32_t, 256>, 8> tables{};
+  for (uint32_t b = 0; b < 256; ++b) {
+    uint32_t crc = b;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (polynomial & (0u - (crc & 1)));
+    }
+    tables[0][b] = crc;
+  }
+  for (uint32_t b = 0; b < 256; ++b) {
+    for (size_t k = 1; k < 8; ++k) {
+      tables[k][b] = (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xff];
+    }
+  }
+  return tables;
+}
+
+constexpr auto tables = makeTables();
+#endif
+
+} // namespace
+
+uint32_t crc32c(uint32_t crc, std::span<const uint8_t> bytes) noexcept {
+  const uint8_t *data = bytes.data();
+  size_t size = bytes.size();
+  crc = ~crc;
+
+#if BIGX_CRC_SSE42
+  uint64_t wide = crc;
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64_t word;
+    std::memcpy(&word, data, 8);
+    wide = _mm_crc32_u64(wide, word);
+  }
+  crc = static_cast<uint32_t>(wide);
+  for (; size > 0; ++data, --size) {
+    crc = _mm_crc32_u8(crc, *data);
+  }
+#elif BIGX_CRC_ARM
+  for (; size >= 8; data += 8, size -= 8) {
+    uint64_t word;
+    std::memcpy(&word, data, 8);
+    crc = __crc32cd(crc, word);
+  }
+  for (; size > 0; ++data, --size) {
+    crc = __crc32cb(crc, *data);
+  }
+#else
+  // Slicing-by-8: fold eight bytes per step through eight tables (byte order independent)
+  for (; size >= 8; data += 8, size -= 8) {
+    uint32_t low = crc ^ (uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 |
+                          uint32_t(data[3]) << 24);
+    crc = tables[7][low & 0xff] ^ tables[6][(low >> 8) & 0xff] ^ tables[5][(low >> 16) & 0xff] ^
+          tables[4][low >> 24] ^ tables[3][data[4]] ^ tables[2][data[5]] ^ tables[1][data[6]] ^
+          tables[0][data[7]];
+  }
+  for (; size > 0; ++data, --size) {
+    crc = (crc >> 8) ^ tables[0][(crc ^ *data) & 0xff];
+  }
+#endif
+
+  return ~crc;
+}
+
+} // namespace bigx::detail
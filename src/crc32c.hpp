@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+// Private CRC-32C (Castagnoli) used for per-entry payload checksums
+// Uses the SSE4.2 crc32 instruction when the library is compiled for it, the ARMv8 CRC extension
+// on AArch64 builds that enable it and slicing-by-8 tables elsewhere; every variant produces
+// identical output.
+namespace bigx::detail {
+
+// Continue a CRC-32C over bytes; start with crc = 0
+uint32_t crc32c(uint32_t crc, std::span<const uint8_t> bytes) noexcept;
+
+} // namespace bigx::detail
@@ -0,0 +1,316 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <bigx/directory_tree.hpp>
+#include <bigx/path_index.hpp>
+
+#include "path_fold.hpp"
+
+namespace bigx {
+
+namespace {
+
+// Case-insensitive glob match of one segment: '*' matches any run, '?' any single character
+bool matchSegment(std::string_view pattern, std::string_view name) noexcept {
+  size_t p = 0;
+  size_t n = 0;
+  size_t starP = std::string_view::npos; // Position after the last '*' seen
+  size_t starN = 0;                      // Name position that '*' was last tried against
+  while (n < name.size()) {
+    if (p < pattern.size() && pattern[p] == '*') {
+      starP = ++p;
+      starN = n;
+    } else if (p < pattern.size() && (pattern[p] == '?' || detail::foldedChar(pattern[p]) ==
+                                                               detail::foldedChar(name[n]))) {
+      ++p;
+      ++n;
+    } else if (starP != std::string_view::npos) {
+      p = starP; // Let the last '*' swallow one more character
+      n = ++starN;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+bool hasWildcard(std::string_view segment) noexcept {
+  return segment.find_first_of("*?") != std::string_view::npos;
+}
+
+// Split a user-supplied path on either slash, dropping empty segments
+std::vector<std::string_view> splitSegments(std::string_view path) {
+  std::vector<std::string_view> segments;
+  size_t pos = 0;
+  while (pos <= path.size()) {
+    size_t end = path.find_first_of("/\\", pos);
+    if (end == std::string_view::npos) {
+      end = path.size();
+    }
+    if (end > pos) {
+      segments.push_back(path.substr(pos, end - pos));
+    }
+    pos = end + 1;
+  }
+  return segments;
+}
+
+// Match path segments against pattern segments; a final "**" needs at least one segment left,
+// as a file must remain below the directories it spans
+bool matchSegments(std::span<const std::string_view> pattern,
+                   std::span<const std::string_view> path) {
+  if (pattern.empty()) {
+    return path.empty();
+  }
+  if (pattern.front() == "**") {
+    if (pattern.size() == 1) {
+      return !path.empty();
+    }
+    for (size_t skip = 0; skip <= path.size(); ++skip) {
+      if (matchSegments(pattern.subspan(1), path.subspan(skip))) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return !path.empty() && matchSegment(pattern.front(), path.front()) &&
+         matchSegments(pattern.subspan(1), path.subspan(1));
+}
+
+// Name of an entry within its directory
+std::string_view fileName(const EntryView &entry) noexcept {
+  size_t slash = entry.path.rfind('/');
+  return slash == std::string_view::npos ? entry.path : entry.path.substr(slash + 1);
+}
+
+} // namespace
+
+void DirectoryTree::build(std::span<const EntryView> entries) {
+  clear();
+
+  // Create one node per distinct directory prefix; prefixes are views into the entry paths
+  nodes_.emplace_back();
+  std::vector<uint32_t> parents = {0};
+  std::vector<uint32_t> fileParents(entries.size());
+  std::unordered_map<std::string_view, uint32_t, detail::PathHash, detail::PathEqual> nodeOf;
+
+  std::string_view lastDirectory;
+  uint32_t lastNode = 0;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    std::string_view path = entries[i].path;
+    size_t slash = path.rfind('/');
+    std::string_view directory = slash == std::string_view::npos ? std::string_view()
+                                                                 : path.substr(0, slash);
+
+    // Archives usually list a directory's files together, so most entries reuse the last node
+    if (i == 0 || !detail::pathEquals(directory, lastDirectory)) {
+      uint32_t node = 0;
+      size_t pos = 0;
+      while (pos < directory.size()) {
+        size_t end = std::min(directory.find('/', pos), directory.size());
+        auto [it, inserted] =
+            nodeOf.try_emplace(directory.substr(0, end), static_cast<uint32_t>(nodes_.size()));
+        if (inserted) {
+          nodes_.push_back(Node{directory.substr(pos, end - pos)});
+          parents.push_back(node);
+        }
+        node = it->second;
+        pos = end + 1;
+      }
+      lastDirectory = directory;
+      lastNode = node;
+    }
+    fileParents[i] = lastNode;
+  }
+
+  // Group children by parent (counting sort), then sort each group by name
+  for (size_t node = 1; node < nodes_.size(); ++node) {
+    ++nodes_[parents[node]].dirCount;
+  }
+  for (uint32_t parent : fileParents) {
+    ++nodes_[parent].fileCount;
+  }
+  uint32_t dirOffset = 0;
+  uint32_t fileOffset = 0;
+  for (Node &node : nodes_) {
+    node.firstDir = dirOffset;
+    node.firstFile = fileOffset;
+    dirOffset += node.dirCount;
+    fileOffset += node.fileCount;
+  }
+
+  std::vector<uint32_t> dirFill(nodes_.size());
+  std::vector<uint32_t> fileFill(nodes_.size());
+  childDirs_.resize(dirOffset);
+  childFiles_.resize(fileOffset);
+  for (size_t node = 1; node < nodes_.size(); ++node) {
+    uint32_t parent = parents[node];
+    childDirs_[nodes_[parent].firstDir + dirFill[parent]++] = static_cast<uint32_t>(node);
+  }
+  for (size_t i = 0; i < entries.size(); ++i) {
+    uint32_t parent = fileParents[i];
+    childFiles_[nodes_[parent].firstFile + fileFill[parent]++] = &entries[i];
+  }
+
+  for (const Node &node : nodes_) {
+    auto dirs = childDirs_.begin() + node.firstDir;
+    std::sort(dirs, dirs + node.dirCount, [this](uint32_t a, uint32_t b) {
+      return detail::compareFolded(nodes_[a].name, nodes_[b].name) < 0;
+    });
+    auto files = childFiles_.begin() + node.firstFile;
+    std::sort(files, files + node.fileCount, [](const EntryView *a, const EntryView *b) {
+      return detail::compareFolded(fileName(*a), fileName(*b)) < 0;
+    });
+  }
+}
+
+void DirectoryTree::clear() {
+  nodes_.clear();
+  childDirs_.clear();
+  childFiles_.clear();
+}
+
+std::optional<DirectoryListing> DirectoryTree::list(std::string_view directory) const {
+  auto node = findDirectory(directory);
+  if (!node) {
+    return std::nullopt;
+  }
+
+  const Node &dir = nodes_[*node];
+  DirectoryListing listing;
+  listing.directories.reserve(dir.dirCount);
+  for (uint32_t i = 0; i < dir.dirCount; ++i) {
+    listing.directories.push_back(nodes_[childDirs_[dir.firstDir + i]].name);
+  }
+  listing.files.assign(childFiles_.begin() + dir.firstFile,
+                       childFiles_.begin() + dir.firstFile + dir.fileCount);
+  return listing;
+}
+
+bool DirectoryTree::forEachFile(std::string_view directory,
+                                const std::function<void(const EntryView &)> &visitor) const {
+  auto node = findDirectory(directory);
+  if (!node) {
+    return false;
+  }
+  visit(*node, visitor);
+  return true;
+}
+
+std::vector<const EntryView *> DirectoryTree::glob(std::string_view pattern) const {
+  std::vector<const EntryView *> result;
+  std::vector<std::string_view> segments = splitSegments(pattern);
+  if (nodes_.empty() || segments.empty()) {
+    return result;
+  }
+  match(0, segments, result);
+
+  // Several "**" segments can reach the same file along different splits; keep the first
+  if (std::count(segments.begin(), segments.end(), "**") > 1) {
+    std::unordered_set<const EntryView *> seen;
+    std::erase_if(result, [&seen](const EntryView *entry) { return !seen.insert(entry).second; });
+  }
+  return result;
+}
+
+bool globMatch(std::string_view pattern, std::string_view path) {
+  return matchSegments(splitSegments(pattern), splitSegments(path));
+}
+
+std::optional<uint32_t> DirectoryTree::findDirectory(std::string_view directory) const {
+  if (nodes_.empty()) {
+    return std::nullopt;
+  }
+  uint32_t node = 0;
+  for (std::string_view segment : splitSegments(directory)) {
+    auto child = findChild(node, segment);
+    if (!child) {
+      return std::nullopt;
+    }
+    node = *child;
+  }
+  return node;
+}
+
+std::optional<uint32_t> DirectoryTree::findChild(uint32_t node, std::string_view name) const {
+  const Node &dir = nodes_[node];
+  auto first = childDirs_.begin() + dir.firstDir;
+  auto last = first + dir.dirCount;
+  auto it = std::lower_bound(first, last, name, [this](uint32_t child, std::string_view key) {
+    return detail::compareFolded(nodes_[child].name, key) < 0;
+  });
+  if (it == last || detail::compareFolded(nodes_[*it].name, name) != 0) {
+    return std::nullopt;
+  }
+  return *it;
+}
+
+void DirectoryTree::visit(uint32_t node,
+                          const std::function<void(const EntryView &)> &visitor) const {
+  const Node &dir = nodes_[node];
+  for (uint32_t i = 0; i < dir.fileCount; ++i) {
+    visitor(*childFiles_[dir.firstFile + i]);
+  }
+  for (uint32_t i = 0; i < dir.dirCount; ++i) {
+    visit(childDirs_[dir.firstDir + i], visitor);
+  }
+}
+
+void DirectoryTree::match(uint32_t node, std::span<const std::string_view> segments,
+                          std::vector<const EntryView *> &out) const {
+  const Node &dir = nodes_[node];
+  std::string_view segment = segments.front();
+
+  if (segments.size() == 1) {
+    // Last segment: select files of this directory (or, for "**", of the whole subtree)
+    if (segment == "**") {
+      visit(node, [&out](const EntryView &entry) { out.push_back(&entry); });
+      return;
+    }
+    auto first = childFiles_.begin() + dir.firstFile;
+    auto last = first + dir.fileCount;
+    if (!hasWildcard(segment)) {
+      auto it = std::lower_bound(first, last, segment,
+                                 [](const EntryView *entry, std::string_view key) {
+                                   return detail::compareFolded(fileName(*entry), key) < 0;
+                                 });
+      if (it != last && detail::compareFolded(fileName(**it), segment) == 0) {
+        out.push_back(*it);
+      }
+      return;
+    }
+    for (auto it = first; it != last; ++it) {
+      if (matchSegment(segment, fileName(**it))) {
+        out.push_back(*it);
+      }
+    }
+    return;
+  }
+
+  if (segment == "**") {
+    // Match zero directories here, then one more in each subdirectory
+    match(node, segments.subspan(1), out);
+    for (uint32_t i = 0; i < dir.dirCount; ++i) {
+      match(childDirs_[dir.firstDir + i], segments, out);
+    }
+    return;
+  }
+  if (!hasWildcard(segment)) {
+    if (auto child = findChild(node, segment)) {
+      match(*child, segments.subspan(1), out);
+    }
+    return;
+  }
+  for (uint32_t i = 0; i < dir.dirCount; ++i) {
+    uint32_t child = childDirs_[dir.firstDir + i];
+    if (matchSegment(segment, nodes_[child].name)) {
+      match(child, segments.subspan(1), out);
+    }
+  }
+}
+
+} // namespace bigx
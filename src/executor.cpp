@@ -0,0 +1,54 @@
+#include <cstdint>
+
+#include <bigx/executor.hpp>
+
+#include "parallel.hpp"
+
+namespace bigx {
+
+ThreadPool::ThreadPool(unsigned threads) {
+  unsigned count = detail::resolveThreadCount(threads, SIZE_MAX);
+  workers_.reserve(count);
+  for (unsigned i = 0; i < count; ++i) {
+    workers_.emplace_back([this]() { run(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  // Each worker exits on the first token that finds the queue empty
+  tokens_.release(static_cast<std::ptrdiff_t>(workers_.size()));
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+  {
+    std::lock_guard lock(mutex_);
+    queue_.push_back(std::move(task));
+  }
+  tokens_.release();
+}
+
+void ThreadPool::run() {
+  for (;;) {
+    tokens_.acquire();
+    std::function<void()> task;
+    {
+      std::lock_guard lock(mutex_);
+      if (queue_.empty()) {
+        return; // Shutdown token and nothing left to run
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    task();
+  }
+}
+
+Executor &defaultExecutor() {
+  static ThreadPool pool;
+  return pool;
+}
+
+} // namespace bigx
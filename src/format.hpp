@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include <bigx/endian.hpp>
+#include <bigx/types.hpp>
+
+// Private description of the on-disk archive variants shared by Reader and Writer
+// All variants use a 16-byte header followed by (offset, size, NUL-terminated path) records;
+// they differ in magic, header field placement and the width of the numeric fields.
+namespace bigx::detail {
+
+struct FormatLayout {
+  const char *magic = nullptr;  // 4-byte identifier at +0
+  size_t archiveSizeOffset = 0; // Header offset of the archive size field
+  size_t fileCountOffset = 0;   // Header offset of the uint32 entry count
+  size_t fieldSize = 0;         // Width of the archive size and each record's offset/size (4 or 8)
+
+  // Largest value the archive size and record fields can hold
+  uint64_t maxValue() const { return fieldSize == 8 ? UINT64_MAX : UINT32_MAX; }
+
+  // Smallest possible directory record (offset, size, empty path)
+  size_t minRecordSize() const { return 2 * fieldSize + 1; }
+};
+
+inline constexpr FormatLayout bigFLayout{"BIGF", 4, 8, 4};
+inline constexpr FormatLayout big4Layout{"BIG4", 4, 8, 4};
+inline constexpr FormatLayout big64Layout{"BIGX", 8, 4, 8};
+
+inline const FormatLayout &layoutOf(ArchiveFormat format) {
+  switch (format) {
+  case ArchiveFormat::Big4:
+    return big4Layout;
+  case ArchiveFormat::Big64:
+    return big64Layout;
+  case ArchiveFormat::BigF:
+    break;
+  }
+  return bigFLayout;
+}
+
+// Identify an archive from its first 4 bytes
+inline std::optional<ArchiveFormat> formatFromMagic(const uint8_t *magic) {
+  for (auto format : {ArchiveFormat::BigF, ArchiveFormat::Big4, ArchiveFormat::Big64}) {
+    if (std::memcmp(magic, layoutOf(format).magic, 4) == 0) {
+      return format;
+    }
+  }
+  return std::nullopt;
+}
+
+// Read a big-endian field of the given width (4 or 8)
+inline uint64_t loadField(const uint8_t *data, size_t width) noexcept {
+  if (width == 8) {
+    uint64_t value;
+    std::memcpy(&value, data, 8);
+    return betoh64(value);
+  }
+  uint32_t value;
+  std::memcpy(&value, data, 4);
+  return betoh32(value);
+}
+
+// Read a big-endian field whose width (4 or 8) is known at compile time
+template <size_t Width>
+inline uint64_t loadField(const uint8_t *data) noexcept {
+  static_assert(Width == 4 || Width == 8);
+  if constexpr (Width == 8) {
+    uint64_t value;
+    std::memcpy(&value, data, 8);
+    return betoh64(value);
+  } else {
+    uint32_t value;
+    std::memcpy(&value, data, 4);
+    return betoh32(value);
+  }
+}
+
+// Write a big-endian field of the given width (4 or 8); value must fit
+inline void storeField(uint8_t *data, size_t width, uint64_t value) noexcept {
+  if (width == 8) {
+    uint64_t be = htobe64(value);
+    std::memcpy(data, &be, 8);
+    return;
+  }
+  uint32_t be = htobe32(static_cast<uint32_t>(value));
+  std::memcpy(data, &be, 4);
+}
+
+// Fill a 16-byte header
+inline void storeHeader(uint8_t *data, const FormatLayout &layout, uint32_t fileCount,
+                        uint64_t archiveSize) noexcept {
+  std::memset(data, 0, ArchiveHeader::headerSize);
+  std::memcpy(data, layout.magic, 4);
+  storeField(data + layout.archiveSizeOffset, layout.fieldSize, archiveSize);
+  storeField(data + layout.fileCountOffset, 4, fileCount);
+}
+
+// Check that [offset, offset + size) lies within total bytes, without overflowing
+inline bool rangeFits(uint64_t offset, uint64_t size, uint64_t total) noexcept {
+  return offset <= total && size <= total - offset;
+}
+
+} // namespace bigx::detail
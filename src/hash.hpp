@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "format.hpp"
+
+// Private fast non-cryptographic hash over raw bytes (index trailer checksum, payload dedup)
+namespace bigx::detail {
+
+inline constexpr uint64_t hashSeed = 0xcbf29ce484222325ull;
+
+// Fold bytes into hash a word at a time; the result does not depend on host byte order
+inline uint64_t hashBytes(uint64_t hash, std::span<const uint8_t> bytes) noexcept {
+  size_t i = 0;
+  for (; i + 8 <= bytes.size(); i += 8) {
+    hash = (hash ^ loadField(bytes.data() + i, 8)) * 0x9e3779b97f4a7c15ull;
+    hash ^= hash >> 29;
+  }
+  for (; i < bytes.size(); ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+  return hash;
+}
+
+} // namespace bigx::detail
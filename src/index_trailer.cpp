@@ -0,0 +1,101 @@
+#include <cstring>
+
+#include "hash.hpp"
+#include "index_trailer.hpp"
+
+namespace bigx::detail {
+
+namespace {
+
+constexpr char footerMagic[8] = {'B', 'I', 'G', 'X', 'I', 'D', 'X', '1'};
+
+// Checksum of the directory and every trailer byte before the checksum field
+uint64_t trailerChecksum(std::span<const uint8_t> directory,
+                         std::span<const uint8_t> trailer) noexcept {
+  uint64_t hash = hashBytes(hashSeed, directory);
+  return hashBytes(hash, trailer.first(trailer.size() - 8));
+}
+
+} // namespace
+
+size_t indexTrailerSize(const PathIndex &index, size_t entryCount) {
+  return index.slotCount() * PathIndex::slotBytes + 4 * entryCount + indexFooterSize;
+}
+
+void storeIndexTrailer(std::span<const uint8_t> directory, const PathIndex &index,
+                       std::span<const size_t> recordOffsets, std::span<uint8_t> out) {
+  uint8_t *pos = out.data();
+  index.store(pos);
+  pos += index.slotCount() * PathIndex::slotBytes;
+  for (size_t offset : recordOffsets) {
+    storeField(pos, 4, offset);
+    pos += 4;
+  }
+
+  std::memcpy(pos, footerMagic, sizeof(footerMagic));
+  storeField(pos + 8, 4, recordOffsets.size());
+  storeField(pos + 12, 4, index.slotCount());
+  storeField(pos + 16, 8, directory.size());
+  storeField(pos + 24, 8, trailerChecksum(directory, out));
+}
+
+std::span<const uint8_t> loadIndexTrailer(std::span<const uint8_t> data, uint32_t entryCount,
+                                          size_t recordHead, PathIndex &index) {
+  if (data.size() < ArchiveHeader::headerSize + indexFooterSize) {
+    return {};
+  }
+  const uint8_t *footer = data.data() + data.size() - indexFooterSize;
+  if (std::memcmp(footer, footerMagic, sizeof(footerMagic)) != 0 ||
+      loadField(footer + 8, 4) != entryCount) {
+    return {};
+  }
+
+  // The trailer must sit behind the directory it describes, and neither may leave the file
+  uint64_t slotCount = loadField(footer + 12, 4);
+  uint64_t directoryEnd = loadField(footer + 16, 8);
+  uint64_t trailerSize = slotCount * PathIndex::slotBytes + 4ull * entryCount + indexFooterSize;
+  if (trailerSize > data.size() || directoryEnd < ArchiveHeader::headerSize ||
+      directoryEnd > data.size() - trailerSize) {
+    return {};
+  }
+
+  auto trailer = data.last(static_cast<size_t>(trailerSize));
+  auto directory = data.first(static_cast<size_t>(directoryEnd));
+  if (loadField(footer + 24, 8) != trailerChecksum(directory, trailer)) {
+    return {};
+  }
+
+  // Every record must start inside the directory, so its name can be read without overrunning
+  auto records = trailer.subspan(static_cast<size_t>(slotCount) * PathIndex::slotBytes,
+                                 4 * static_cast<size_t>(entryCount));
+  for (uint32_t i = 0; i < entryCount; ++i) {
+    size_t offset = trailerRecord(records, i);
+    if (offset < ArchiveHeader::headerSize || offset + recordHead >= directoryEnd) {
+      return {};
+    }
+  }
+
+  if (!index.load(trailer.data(), static_cast<size_t>(slotCount), entryCount)) {
+    return {};
+  }
+  return records;
+}
+
+size_t indexTrailerExtent(std::span<const uint8_t> data) noexcept {
+  if (data.size() < ArchiveHeader::headerSize + indexFooterSize) {
+    return 0;
+  }
+  const uint8_t *footer = data.data() + data.size() - indexFooterSize;
+  if (std::memcmp(footer, footerMagic, sizeof(footerMagic)) != 0) {
+    return 0;
+  }
+  uint64_t slotCount = loadField(footer + 12, 4);
+  uint64_t trailerSize = slotCount * PathIndex::slotBytes + 4 * loadField(footer + 8, 4) +
+                         indexFooterSize;
+  if (trailerSize > data.size() - ArchiveHeader::headerSize) {
+    return 0;
+  }
+  return static_cast<size_t>(trailerSize);
+}
+
+} // namespace bigx::detail
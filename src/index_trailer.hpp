@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <bigx/path_index.hpp>
+
+#include "format.hpp"
+
+// Private layout of the prebuilt index that Writer appends with WriteOptions::indexTrailer
+//   slots    PathIndex::slotCount() x (uint32 hash, uint32 entry index)
+//   records  entryCount x uint32 offset of the entry's directory record
+//   footer   "BIGXIDX1", uint32 entryCount, uint32 slotCount, uint64 directoryEnd, uint64 checksum
+// All fields are big-endian and the footer ends the file. The trailer is counted in the header's
+// archive size but referenced by no directory entry, so readers that know nothing of it still
+// work. The checksum covers the header, the directory, the slots and the records, so rewriting
+// the directory in place (as Updater does) leaves a stale trailer that is simply ignored.
+namespace bigx::detail {
+
+inline constexpr size_t indexFooterSize = 32;
+
+// Trailer size for a directory of entryCount entries hashed into index
+size_t indexTrailerSize(const PathIndex &index, size_t entryCount);
+
+// Write the trailer for the finished header and directory in directory into out
+// recordOffsets holds each entry's record position; out must be indexTrailerSize() bytes
+void storeIndexTrailer(std::span<const uint8_t> directory, const PathIndex &index,
+                       std::span<const size_t> recordOffsets, std::span<uint8_t> out);
+
+// Find and validate the trailer at the end of an archive of entryCount entries whose records
+// start with recordHead bytes of offset and size. On success the slots are loaded into index
+// and the record offsets (entryCount big-endian uint32 values) are returned; on any mismatch an
+// empty span is returned and index is left empty.
+std::span<const uint8_t> loadIndexTrailer(std::span<const uint8_t> data, uint32_t entryCount,
+                                          size_t recordHead, PathIndex &index);
+
+// Size of the index trailer that ends data, judged from its footer alone, or 0 if there is none
+// Lets other trailers stored in front of it be found without validating the index.
+size_t indexTrailerExtent(std::span<const uint8_t> data) noexcept;
+
+// Read record offset i from the span returned by loadIndexTrailer()
+inline size_t trailerRecord(std::span<const uint8_t> records, uint32_t i) noexcept {
+  return static_cast<size_t>(loadField(records.data() + 4 * static_cast<size_t>(i), 4));
+}
+
+} // namespace bigx::detail
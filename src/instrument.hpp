@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+#include <bigx/stats.hpp>
+
+// Private instrumentation hooks; see stats.hpp
+// BIGX_COUNT adds to a counter of a possibly-null counters object. With stats disabled it
+// expands to nothing and its arguments are not evaluated.
+#if BIGX_ENABLE_STATS
+#define BIGX_COUNT(counters, field, amount)                                                        \
+  do {                                                                                             \
+    if (counters) {                                                                                \
+      (counters)->field.fetch_add((amount), std::memory_order_relaxed);                            \
+    }                                                                                              \
+  } while (0)
+#else
+#define BIGX_COUNT(counters, field, amount) ((void)0)
+#endif
+
+namespace bigx::detail {
+
+// Measures a scope and reports it to a phase callback on destruction
+// The clock is only read when stats are compiled in and a callback is set.
+class PhaseTimer {
+public:
+  PhaseTimer(const PhaseCallback *callback, Phase phase) {
+    if constexpr (statsEnabled) {
+      if (callback && *callback) {
+        callback_ = callback;
+        phase_ = phase;
+        start_ = std::chrono::steady_clock::now();
+      }
+    } else {
+      (void)callback;
+      (void)phase;
+    }
+  }
+
+  ~PhaseTimer() {
+    if constexpr (statsEnabled) {
+      if (callback_) {
+        (*callback_)(phase_, std::chrono::steady_clock::now() - start_);
+      }
+    }
+  }
+
+  PhaseTimer(const PhaseTimer &) = delete;
+  PhaseTimer &operator=(const PhaseTimer &) = delete;
+
+private:
+  const PhaseCallback *callback_ = nullptr;
+  Phase phase_ = Phase::Map;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Measures a scope into a nanosecond counter (only when stats are compiled in)
+class ScopeClock {
+public:
+  explicit ScopeClock(std::atomic<uint64_t> *counter) {
+    if constexpr (statsEnabled) {
+      counter_ = counter;
+      start_ = std::chrono::steady_clock::now();
+    } else {
+      (void)counter;
+    }
+  }
+
+  // Stop without recording (e.g. the operation failed)
+  void cancel() { counter_ = nullptr; }
+
+  ~ScopeClock() {
+    if constexpr (statsEnabled) {
+      if (counter_) {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        counter_->fetch_add(
+            static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            std::memory_order_relaxed);
+      }
+    }
+  }
+
+  ScopeClock(const ScopeClock &) = delete;
+  ScopeClock &operator=(const ScopeClock &) = delete;
+
+private:
+  std::atomic<uint64_t> *counter_ = nullptr;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace bigx::detail
@@ -1,8 +1,14 @@
+#include <algorithm>
+#include <cstdint>
 #include <format>
+#include <vector>
 
 #include <bigx/mmap.hpp>
 
 #ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Keep std::min/std::max usable
+#endif
 #include <windows.h>
 #else
 #include <cerrno>
@@ -96,6 +102,13 @@ bool MappedFile::openRead(const std::filesystem::path &path, std::string *outErr
     return false;
   }
 
+  if (static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX) {
+    if (outError) {
+      *outError = std::format("File too large to map on this platform: {}", path.string());
+    }
+    close();
+    return false;
+  }
   size_ = static_cast<size_t>(fileSize.QuadPart);
 
   mappingHandle_ =
@@ -150,6 +163,14 @@ bool MappedFile::openRead(const std::filesystem::path &path, std::string *outErr
     return false;
   }
 
+  // 32-bit hosts cannot map archives over 4 GiB (off_t is 64-bit via _FILE_OFFSET_BITS)
+  if (static_cast<uint64_t>(st.st_size) > SIZE_MAX) {
+    if (outError) {
+      *outError = std::format("File too large to map on this platform: {}", path.string());
+    }
+    close();
+    return false;
+  }
   size_ = static_cast<size_t>(st.st_size);
 
   data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
@@ -261,6 +282,97 @@ bool MappedFile::openWrite(const std::filesystem::path &path, size_t size, std::
 #endif
 }
 
+bool MappedFile::pageRange(size_t offset, size_t length, void **outStart,
+                           size_t *outLength) const {
+  if (!data_ || offset >= size_) {
+    return false;
+  }
+  length = std::min(length, size_ - offset);
+  if (length == 0) {
+    return false;
+  }
+
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  size_t pageSize = info.dwPageSize;
+#else
+  size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+
+  // The mapping itself is page aligned, so aligning the offset aligns the address
+  size_t start = offset - offset % pageSize;
+  *outStart = static_cast<uint8_t *>(data_) + start;
+  *outLength = offset + length - start;
+  return true;
+}
+
+bool MappedFile::advise(AccessPattern pattern, size_t offset, size_t length) {
+  void *start = nullptr;
+  size_t span = 0;
+  if (!pageRange(offset, length, &start, &span)) {
+    return false;
+  }
+
+#ifdef _WIN32
+  // Windows has no per-range readahead policy for mapped views
+  (void)pattern;
+  return true;
+#else
+  int advice = MADV_NORMAL;
+  switch (pattern) {
+  case AccessPattern::Normal:
+    advice = MADV_NORMAL;
+    break;
+  case AccessPattern::Sequential:
+    advice = MADV_SEQUENTIAL;
+    break;
+  case AccessPattern::Random:
+    advice = MADV_RANDOM;
+    break;
+  }
+  return madvise(start, span, advice) == 0;
+#endif
+}
+
+bool MappedFile::prefetch(size_t offset, size_t length) {
+  MappedRange range{offset, length};
+  return prefetch(std::span<const MappedRange>(&range, 1));
+}
+
+bool MappedFile::prefetch(std::span<const MappedRange> ranges) {
+  if (!data_) {
+    return false;
+  }
+
+#ifdef _WIN32
+  // One call covers every range
+  std::vector<WIN32_MEMORY_RANGE_ENTRY> entries;
+  entries.reserve(ranges.size());
+  for (const auto &range : ranges) {
+    void *start = nullptr;
+    size_t span = 0;
+    if (pageRange(range.offset, range.length, &start, &span)) {
+      entries.push_back({start, span});
+    }
+  }
+  if (entries.empty()) {
+    return true;
+  }
+  return PrefetchVirtualMemory(GetCurrentProcess(), entries.size(), entries.data(), 0) != 0;
+#else
+  bool ok = true;
+  for (const auto &range : ranges) {
+    void *start = nullptr;
+    size_t span = 0;
+    if (pageRange(range.offset, range.length, &start, &span)) {
+      ok = madvise(start, span, MADV_WILLNEED) == 0 && ok;
+    }
+  }
+  return ok;
+#endif
+}
+
 bool MappedFile::flush(std::string *outError) {
   if (!data_ || !writable_) {
     if (outError) {
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace bigx::detail {
+
+// Resolve a requested worker count (0 = hardware concurrency), never exceeding the work size
+inline unsigned resolveThreadCount(unsigned requested, size_t workItems) {
+  unsigned threads = requested;
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (workItems < threads) {
+    threads = static_cast<unsigned>(std::max<size_t>(1, workItems));
+  }
+  return threads;
+}
+
+// Run fn(index) for every index in [0, count) on up to `threads` workers
+// Work is handed out through a shared atomic counter, so uneven item costs balance out.
+// The calling thread participates as one of the workers.
+template <typename Fn>
+void parallelFor(size_t count, unsigned threads, Fn &&fn) {
+  threads = resolveThreadCount(threads, count);
+  if (threads <= 1) {
+    for (size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+         i = next.fetch_add(1, std::memory_order_relaxed)) {
+      fn(i);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (unsigned t = 1; t < threads; ++t) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : pool) {
+    thread.join();
+  }
+}
+
+} // namespace bigx::detail
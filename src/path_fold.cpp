@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "path_fold.hpp"
+
+#if defined(__AVX2__)
+#define BIGX_FOLD_AVX2 1
+#define BIGX_FOLD_SSE2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIGX_FOLD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define BIGX_FOLD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace bigx::detail {
+
+namespace {
+
+template <bool Lower>
+inline char foldChar(char c) noexcept {
+  if constexpr (Lower) {
+    return foldedChar(c);
+  } else {
+    return c == '\\' ? '/' : c;
+  }
+}
+
+// Each block kernel replaces backslashes with a blend, then (when lowercasing) ORs 0x20 into
+// bytes in ['A', 'Z']. The range test uses signed compares, so bytes >= 0x80 are never touched.
+#if BIGX_FOLD_AVX2
+template <bool Lower>
+inline __m256i fold32(__m256i v) noexcept {
+  __m256i isBackslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+  v = _mm256_blendv_epi8(v, _mm256_set1_epi8('/'), isBackslash);
+  if constexpr (Lower) {
+    __m256i isUpper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    v = _mm256_or_si256(v, _mm256_and_si256(isUpper, _mm256_set1_epi8(0x20)));
+  }
+  return v;
+}
+#endif
+
+#if BIGX_FOLD_SSE2
+template <bool Lower>
+inline __m128i fold16(__m128i v) noexcept {
+  __m128i isBackslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+  v = _mm_or_si128(_mm_andnot_si128(isBackslash, v),
+                   _mm_and_si128(isBackslash, _mm_set1_epi8('/')));
+  if constexpr (Lower) {
+    __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                    _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    v = _mm_or_si128(v, _mm_and_si128(isUpper, _mm_set1_epi8(0x20)));
+  }
+  return v;
+}
+#endif
+
+#if BIGX_FOLD_NEON
+template <bool Lower>
+inline uint8x16_t fold16(uint8x16_t v) noexcept {
+  v = vbslq_u8(vceqq_u8(v, vdupq_n_u8('\\')), vdupq_n_u8('/'), v);
+  if constexpr (Lower) {
+    uint8x16_t isUpper = vandq_u8(vcgeq_u8(v, vdupq_n_u8('A')), vcleq_u8(v, vdupq_n_u8('Z')));
+    v = vorrq_u8(v, vandq_u8(isUpper, vdupq_n_u8(0x20)));
+  }
+  return v;
+}
+#endif
+
+template <bool Lower>
+void foldInto(const char *src, size_t size, char *dst) noexcept {
+  size_t i = 0;
+#if BIGX_FOLD_AVX2
+  for (; i + 32 <= size; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), fold32<Lower>(v));
+  }
+#endif
+#if BIGX_FOLD_SSE2
+  for (; i + 16 <= size; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), fold16<Lower>(v));
+  }
+#elif BIGX_FOLD_NEON
+  for (; i + 16 <= size; i += 16) {
+    uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(src + i));
+    vst1q_u8(reinterpret_cast<uint8_t *>(dst + i), fold16<Lower>(v));
+  }
+#endif
+  for (; i < size; ++i) {
+    dst[i] = foldChar<Lower>(src[i]);
+  }
+}
+
+} // namespace
+
+void foldPath(const char *src, size_t size, char *dst) noexcept {
+  foldInto<true>(src, size, dst);
+}
+
+void foldSlashes(const char *src, size_t size, char *dst) noexcept {
+  foldInto<false>(src, size, dst);
+}
+
+bool foldedEquals(const char *a, const char *b, size_t size) noexcept {
+  size_t i = 0;
+#if BIGX_FOLD_AVX2
+  for (; i + 32 <= size; i += 32) {
+    __m256i va = fold32<true>(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)));
+    __m256i vb = fold32<true>(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb)) != -1) {
+      return false;
+    }
+  }
+#endif
+#if BIGX_FOLD_SSE2
+  for (; i + 16 <= size; i += 16) {
+    __m128i va = fold16<true>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+    __m128i vb = fold16<true>(_mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)) != 0xFFFF) {
+      return false;
+    }
+  }
+#elif BIGX_FOLD_NEON
+  for (; i + 16 <= size; i += 16) {
+    uint8x16_t va = fold16<true>(vld1q_u8(reinterpret_cast<const uint8_t *>(a + i)));
+    uint8x16_t vb = fold16<true>(vld1q_u8(reinterpret_cast<const uint8_t *>(b + i)));
+    if (vminvq_u8(vceqq_u8(va, vb)) != 0xFF) {
+      return false;
+    }
+  }
+#endif
+  for (; i < size; ++i) {
+    if (foldChar<true>(a[i]) != foldChar<true>(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int compareFolded(std::string_view a, std::string_view b) noexcept {
+  size_t common = std::min(a.size(), b.size());
+  for (size_t i = 0; i < common; ++i) {
+    auto ca = static_cast<unsigned char>(foldedChar(a[i]));
+    auto cb = static_cast<unsigned char>(foldedChar(b[i]));
+    if (ca != cb) {
+      return ca < cb ? -1 : 1;
+    }
+  }
+  return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+}
+
+std::string foldedPath(std::string_view path) {
+  std::string result(path.size(), '\0');
+  foldPath(path.data(), path.size(), result.data());
+  return result;
+}
+
+std::string slashedPath(std::string_view path) {
+  std::string result(path.size(), '\0');
+  foldSlashes(path.data(), path.size(), result.data());
+  return result;
+}
+
+} // namespace bigx::detail
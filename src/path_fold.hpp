@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Private path normalization kernels shared by Reader, Writer, Updater, VirtualFS and PathIndex
+// Folding is ASCII-only (matching the game's lookup) and maps backslashes to forward slashes.
+// The block loops use AVX2 when the library is compiled for it, SSE2 on other x86-64 builds,
+// NEON on AArch64 and a scalar loop elsewhere; every variant produces identical output.
+namespace bigx::detail {
+
+// Write size bytes of src into dst, lowercased with forward slashes (dst may equal src)
+void foldPath(const char *src, size_t size, char *dst) noexcept;
+
+// Write size bytes of src into dst with forward slashes, preserving case (dst may equal src)
+void foldSlashes(const char *src, size_t size, char *dst) noexcept;
+
+// Compare size bytes of a and b under foldPath() rules
+bool foldedEquals(const char *a, const char *b, size_t size) noexcept;
+
+// Three-way comparison of a and b under foldPath() rules, by unsigned byte value (<0, 0, >0)
+// The case-insensitive sort order of DirectoryTree.
+int compareFolded(std::string_view a, std::string_view b) noexcept;
+
+// Fold one character under foldPath() rules
+inline char foldedChar(char c) noexcept {
+  if (c >= 'A' && c <= 'Z') {
+    return static_cast<char>(c + ('a' - 'A'));
+  }
+  return c == '\\' ? '/' : c;
+}
+
+// Get a lowercased, forward-slash copy of path (the FileEntry::lowercasePath form)
+std::string foldedPath(std::string_view path);
+
+// Get a forward-slash copy of path, preserving case (the FileEntry::path form)
+std::string slashedPath(std::string_view path);
+
+} // namespace bigx::detail
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <bit>
+
+#include <bigx/path_index.hpp>
+
+#include "format.hpp"
+#include "path_fold.hpp"
+
+namespace bigx::detail {
+
+uint64_t hashPath(std::string_view path) noexcept {
+  // FNV-1a over folded bytes, folded a block at a time into a stack buffer
+  uint64_t hash = 0xcbf29ce484222325ull;
+  char folded[64];
+  for (size_t pos = 0; pos < path.size(); pos += sizeof(folded)) {
+    size_t block = std::min(sizeof(folded), path.size() - pos);
+    foldPath(path.data() + pos, block, folded);
+    for (size_t i = 0; i < block; ++i) {
+      hash ^= static_cast<unsigned char>(folded[i]);
+      hash *= 0x100000001b3ull;
+    }
+  }
+  return hash;
+}
+
+bool pathEquals(std::string_view a, std::string_view b) noexcept {
+  return a.size() == b.size() && foldedEquals(a.data(), b.data(), a.size());
+}
+
+bool PathIndex::build(std::span<const EntryView> entries, size_t *outDuplicate) {
+  // Keep the load factor at or below 50% so probe sequences stay short
+  size_t capacity = std::bit_ceil(std::max<size_t>(16, entries.size() * 2));
+  slots_.assign(capacity, Slot{});
+  const size_t mask = capacity - 1;
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    uint32_t hash = static_cast<uint32_t>(hashPath(entries[i].path));
+    size_t slot = hash & mask;
+
+    while (slots_[slot].index != emptySlot) {
+      const Slot &existing = slots_[slot];
+      if (existing.hash == hash && pathEquals(entries[existing.index].path, entries[i].path)) {
+        if (outDuplicate) {
+          *outDuplicate = i;
+        }
+        return false;
+      }
+      slot = (slot + 1) & mask;
+    }
+
+    slots_[slot] = Slot{hash, static_cast<uint32_t>(i)};
+  }
+
+  return true;
+}
+
+std::optional<uint32_t> PathIndex::find(std::span<const EntryView> entries,
+                                        std::string_view path) const {
+  return find(path, [entries](uint32_t index) { return entries[index].path; });
+}
+
+void PathIndex::clear() {
+  slots_.clear();
+  slots_.shrink_to_fit();
+}
+
+void PathIndex::store(uint8_t *out) const {
+  for (const Slot &slot : slots_) {
+    storeField(out, 4, slot.hash);
+    storeField(out + 4, 4, slot.index);
+    out += slotBytes;
+  }
+}
+
+bool PathIndex::load(const uint8_t *data, size_t slotCount, size_t entryCount) {
+  // At least one slot must stay empty, or a probe for a missing path would never end
+  if (slotCount < 16 || !std::has_single_bit(slotCount) || entryCount >= slotCount) {
+    return false;
+  }
+
+  slots_.resize(slotCount);
+  size_t used = 0;
+  for (Slot &slot : slots_) {
+    slot.hash = static_cast<uint32_t>(loadField(data, 4));
+    slot.index = static_cast<uint32_t>(loadField(data + 4, 4));
+    data += slotBytes;
+    if (slot.index != emptySlot && (slot.index >= entryCount || ++used > entryCount)) {
+      clear();
+      return false;
+    }
+  }
+  if (used != entryCount) {
+    clear();
+    return false;
+  }
+  return true;
+}
+
+} // namespace bigx::detail
@@ -1,31 +1,234 @@
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <format>
 #include <fstream>
+#include <optional>
 #include <unordered_set>
 
 #include <bigx/endian.hpp>
+#include <bigx/executor.hpp>
 #include <bigx/mmap.hpp>
 #include <bigx/reader.hpp>
+#include <bigx/refpack.hpp>
+
+#include "batch_io.hpp"
+#include "checksum_trailer.hpp"
+#include "crc32c.hpp"
+#include "format.hpp"
+#include "index_trailer.hpp"
+#include "instrument.hpp"
+#include "parallel.hpp"
+#include "path_fold.hpp"
 
 namespace bigx {
 
+namespace {
+
+// Fast path of Reader::parseDirectory() for one record field width
+// Loads are unchecked within the bounds established per record by one length test and a memchr
+// (vectorized by the C library) for the name terminator; bad offsets and sizes only set a flag,
+// so no error formatting sits in the loop. Returns false on any problem, leaving entries partly
+// filled; pos is set to the end of the directory on success.
+template <size_t FieldSize>
+bool scanRecords(std::span<const uint8_t> data, uint32_t count, uint64_t archiveSize,
+                 std::vector<EntryView> &entries, size_t &pos) {
+  constexpr size_t head = 2 * FieldSize;
+  entries.resize(count);
+  const uint8_t *at = data.data() + ArchiveHeader::headerSize;
+  const uint8_t *end = data.data() + data.size();
+  unsigned bad = 0;
+  for (EntryView &entry : entries) {
+    if (static_cast<size_t>(end - at) <= head) {
+      return false;
+    }
+    entry.offset = detail::loadField<FieldSize>(at);
+    entry.size = detail::loadField<FieldSize>(at + FieldSize);
+    bad |= static_cast<unsigned>(entry.offset > archiveSize) |
+           static_cast<unsigned>(entry.size > archiveSize - entry.offset);
+
+    const char *name = reinterpret_cast<const char *>(at + head);
+    const void *terminator = std::memchr(name, '\0', static_cast<size_t>(end - at) - head);
+    if (!terminator) {
+      return false;
+    }
+    size_t length = static_cast<size_t>(static_cast<const char *>(terminator) - name);
+    entry.path = std::string_view(name, length);
+    at += head + length + 1;
+  }
+  pos = static_cast<size_t>(at - data.data());
+  return bad == 0;
+}
+
+// Decode a RefPack payload, or return std::nullopt if it is extracted as stored
+// A raw file may happen to begin with a RefPack header. Its bytes then fail to decode to the
+// declared size, and it is extracted as stored rather than reported as corrupt.
+std::optional<std::vector<uint8_t>> decodePayload(std::span<const uint8_t> payload) {
+  if (!refpack::isCompressed(payload)) {
+    return std::nullopt;
+  }
+  return refpack::decompress(payload);
+}
+
+} // namespace
+
 std::optional<Reader> Reader::open(const std::filesystem::path &path, std::string *outError) {
-  Reader reader;
-  if (!reader.mappedFile_.openRead(path, outError)) {
+  return open(path, OpenOptions{}, outError);
+}
+
+std::optional<Reader> Reader::open(const std::filesystem::path &path, const OpenOptions &options,
+                                   std::string *outError) {
+  return openWith(options, outError, [&path](Reader &reader, std::string *error) {
+    if (!reader.mappedFile_.openRead(path, error)) {
+      return false;
+    }
+    reader.data_ = reader.mappedFile_.data();
+    reader.archiveSize_ = reader.data_.size();
+    return true;
+  });
+}
+
+std::optional<Reader> Reader::openFromMemory(std::span<const uint8_t> data,
+                                             std::string *outError) {
+  return openFromMemory(data, OpenOptions{}, outError);
+}
+
+std::optional<Reader> Reader::openFromMemory(std::span<const uint8_t> data,
+                                             const OpenOptions &options, std::string *outError) {
+  return openWith(options, outError, [data](Reader &reader, std::string *) {
+    reader.data_ = data;
+    reader.archiveSize_ = data.size();
+    return true;
+  });
+}
+
+std::optional<Reader> Reader::openFromSource(std::shared_ptr<const ByteSource> source,
+                                             std::string *outError) {
+  return openFromSource(std::move(source), OpenOptions{}, outError);
+}
+
+std::optional<Reader> Reader::openFromSource(std::shared_ptr<const ByteSource> source,
+                                             const OpenOptions &options, std::string *outError) {
+  if (!source) {
+    if (outError) {
+      *outError = "No byte source given";
+    }
     return std::nullopt;
   }
+  return openWith(options, outError, [&source](Reader &reader, std::string *error) {
+    reader.source_ = std::move(source);
+    return reader.loadFromSource(error);
+  });
+}
+
+std::optional<Reader> Reader::openWith(const OpenOptions &options, std::string *outError,
+                                       const std::function<bool(Reader &, std::string *)> &load) {
+  Reader reader;
+  if constexpr (statsEnabled) {
+    reader.stats_ = std::make_unique<detail::ReaderCounters>();
+    reader.stats_->onPhase = options.onPhase;
+  }
+  detail::ScopeClock openClock(reader.stats_ ? &reader.stats_->openNanos : nullptr);
+
+  {
+    detail::PhaseTimer timer(reader.phaseCallback(), Phase::Map);
+    if (!load(reader, outError)) {
+      return std::nullopt;
+    }
+  }
 
-  if (!reader.parse(outError)) {
+  reader.decompress_ = options.decompress;
+  reader.trace_ = options.trace;
+  if (options.access != AccessPattern::Normal) {
+    reader.advise(options.access);
+  }
+
+  bool headerOk = false;
+  {
+    detail::PhaseTimer timer(reader.phaseCallback(), Phase::ParseHeader);
+    headerOk = reader.parseHeader(outError);
+  }
+  if (!headerOk) {
     reader.close();
     return std::nullopt;
   }
 
+  // A source-backed reader holds only the directory, not the trailer at the end of the file;
+  // the phase is only reported for archives that end in a trailer footer
+  if (options.indexTrailer && !reader.source_ && detail::indexTrailerExtent(reader.data_) > 0) {
+    detail::PhaseTimer timer(reader.phaseCallback(), Phase::LoadIndex);
+    const size_t recordHead = 2 * detail::layoutOf(reader.format_).fieldSize;
+    reader.trailerRecords_ = detail::loadIndexTrailer(reader.data_, reader.directoryCount_,
+                                                      recordHead, reader.trailerIndex_);
+  }
+
+  if (options.index != IndexMode::Lazy) {
+    bool parsed = false;
+    std::call_once(reader.lazy_->indexOnce,
+                   [&]() { parsed = reader.parseDirectory(outError); });
+    if (!parsed) {
+      reader.close();
+      return std::nullopt;
+    }
+  }
+
+  if (options.index == IndexMode::Standard) {
+    reader.files();
+  }
+
   return reader;
 }
 
-bool Reader::parse(std::string *outError) {
-  auto fileData = mappedFile_.data();
+bool Reader::loadFromSource(std::string *outError) {
+  archiveSize_ = source_->size();
+  const size_t total = static_cast<size_t>(std::min<uint64_t>(archiveSize_, SIZE_MAX));
+
+  // Every record so far fits in data; false means more bytes are needed
+  auto directoryComplete = [](std::span<const uint8_t> data) {
+    if (data.size() < ArchiveHeader::headerSize) {
+      return false;
+    }
+    auto format = detail::formatFromMagic(data.data());
+    if (!format) {
+      return true; // parseHeader() reports it
+    }
+    const detail::FormatLayout &layout = detail::layoutOf(*format);
+    auto count = detail::loadField(data.data() + layout.fileCountOffset, 4);
+    size_t pos = ArchiveHeader::headerSize;
+    for (uint64_t i = 0; i < count; ++i) {
+      pos += 2 * layout.fieldSize;
+      if (pos >= data.size()) {
+        return false;
+      }
+      const void *terminator = std::memchr(data.data() + pos, '\0', data.size() - pos);
+      if (!terminator) {
+        return false;
+      }
+      pos = static_cast<size_t>(static_cast<const uint8_t *>(terminator) - data.data()) + 1;
+    }
+    return true;
+  };
+
+  // Fetch a first block, then double it until it holds the whole directory
+  size_t have = 0;
+  size_t want = std::min<size_t>(total, 64 * 1024);
+  while (true) {
+    sourceBytes_.resize(want);
+    if (!source_->read(have, std::span<uint8_t>(sourceBytes_).subspan(have), outError)) {
+      return false;
+    }
+    have = want;
+    if (have == total || directoryComplete(sourceBytes_)) {
+      break;
+    }
+    want = total - have > have ? 2 * have : total;
+  }
+  data_ = sourceBytes_;
+  return true;
+}
+
+bool Reader::parseHeader(std::string *outError) {
+  auto fileData = data_;
 
   // Check minimum size (header is 16 bytes)
   if (fileData.size() < ArchiveHeader::headerSize) {
@@ -35,21 +238,19 @@ bool Reader::parse(std::string *outError) {
     return false;
   }
 
-  // Verify magic number
-  const char *magic = reinterpret_cast<const char *>(fileData.data());
-  if (std::memcmp(magic, "BIGF", 4) != 0) {
+  // Identify the format from its magic number
+  auto format = detail::formatFromMagic(fileData.data());
+  if (!format) {
     if (outError) {
-      *outError = std::format("Invalid BIG file magic (expected 'BIGF', got '{:.4s}')", magic);
+      *outError = std::format("Invalid BIG file magic (expected 'BIGF', 'BIG4' or 'BIGX', got "
+                              "'{:.4s}')",
+                              reinterpret_cast<const char *>(fileData.data()));
     }
     return false;
   }
-
-  // Read header
-  ArchiveHeader header;
-  std::memcpy(&header, fileData.data(), ArchiveHeader::headerSize);
-
-  // Convert from big-endian
-  uint32_t fileCount = betoh32(header.fileCount);
+  const detail::FormatLayout &layout = detail::layoutOf(*format);
+  auto fileCount = static_cast<uint32_t>(
+      detail::loadField(fileData.data() + layout.fileCountOffset, 4));
 
   // Validate file count (sanity check)
   if (fileCount > 1000000) { // Arbitrary large number to detect corruption
@@ -59,120 +260,487 @@ bool Reader::parse(std::string *outError) {
     return false;
   }
 
+  // Every directory record needs at least its offset, size and terminator
+  if (ArchiveHeader::headerSize + static_cast<uint64_t>(fileCount) * layout.minRecordSize() >
+      archiveSize_) {
+    if (outError) {
+      *outError = std::format("Directory of {} entries extends beyond file bounds", fileCount);
+    }
+    return false;
+  }
+
+  format_ = *format;
+  directoryCount_ = fileCount;
+  return true;
+}
+
+bool Reader::parseDirectory(std::string *outError) const {
+  auto fileData = data_;
+  uint32_t fileCount = directoryCount_;
+
   // Parse file entries starting at offset 0x10
+  // Paths initially point into the mapping; they are copied into names_ once the total size is
+  // known, so the name arena is a single allocation.
+  std::optional<detail::PhaseTimer> timer(std::in_place, phaseCallback(), Phase::ParseDirectory);
   size_t pos = ArchiveHeader::headerSize;
-  files_.reserve(fileCount);
+  size_t namesSize = 0;
+  entries_.reserve(fileCount);
 
-  for (uint32_t i = 0; i < fileCount; ++i) {
-    // Check if we have enough data for offset (4) + size (4)
-    if (pos + 8 > fileData.size()) {
-      if (outError) {
-        *outError = std::format("File entry {} extends beyond file bounds", i);
+  // Take the fast path first; on any problem the checked loop reruns and reports the error
+  const size_t fieldSize = detail::layoutOf(format_).fieldSize;
+  bool scanned = fieldSize == 8 ? scanRecords<8>(fileData, fileCount, archiveSize_, entries_, pos)
+                                : scanRecords<4>(fileData, fileCount, archiveSize_, entries_, pos);
+  if (!scanned) {
+    entries_.clear();
+    pos = ArchiveHeader::headerSize;
+    for (uint32_t i = 0; i < fileCount; ++i) {
+      // Check if we have enough data for offset + size
+      if (pos + 2 * fieldSize > fileData.size()) {
+        if (outError) {
+          *outError = std::format("File entry {} extends beyond file bounds", i);
+        }
+        return false;
       }
-      return false;
-    }
-
-    // Read offset and size (big-endian)
-    uint32_t offset, size;
-    std::memcpy(&offset, fileData.data() + pos, 4);
-    std::memcpy(&size, fileData.data() + pos + 4, 4);
-    pos += 8;
 
-    offset = betoh32(offset);
-    size = betoh32(size);
+      // Read offset and size (big-endian)
+      uint64_t offset = detail::loadField(fileData.data() + pos, fieldSize);
+      uint64_t size = detail::loadField(fileData.data() + pos + fieldSize, fieldSize);
+      pos += 2 * fieldSize;
 
-    // Validate offset and size (cast to size_t to prevent uint32_t overflow)
-    if (static_cast<size_t>(offset) + static_cast<size_t>(size) > fileData.size()) {
-      if (outError) {
-        *outError =
-            std::format("File entry {} has invalid offset/size (offset={}, size={}, fileSize={})",
-                        i, offset, size, fileData.size());
+      // Validate offset and size (without overflowing 64-bit fields)
+      if (!detail::rangeFits(offset, size, archiveSize_)) {
+        if (outError) {
+          *outError = std::format(
+              "File entry {} has invalid offset/size (offset={}, size={}, fileSize={})", i,
+              offset, size, archiveSize_);
+        }
+        return false;
       }
-      return false;
-    }
 
-    // Read null-terminated path string
-    const char *pathStart = reinterpret_cast<const char *>(fileData.data() + pos);
-    size_t pathLen = 0;
-    while (pos + pathLen < fileData.size() && pathStart[pathLen] != '\0') {
-      ++pathLen;
-    }
+      // Read null-terminated path string
+      const char *pathStart = reinterpret_cast<const char *>(fileData.data() + pos);
+      size_t pathLen = 0;
+      while (pos + pathLen < fileData.size() && pathStart[pathLen] != '\0') {
+        ++pathLen;
+      }
 
-    if (pos + pathLen >= fileData.size()) {
-      if (outError) {
-        *outError = std::format("File entry {} has unterminated path string", i);
+      if (pos + pathLen >= fileData.size()) {
+        if (outError) {
+          *outError = std::format("File entry {} has unterminated path string", i);
+        }
+        return false;
       }
-      return false;
+
+      pos += pathLen + 1; // +1 for null terminator
+
+      entries_.push_back(EntryView{std::string_view(pathStart, pathLen), offset, size});
     }
+  }
+  directoryEnd_ = pos;
+  for (const auto &entry : entries_) {
+    namesSize += entry.path.size();
+  }
 
-    std::string path(pathStart, pathLen);
-    pos += pathLen + 1; // +1 for null terminator
+  // Copy names into the arena, normalizing slashes (original case preserved)
+  names_.resize(namesSize);
+  char *out = names_.data();
+  for (auto &entry : entries_) {
+    detail::foldSlashes(entry.path.data(), entry.path.size(), out);
+    entry.path = std::string_view(out, entry.path.size());
+    out += entry.path.size();
+  }
 
-    // Create file entry
-    FileEntry entry;
-    entry.path = normalizeSlashes(path);
-    entry.lowercasePath = normalizePath(path);
-    entry.offset = offset;
-    entry.size = size;
+  // Take the table from an adopted trailer, whose checksum vouches for the directory
+  if (!trailerRecords_.empty()) {
+    index_ = trailerIndex_;
+    return true;
+  }
 
-    files_.push_back(std::move(entry));
+  // Build lookup table (also detects duplicate paths)
+  timer.emplace(phaseCallback(), Phase::BuildIndex);
+  size_t duplicate = 0;
+  if (!index_.build(entries_, &duplicate)) {
+    if (outError) {
+      *outError = std::format("Duplicate file path in archive: {}", entries_[duplicate].path);
+    }
+    return false;
   }
 
-  // Build lookup table
-  lookup_.reserve(files_.size());
-  for (size_t i = 0; i < files_.size(); ++i) {
-    const auto &entry = files_[i];
+  return true;
+}
 
-    // Check for duplicate paths
-    if (lookup_.contains(entry.lowercasePath)) {
-      if (outError) {
-        *outError = std::format("Duplicate file path in archive: {}", entry.path);
-      }
-      return false;
+void Reader::ensureIndexed() const {
+  if (!lazy_) {
+    return; // Moved-from reader
+  }
+
+  std::call_once(lazy_->indexOnce, [this]() {
+    if (!parseDirectory(&lazy_->indexError)) {
+      names_.clear();
+      entries_.clear();
+      index_.clear();
     }
+  });
+}
 
-    lookup_[entry.lowercasePath] = i;
+const std::vector<FileEntry> &Reader::files() const {
+  ensureIndexed();
+  if (!lazy_) {
+    return files_;
   }
 
-  return true;
+  std::call_once(lazy_->filesOnce, [this]() {
+    detail::PhaseTimer timer(phaseCallback(), Phase::BuildFileEntries);
+    files_.reserve(entries_.size());
+    for (const auto &view : entries_) {
+      FileEntry entry;
+      entry.path = std::string(view.path);
+      entry.lowercasePath = detail::foldedPath(entry.path);
+      entry.offset = view.offset;
+      entry.size = view.size;
+      files_.push_back(std::move(entry));
+    }
+  });
+  return files_;
+}
+
+const DirectoryTree &Reader::tree() const {
+  ensureIndexed();
+  if (!lazy_) {
+    return tree_;
+  }
+
+  std::call_once(lazy_->treeOnce, [this]() {
+    detail::PhaseTimer timer(phaseCallback(), Phase::BuildTree);
+    tree_.build(entries_);
+  });
+  return tree_;
+}
+
+std::optional<DirectoryListing> Reader::listDirectory(std::string_view directory) const {
+  return tree().list(directory);
+}
+
+std::vector<const EntryView *> Reader::glob(std::string_view pattern) const {
+  return tree().glob(pattern);
+}
+
+std::span<const EntryView> Reader::entries() const {
+  ensureIndexed();
+  return entries_;
+}
+
+size_t Reader::fileCount() const {
+  ensureIndexed();
+  return entries_.size();
+}
+
+const FileEntry *Reader::findFile(std::string_view path) const {
+  ensureIndexed();
+  auto index = index_.find(entries_, path);
+  if (!index) {
+    BIGX_COUNT(stats_, lookupMisses, 1);
+    return nullptr;
+  }
+  BIGX_COUNT(stats_, lookupHits, 1);
+  traceAccess(TraceOp::Find, entries_[*index].path);
+  return &files()[*index];
 }
 
-const FileEntry *Reader::findFile(const std::string &path) const {
-  std::string normalized = normalizePath(path);
-  auto it = lookup_.find(normalized);
-  if (it == lookup_.end()) {
+const EntryView *Reader::findEntry(std::string_view path) const {
+  ensureIndexed();
+  auto index = index_.find(entries_, path);
+  if (!index) {
+    BIGX_COUNT(stats_, lookupMisses, 1);
     return nullptr;
   }
-  return &files_[it->second];
+  BIGX_COUNT(stats_, lookupHits, 1);
+  traceAccess(TraceOp::Find, entries_[*index].path);
+  return &entries_[*index];
+}
+
+std::optional<EntryView> Reader::scanFor(std::string_view path) const {
+  auto fileData = data_;
+  const char *base = reinterpret_cast<const char *>(fileData.data());
+  const size_t recordHead = 2 * detail::layoutOf(format_).fieldSize; // Offset + size
+
+  // Name of the record at pos, or nullopt if it runs past the end of the file
+  auto nameAt = [&](size_t pos) -> std::optional<std::string_view> {
+    if (pos + recordHead > fileData.size()) {
+      return std::nullopt;
+    }
+    const char *pathStart = base + pos + recordHead;
+    const void *terminator = std::memchr(pathStart, '\0', fileData.size() - pos - recordHead);
+    if (!terminator) {
+      return std::nullopt;
+    }
+    return std::string_view(pathStart, static_cast<const char *>(terminator) - pathStart);
+  };
+
+  // Decode the offset and size of the matching record at pos
+  auto decode = [&](size_t pos, std::string_view name) -> std::optional<EntryView> {
+    const size_t fieldSize = recordHead / 2;
+    const auto *record = fileData.data() + pos;
+    EntryView entry{name, detail::loadField(record, fieldSize),
+                    detail::loadField(record + fieldSize, fieldSize)};
+    if (!detail::rangeFits(entry.offset, entry.size, fileData.size())) {
+      return std::nullopt;
+    }
+    return entry;
+  };
+
+  // An adopted trailer turns the scan into a probe of its table
+  if (!trailerRecords_.empty()) {
+    auto recordName = [&](uint32_t i) {
+      return nameAt(detail::trailerRecord(trailerRecords_, i)).value_or(std::string_view());
+    };
+    auto index = trailerIndex_.find(path, recordName);
+    if (!index) {
+      return std::nullopt;
+    }
+    size_t pos = detail::trailerRecord(trailerRecords_, *index);
+    auto name = nameAt(pos);
+    return name ? decode(pos, *name) : std::nullopt;
+  }
+
+  size_t pos = ArchiveHeader::headerSize;
+  for (uint32_t i = 0; i < directoryCount_; ++i) {
+    // Find the terminator first so a miss never decodes offset/size
+    auto name = nameAt(pos);
+    if (!name) {
+      return std::nullopt;
+    }
+    if (detail::pathEquals(*name, path)) {
+      return decode(pos, *name);
+    }
+    pos += recordHead + name->size() + 1;
+  }
+
+  return std::nullopt;
+}
+
+const std::string &Reader::indexError() const {
+  static const std::string none;
+  return lazy_ ? lazy_->indexError : none;
 }
 
 bool Reader::extract(const FileEntry &entry, const std::filesystem::path &destPath,
                      std::string *outError) const {
-  auto archiveData = mappedFile_.data();
-
-  // Validate bounds
-  if (static_cast<size_t>(entry.offset) + static_cast<size_t>(entry.size) > archiveData.size()) {
+  // Validate bounds before touching the filesystem
+  if (!inBounds(entry)) {
     if (outError) {
       *outError = std::format("Invalid file bounds for: {}", entry.path);
     }
     return false;
   }
+  traceAccess(TraceOp::Extract, entry.path);
 
   // Create parent directories if needed
   std::filesystem::create_directories(destPath.parent_path());
 
+  return writeFile(entry, destPath, outError);
+}
+
+ExtractResult Reader::extractAll(const std::filesystem::path &destDir,
+                                 const ExtractOptions &options) const {
+  std::vector<const FileEntry *> entries;
+  entries.reserve(fileCount());
+  for (const auto &entry : files()) {
+    entries.push_back(&entry);
+  }
+  return extractAll(destDir, entries, options);
+}
+
+ExtractResult Reader::extractAll(const std::filesystem::path &destDir,
+                                 const std::function<bool(const FileEntry &)> &predicate,
+                                 const ExtractOptions &options) const {
+  std::vector<const FileEntry *> entries;
+  for (const auto &entry : files()) {
+    if (predicate(entry)) {
+      entries.push_back(&entry);
+    }
+  }
+  return extractAll(destDir, entries, options);
+}
+
+ExtractResult Reader::extractAll(const std::filesystem::path &destDir,
+                                 std::span<const FileEntry *const> entries,
+                                 const ExtractOptions &options) const {
+  ExtractResult result;
+
+  // Resolve destination paths and reject entries that would escape destDir
+  std::vector<std::filesystem::path> destPaths(entries.size());
+  std::vector<std::string> errors(entries.size());
+  std::unordered_set<std::string> directories;
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    const FileEntry &entry = *entries[i];
+    if (!isSafeRelativePath(entry.path)) {
+      errors[i] = std::format("Refusing to extract unsafe path: {}", entry.path);
+      continue;
+    }
+    destPaths[i] = destDir / entry.path;
+    directories.insert(destPaths[i].parent_path().string());
+  }
+
+  // Create the directory tree once instead of once per file
+  std::vector<std::string> sortedDirectories(directories.begin(), directories.end());
+  std::sort(sortedDirectories.begin(), sortedDirectories.end());
+  for (const auto &dir : sortedDirectories) {
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+  }
+
+  // Write payloads in parallel; each worker only touches its own slot in errors
+  size_t bytesWritten = 0;
+  // The batched writer queues views of the payloads, which a source-backed reader does not hold
+  if (options.backend == ExtractBackend::Batched && !source_ &&
+      detail::batchFileWriterAvailable()) {
+    bytesWritten = writeFilesBatched(entries, destPaths, errors, options.threads);
+  } else {
+    std::atomic<size_t> total{0};
+    detail::parallelFor(entries.size(), options.threads, [&](size_t i) {
+      if (!errors[i].empty()) {
+        return;
+      }
+      size_t written = 0;
+      if (writeFile(*entries[i], destPaths[i], &errors[i], &written)) {
+        total.fetch_add(written, std::memory_order_relaxed);
+      } else if (errors[i].empty()) {
+        errors[i] = std::format("Failed to extract: {}", entries[i]->path);
+      }
+    });
+    bytesWritten = total.load();
+  }
+
+  for (size_t i = 0; i < entries.size(); ++i) {
+    if (errors[i].empty()) {
+      ++result.extracted;
+    } else {
+      result.failures.push_back({entries[i], std::move(errors[i])});
+    }
+  }
+  result.bytesWritten = bytesWritten;
+  return result;
+}
+
+bool Reader::batchedExtractSupported() {
+  return detail::batchFileWriterAvailable();
+}
+
+size_t Reader::writeFilesBatched(std::span<const FileEntry *const> entries,
+                                 std::span<const std::filesystem::path> destPaths,
+                                 std::span<std::string> errors, unsigned threads) const {
+  // Each worker drives its own ring over a contiguous share of the entries
+  constexpr size_t minShare = 64;
+  unsigned workers =
+      detail::resolveThreadCount(threads, (entries.size() + minShare - 1) / minShare);
+  size_t share = (entries.size() + workers - 1) / workers;
+  std::atomic<size_t> bytesWritten{0};
+
+  detail::parallelFor(workers, workers, [&](size_t worker) {
+    size_t begin = worker * share;
+    size_t end = std::min(entries.size(), begin + share);
+    auto writer = detail::BatchFileWriter::create();
+
+    std::vector<detail::FileWriteJob> jobs;
+    std::vector<size_t> slots;
+    std::vector<std::vector<uint8_t>> decoded; // Keeps decoded payloads alive for the batch
+    std::vector<std::string> jobErrors;
+    size_t batch = writer ? writer->batchSize() : share;
+
+    for (size_t start = begin; start < end; start += batch) {
+      size_t stop = std::min(end, start + batch);
+      jobs.clear();
+      slots.clear();
+      decoded.clear();
+
+      for (size_t i = start; i < stop; ++i) {
+        if (!errors[i].empty()) {
+          continue;
+        }
+        const FileEntry &entry = *entries[i];
+        if (!writer) {
+          // The ring could not be set up on this thread; use the portable path
+          size_t written = 0;
+          if (writeFile(entry, destPaths[i], &errors[i], &written)) {
+            bytesWritten.fetch_add(written, std::memory_order_relaxed);
+          } else if (errors[i].empty()) {
+            errors[i] = std::format("Failed to extract: {}", entry.path);
+          }
+          continue;
+        }
+        if (!inBounds(entry)) {
+          errors[i] = std::format("Invalid file bounds for: {}", entry.path);
+          continue;
+        }
+        std::span<const uint8_t> payload = viewOf(entry);
+        if (auto result = decompress_ ? decodePayload(payload) : std::nullopt) {
+          decoded.push_back(std::move(*result)); // Moving keeps the buffer address
+          payload = decoded.back();
+        }
+        jobs.push_back({&destPaths[i], payload});
+        slots.push_back(i);
+      }
+
+      if (jobs.empty()) {
+        continue;
+      }
+      jobErrors.assign(jobs.size(), std::string());
+      writer->writeAll(jobs, jobErrors);
+      for (size_t k = 0; k < jobs.size(); ++k) {
+        if (jobErrors[k].empty()) {
+          bytesWritten.fetch_add(jobs[k].data.size(), std::memory_order_relaxed);
+          BIGX_COUNT(stats_, filesExtracted, 1);
+          BIGX_COUNT(stats_, bytesExtracted, jobs[k].data.size());
+        } else {
+          BIGX_COUNT(stats_, ioErrors, 1);
+          errors[slots[k]] = std::move(jobErrors[k]);
+        }
+      }
+    }
+  });
+
+  return bytesWritten.load();
+}
+
+bool Reader::writeFile(const FileEntry &entry, const std::filesystem::path &destPath,
+                       std::string *outError, size_t *outWritten) const {
+  // Validate bounds
+  if (!inBounds(entry)) {
+    if (outError) {
+      *outError = std::format("Invalid file bounds for: {}", entry.path);
+    }
+    return false;
+  }
+
+  std::vector<uint8_t> fetched;
+  auto stored = payloadOf(entry, fetched, outError);
+  if (!stored) {
+    return false;
+  }
+  std::span<const uint8_t> payload = *stored;
+  std::vector<uint8_t> decoded;
+  if (auto result = decompress_ ? decodePayload(payload) : std::nullopt) {
+    decoded = std::move(*result);
+    payload = decoded;
+  }
+
   // Write file (handles zero-size files correctly)
   std::ofstream out(destPath, std::ios::binary);
   if (!out) {
+    BIGX_COUNT(stats_, ioErrors, 1);
     if (outError) {
       *outError = std::format("Failed to create output file: {}", destPath.string());
     }
     return false;
   }
 
-  if (entry.size > 0) {
-    out.write(reinterpret_cast<const char *>(archiveData.data() + entry.offset), entry.size);
+  if (!payload.empty()) {
+    out.write(reinterpret_cast<const char *>(payload.data()),
+              static_cast<std::streamsize>(payload.size()));
     if (!out) {
+      BIGX_COUNT(stats_, ioErrors, 1);
       if (outError) {
         *outError = std::format("Failed to write to output file: {}", destPath.string());
       }
@@ -180,79 +748,383 @@ bool Reader::extract(const FileEntry &entry, const std::filesystem::path &destPa
     }
   }
 
+  BIGX_COUNT(stats_, filesExtracted, 1);
+  BIGX_COUNT(stats_, bytesExtracted, payload.size());
+  if (outWritten) {
+    *outWritten = payload.size();
+  }
   return true;
 }
 
+template <typename Buffer>
+std::optional<Buffer> Reader::materialize(const FileEntry &entry, Buffer buffer,
+                                          std::string *outError) const {
+  if (!inBounds(entry)) {
+    if (outError) {
+      *outError = std::format("Invalid file bounds for: {}", entry.path);
+    }
+    return std::nullopt;
+  }
+  traceAccess(TraceOp::Extract, entry.path);
+
+  std::vector<uint8_t> fetched;
+  auto stored = payloadOf(entry, fetched, outError);
+  if (!stored) {
+    return std::nullopt;
+  }
+  std::span<const uint8_t> payload = *stored;
+  bool decoded = false;
+  if (decompress_ && refpack::isCompressed(payload)) {
+    // Decode straight into a buffer pre-sized from the RefPack header
+    buffer.resize(*refpack::uncompressedSize(payload));
+    decoded = refpack::decompress(payload, buffer);
+  }
+  if (!decoded) {
+    // Copy-construct the bytes; resize() would zero-fill them first (see decodePayload())
+    buffer.assign(payload.begin(), payload.end());
+  }
+
+  BIGX_COUNT(stats_, filesExtracted, 1);
+  BIGX_COUNT(stats_, bytesExtracted, buffer.size());
+  return buffer;
+}
+
 std::optional<std::vector<uint8_t>> Reader::extractToMemory(const FileEntry &entry,
                                                             std::string *outError) const {
-  auto archiveData = mappedFile_.data();
+  return materialize(entry, std::vector<uint8_t>(), outError);
+}
 
-  // Validate bounds
-  if (static_cast<size_t>(entry.offset) + static_cast<size_t>(entry.size) > archiveData.size()) {
+std::optional<std::pmr::vector<uint8_t>>
+Reader::extractToMemory(const FileEntry &entry, std::pmr::memory_resource &resource,
+                        std::string *outError) const {
+  return materialize(entry, std::pmr::vector<uint8_t>(&resource), outError);
+}
+
+std::optional<size_t> Reader::extractTo(const FileEntry &entry, std::span<uint8_t> out,
+                                        std::string *outError) const {
+  if (!inBounds(entry)) {
     if (outError) {
       *outError = std::format("Invalid file bounds for: {}", entry.path);
     }
     return std::nullopt;
   }
+  traceAccess(TraceOp::Extract, entry.path);
+
+  std::vector<uint8_t> fetched;
+  auto stored = payloadOf(entry, fetched, outError);
+  if (!stored) {
+    return std::nullopt;
+  }
+  std::span<const uint8_t> payload = *stored;
+  bool decode = decompress_ && refpack::isCompressed(payload);
+  size_t size = decode ? *refpack::uncompressedSize(payload) : payload.size();
+  if (out.size() < size) {
+    if (outError) {
+      *outError = std::format("Buffer too small for {} (need {}, have {})", entry.path, size,
+                              out.size());
+    }
+    return std::nullopt;
+  }
+
+  if (!decode || !refpack::decompress(payload, out.first(size))) {
+    // Stored raw, or only looks like RefPack (see decodePayload())
+    size = payload.size();
+    if (out.size() < size) {
+      if (outError) {
+        *outError = std::format("Buffer too small for {} (need {}, have {})", entry.path, size,
+                                out.size());
+      }
+      return std::nullopt;
+    }
+    if (size > 0) {
+      std::memcpy(out.data(), payload.data(), size);
+    }
+  }
+
+  BIGX_COUNT(stats_, filesExtracted, 1);
+  BIGX_COUNT(stats_, bytesExtracted, size);
+  return size;
+}
+
+size_t Reader::extractedSize(const FileEntry &entry) const {
+  if (!inBounds(entry)) {
+    return 0;
+  }
+  if (decompress_) {
+    std::array<uint8_t, 16> scratch;
+    return refpack::uncompressedSize(headOf(entry, scratch), static_cast<size_t>(entry.size))
+        .value_or(entry.size);
+  }
+  return static_cast<size_t>(entry.size);
+}
+
+std::future<ExtractedFile> Reader::extractAsync(const FileEntry &entry,
+                                                Executor *executor) const {
+  // std::function needs a copyable task, so the promise is shared
+  auto promise = std::make_shared<std::promise<ExtractedFile>>();
+  std::future<ExtractedFile> future = promise->get_future();
+  Executor &target = executor ? *executor : defaultExecutor();
+  target.submit([this, &entry, promise]() { promise->set_value(extractEntry(entry)); });
+  return future;
+}
+
+void Reader::extractAsync(const FileEntry &entry, ExtractCallback onComplete,
+                          Executor *executor) const {
+  Executor &target = executor ? *executor : defaultExecutor();
+  target.submit([this, &entry, onComplete = std::move(onComplete)]() {
+    onComplete(extractEntry(entry));
+  });
+}
+
+void Reader::extractAsync(std::span<const FileEntry *const> entries, ExtractCallback onComplete,
+                          Executor *executor) const {
+  Executor &target = executor ? *executor : defaultExecutor();
+  auto callback = std::make_shared<const ExtractCallback>(std::move(onComplete));
+  for (const FileEntry *entry : entries) {
+    target.submit([this, entry, callback]() { (*callback)(extractEntry(*entry)); });
+  }
+}
+
+ExtractedFile Reader::extractEntry(const FileEntry &entry) const {
+  ExtractedFile result;
+  result.entry = &entry;
+  result.data = extractToMemory(entry, &result.error);
+  return result;
+}
+
+VerifyResult Reader::verify(const VerifyOptions &options) const {
+  VerifyResult result;
+  if (!isOpen()) {
+    result.error = "Archive is not open";
+    return result;
+  }
+  ensureIndexed();
+  if (!indexError().empty()) {
+    result.error = indexError();
+    return result;
+  }
+
+  // One sweep over the payloads sorted by range finds entries reaching into the header or
+  // directory and partial overlaps; identical ranges are shared (deduplicated) payloads
+  std::vector<std::string> errors(entries_.size());
+  std::vector<uint32_t> byOffset;
+  byOffset.reserve(entries_.size());
+  for (uint32_t i = 0; i < entries_.size(); ++i) {
+    if (entries_[i].size == 0) {
+      continue;
+    }
+    if (entries_[i].offset < directoryEnd_) {
+      errors[i] = "Payload overlaps the archive header or directory";
+    } else {
+      byOffset.push_back(i);
+    }
+  }
+  std::sort(byOffset.begin(), byOffset.end(), [this](uint32_t a, uint32_t b) {
+    return std::pair(entries_[a].offset, entries_[a].size) <
+           std::pair(entries_[b].offset, entries_[b].size);
+  });
+  uint64_t reach = 0; // End of the furthest-reaching range so far
+  uint32_t owner = 0; // Entry that range belongs to
+  for (uint32_t i : byOffset) {
+    const EntryView &entry = entries_[i];
+    const EntryView &last = entries_[owner];
+    if (entry.offset < reach && (entry.offset != last.offset || entry.size != last.size)) {
+      errors[i] = std::format("Payload overlaps {}", last.path);
+    }
+    if (entry.offset + entry.size > reach) {
+      reach = entry.offset + entry.size;
+      owner = i;
+    }
+  }
+
+  // Payload checksums are read straight off the mapping; a source-backed reader has no trailer
+  auto table = source_ ? std::span<const uint8_t>()
+                       : detail::loadChecksumTrailer(data_, directoryCount_, directoryEnd_);
+  if (!table.empty()) {
+    result.checksummed = true;
+    detail::parallelFor(entries_.size(), options.threads, [&](size_t i) {
+      if (errors[i].empty() &&
+          detail::crc32c(0, viewOf(entries_[i])) != detail::trailerChecksum(table, i)) {
+        errors[i] = "Checksum mismatch";
+      }
+    });
+    for (const EntryView &entry : entries_) {
+      result.bytesChecked += static_cast<size_t>(entry.size);
+    }
+  }
 
-  std::vector<uint8_t> result(entry.size);
-  if (entry.size > 0) {
-    std::memcpy(result.data(), archiveData.data() + entry.offset, entry.size);
+  result.checked = entries_.size();
+  for (size_t i = 0; i < errors.size(); ++i) {
+    if (errors[i].empty()) {
+      continue;
+    }
+    ++result.corrupt;
+    if (result.failures.size() < options.maxFailures) {
+      result.failures.push_back({&entries_[i], std::move(errors[i])});
+    }
   }
   return result;
 }
 
+bool Reader::hasChecksums() const {
+  if (!isOpen()) {
+    return false;
+  }
+  ensureIndexed();
+  return indexError().empty() && !source_ &&
+         !detail::loadChecksumTrailer(data_, directoryCount_, directoryEnd_).empty();
+}
+
+bool Reader::isCompressed(const FileEntry &entry) const {
+  std::array<uint8_t, 16> scratch;
+  return refpack::isCompressed(headOf(entry, scratch), static_cast<size_t>(entry.size));
+}
+
+size_t Reader::uncompressedSize(const FileEntry &entry) const {
+  std::array<uint8_t, 16> scratch;
+  return refpack::uncompressedSize(headOf(entry, scratch), static_cast<size_t>(entry.size))
+      .value_or(entry.size);
+}
+
 std::span<const uint8_t> Reader::getFileView(const FileEntry &entry) const {
-  auto archiveData = mappedFile_.data();
+  traceAccess(TraceOp::View, entry.path);
+  return viewOf(entry);
+}
 
-  // Validate bounds (cast to size_t to prevent uint32_t overflow)
-  if (static_cast<size_t>(entry.offset) + static_cast<size_t>(entry.size) > archiveData.size()) {
+std::span<const uint8_t> Reader::viewOf(const FileEntry &entry) const {
+  if (!detail::rangeFits(entry.offset, entry.size, data_.size())) {
     return {};
   }
+  return data_.subspan(static_cast<size_t>(entry.offset), static_cast<size_t>(entry.size));
+}
 
-  return std::span<const uint8_t>(archiveData.data() + entry.offset, entry.size);
+std::optional<std::span<const uint8_t>>
+Reader::payloadOf(const FileEntry &entry, std::vector<uint8_t> &scratch,
+                  std::string *outError) const {
+  if (!source_) {
+    return viewOf(entry);
+  }
+  scratch.resize(static_cast<size_t>(entry.size));
+  if (!scratch.empty() && !source_->read(entry.offset, scratch, outError)) {
+    BIGX_COUNT(stats_, ioErrors, 1);
+    return std::nullopt;
+  }
+  return std::span<const uint8_t>(scratch);
 }
 
-bool Reader::isOpen() const {
-  return mappedFile_.isOpen();
+std::span<const uint8_t> Reader::headOf(const FileEntry &entry,
+                                        std::array<uint8_t, 16> &scratch) const {
+  if (!source_) {
+    auto view = viewOf(entry);
+    return view.first(std::min(view.size(), scratch.size()));
+  }
+  size_t size = static_cast<size_t>(std::min<uint64_t>(entry.size, scratch.size()));
+  auto head = std::span<uint8_t>(scratch).first(size);
+  if (!inBounds(entry) || (size > 0 && !source_->read(entry.offset, head, nullptr))) {
+    return {};
+  }
+  return head;
 }
 
-void Reader::close() {
-  mappedFile_.close();
-  files_.clear();
-  lookup_.clear();
+std::span<const uint8_t> Reader::getFileView(const EntryView &entry) const {
+  traceAccess(TraceOp::View, entry.path);
+  return viewOf(entry);
 }
 
-std::string Reader::normalizeSlashes(const std::string &path) {
-  std::string result;
-  result.reserve(path.size());
+std::span<const uint8_t> Reader::viewOf(const EntryView &entry) const {
+  if (!detail::rangeFits(entry.offset, entry.size, data_.size())) {
+    return {};
+  }
+  return data_.subspan(static_cast<size_t>(entry.offset), static_cast<size_t>(entry.size));
+}
 
-  // Replace backslashes with forward slashes, preserving case
-  for (char c : path) {
-    if (c == '\\') {
-      result += '/';
-    } else {
-      result += c;
+bool Reader::inBounds(const FileEntry &entry) const {
+  // Offsets and sizes are 64-bit; the check must not overflow
+  return detail::rangeFits(entry.offset, entry.size, archiveSize_);
+}
+
+ArchiveFormat Reader::format() const {
+  return format_;
+}
+
+bool Reader::advise(AccessPattern pattern) const {
+  return mappedFile_.advise(pattern);
+}
+
+bool Reader::prefetch(const FileEntry &entry) const {
+  if (!inBounds(entry)) {
+    return false;
+  }
+  return entry.size == 0 || mappedFile_.prefetch(static_cast<size_t>(entry.offset),
+                                                 static_cast<size_t>(entry.size));
+}
+
+bool Reader::prefetch(std::span<const FileEntry *const> entries) const {
+  std::vector<MappedRange> ranges;
+  ranges.reserve(entries.size());
+  for (const FileEntry *entry : entries) {
+    if (!inBounds(*entry)) {
+      return false;
+    }
+    if (entry->size > 0) {
+      ranges.push_back({static_cast<size_t>(entry->offset), static_cast<size_t>(entry->size)});
     }
   }
+  return ranges.empty() || mappedFile_.prefetch(ranges);
+}
 
-  return result;
+bool Reader::prefetch(std::span<const MappedRange> ranges) const {
+  return ranges.empty() || mappedFile_.prefetch(ranges);
 }
 
-std::string Reader::normalizePath(const std::string &path) {
-  std::string result;
-  result.reserve(path.size());
+const PhaseCallback *Reader::phaseCallback() const {
+  return stats_ ? &stats_->onPhase : nullptr;
+}
 
-  // Convert to lowercase and replace backslashes with forward slashes
-  for (char c : path) {
-    if (c == '\\') {
-      result += '/';
-    } else {
-      result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-    }
+ReaderStats Reader::stats() const {
+  return stats_ ? stats_->snapshot() : ReaderStats{};
+}
+
+bool Reader::isOpen() const {
+  return archiveSize_ > 0;
+}
+
+void Reader::close() {
+  mappedFile_.close();
+  data_ = {};
+  archiveSize_ = 0;
+  source_.reset();
+  sourceBytes_ = {};
+  names_.clear();
+  entries_.clear();
+  index_.clear();
+  files_.clear();
+  tree_.clear();
+  trailerIndex_.clear();
+  trailerRecords_ = {};
+  trace_.reset();
+  format_ = ArchiveFormat::BigF;
+  directoryCount_ = 0;
+  directoryEnd_ = 0;
+  lazy_ = std::make_unique<LazyState>();
+}
+
+bool Reader::isSafeRelativePath(const std::string &path) {
+  if (path.empty()) {
+    return false;
   }
 
-  return result;
+  // Reject drive letters and any ".." component
+  std::filesystem::path relative(path);
+  if (relative.has_root_name() || relative.has_root_directory()) {
+    return false;
+  }
+  for (const auto &part : relative) {
+    if (part == "..") {
+      return false;
+    }
+  }
+  return true;
 }
 
 } // namespace bigx
@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <cstring>
+#include <format>
+
+#include <bigx/refpack.hpp>
+
+namespace bigx::refpack {
+
+namespace {
+
+constexpr uint8_t magicByte = 0xFB;
+constexpr uint8_t flagLargeSizes = 0x80;     // Sizes are 4 bytes instead of 3
+constexpr uint8_t flagCompressedSize = 0x01; // Compressed size precedes uncompressed size
+
+constexpr size_t maxDistance = 131072; // Longest back-reference (4-byte command)
+constexpr size_t maxMatch = 1028;      // Longest match (4-byte command)
+constexpr size_t maxLiteralRun = 112;  // Longest literal-only command
+constexpr size_t minMatch = 3;
+
+// Most output a stream byte can produce: a 4-byte command copies up to maxMatch bytes
+constexpr size_t maxExpansion = maxMatch / 4;
+
+struct Header {
+  size_t headerSize = 0;
+  size_t uncompressedSize = 0;
+};
+
+// streamSize is the length of the whole stream, of which data may hold only the first bytes
+// A declared size that streamSize bytes could never expand to is not a RefPack header, so
+// corrupt or raw payloads never size an output buffer beyond what the stream can fill.
+std::optional<Header> parseHeader(std::span<const uint8_t> data, size_t streamSize) noexcept {
+  if (data.size() < 2 || (data[0] & 0x3E) != 0x10 || data[1] != magicByte) {
+    return std::nullopt;
+  }
+
+  size_t sizeBytes = (data[0] & flagLargeSizes) ? 4 : 3;
+  size_t pos = 2 + ((data[0] & flagCompressedSize) ? sizeBytes : 0);
+  if (data.size() < pos + sizeBytes) {
+    return std::nullopt;
+  }
+
+  size_t size = 0;
+  for (size_t i = 0; i < sizeBytes; ++i) {
+    size = (size << 8) | data[pos + i];
+  }
+  size_t headerSize = pos + sizeBytes;
+  if (streamSize < headerSize || size > (streamSize - headerSize) * maxExpansion) {
+    return std::nullopt;
+  }
+  return Header{headerSize, size};
+}
+
+// Copy an overlapping back-reference
+// The already-written window is copied in blocks that double each step, so even short
+// periodic matches (e.g. runs of one byte) cost a handful of memcpy calls, not one per byte.
+inline void copyMatch(uint8_t *dst, size_t distance, size_t length) noexcept {
+  const uint8_t *from = dst - distance;
+  while (length > 0) {
+    size_t block = std::min(length, static_cast<size_t>(dst - from));
+    std::memcpy(dst, from, block);
+    dst += block;
+    length -= block;
+  }
+}
+
+// Emitter for the compressed command stream
+class Encoder {
+public:
+  explicit Encoder(std::vector<uint8_t> &out) : out_(out) {}
+
+  // Flush pending literals down to at most 3, which then ride along with the next command
+  void flushLiterals(const uint8_t *literals, size_t &count) {
+    while (count > 3) {
+      size_t run = std::min(maxLiteralRun, count & ~size_t{3});
+      out_.push_back(static_cast<uint8_t>(0xE0 | ((run - 4) >> 2)));
+      out_.insert(out_.end(), literals, literals + run);
+      literals += run;
+      count -= run;
+    }
+  }
+
+  // Emit a match with up to 3 leading literals
+  void match(const uint8_t *literals, size_t literalCount, size_t distance, size_t length) {
+    size_t d = distance - 1;
+    auto lit = static_cast<uint8_t>(literalCount);
+    if (length <= 10 && distance <= 1024) {
+      out_.push_back(static_cast<uint8_t>(((d >> 3) & 0x60) | ((length - 3) << 2) | lit));
+      out_.push_back(static_cast<uint8_t>(d));
+    } else if (length <= 67 && distance <= 16384) {
+      out_.push_back(static_cast<uint8_t>(0x80 | (length - 4)));
+      out_.push_back(static_cast<uint8_t>((lit << 6) | (d >> 8)));
+      out_.push_back(static_cast<uint8_t>(d));
+    } else {
+      size_t l = length - 5;
+      out_.push_back(static_cast<uint8_t>(0xC0 | ((d >> 12) & 0x10) | ((l >> 6) & 0x0C) | lit));
+      out_.push_back(static_cast<uint8_t>(d >> 8));
+      out_.push_back(static_cast<uint8_t>(d));
+      out_.push_back(static_cast<uint8_t>(l));
+    }
+    out_.insert(out_.end(), literals, literals + literalCount);
+  }
+
+  // Emit the end-of-stream command with up to 3 trailing literals
+  void finish(const uint8_t *literals, size_t literalCount) {
+    out_.push_back(static_cast<uint8_t>(0xFC | literalCount));
+    out_.insert(out_.end(), literals, literals + literalCount);
+  }
+
+private:
+  std::vector<uint8_t> &out_;
+};
+
+// Check that a match can be encoded by one of the three match commands
+inline bool encodable(size_t distance, size_t length) noexcept {
+  if (length >= 5) {
+    return distance <= maxDistance;
+  }
+  if (length == 4) {
+    return distance <= 16384;
+  }
+  return length == 3 && distance <= 1024;
+}
+
+inline uint32_t hash3(const uint8_t *p) noexcept {
+  uint32_t v = (uint32_t{p[0]} << 16) | (uint32_t{p[1]} << 8) | p[2];
+  return (v * 2654435761u) >> 16; // 16-bit bucket
+}
+
+} // namespace
+
+bool isCompressed(std::span<const uint8_t> data) noexcept {
+  return isCompressed(data, data.size());
+}
+
+bool isCompressed(std::span<const uint8_t> head, size_t streamSize) noexcept {
+  return parseHeader(head, streamSize).has_value();
+}
+
+std::optional<size_t> uncompressedSize(std::span<const uint8_t> data) noexcept {
+  return uncompressedSize(data, data.size());
+}
+
+std::optional<size_t> uncompressedSize(std::span<const uint8_t> head,
+                                       size_t streamSize) noexcept {
+  auto header = parseHeader(head, streamSize);
+  if (!header) {
+    return std::nullopt;
+  }
+  return header->uncompressedSize;
+}
+
+bool decompress(std::span<const uint8_t> data, std::span<uint8_t> out, std::string *outError) {
+  auto header = parseHeader(data, data.size());
+  if (!header) {
+    if (outError) {
+      *outError = "Data is not RefPack-compressed";
+    }
+    return false;
+  }
+  if (out.size() < header->uncompressedSize) {
+    if (outError) {
+      *outError = std::format("Output buffer too small for RefPack data (need {}, have {})",
+                              header->uncompressedSize, out.size());
+    }
+    return false;
+  }
+
+  const uint8_t *src = data.data() + header->headerSize;
+  const uint8_t *srcEnd = data.data() + data.size();
+  uint8_t *const dstBegin = out.data();
+  uint8_t *dst = dstBegin;
+  uint8_t *const dstEnd = dstBegin + header->uncompressedSize;
+
+  // Bounds are checked once per command, never per byte
+  for (;;) {
+    if (src >= srcEnd) {
+      break;
+    }
+
+    const uint8_t b0 = src[0];
+    size_t literals = 0;
+    size_t length = 0;
+    size_t distance = 0;
+    bool last = false;
+
+    if (b0 < 0x80) {
+      if (srcEnd - src < 2) {
+        break;
+      }
+      literals = b0 & 0x03;
+      length = ((b0 & 0x1C) >> 2) + 3;
+      distance = ((b0 & 0x60) << 3) + src[1] + 1;
+      src += 2;
+    } else if (b0 < 0xC0) {
+      if (srcEnd - src < 3) {
+        break;
+      }
+      literals = src[1] >> 6;
+      length = (b0 & 0x3F) + 4;
+      distance = ((src[1] & 0x3F) << 8) + src[2] + 1;
+      src += 3;
+    } else if (b0 < 0xE0) {
+      if (srcEnd - src < 4) {
+        break;
+      }
+      literals = b0 & 0x03;
+      length = ((b0 & 0x0C) << 6) + src[3] + 5;
+      distance = ((b0 & 0x10) << 12) + (src[1] << 8) + src[2] + 1;
+      src += 4;
+    } else if (b0 < 0xFC) {
+      literals = ((b0 & 0x1F) << 2) + 4;
+      src += 1;
+    } else {
+      literals = b0 & 0x03;
+      last = true;
+      src += 1;
+    }
+
+    if (literals > static_cast<size_t>(srcEnd - src) ||
+        literals > static_cast<size_t>(dstEnd - dst)) {
+      break;
+    }
+    std::memcpy(dst, src, literals);
+    src += literals;
+    dst += literals;
+
+    if (length > 0) {
+      if (distance > static_cast<size_t>(dst - dstBegin) ||
+          length > static_cast<size_t>(dstEnd - dst)) {
+        break;
+      }
+      copyMatch(dst, distance, length);
+      dst += length;
+    }
+
+    if (last) {
+      if (dst == dstEnd) {
+        return true;
+      }
+      break;
+    }
+  }
+
+  if (outError) {
+    *outError = std::format("Corrupt RefPack stream (decoded {} of {} bytes)",
+                            static_cast<size_t>(dst - dstBegin), header->uncompressedSize);
+  }
+  return false;
+}
+
+std::optional<std::vector<uint8_t>> decompress(std::span<const uint8_t> data,
+                                               std::string *outError) {
+  auto size = uncompressedSize(data);
+  if (!size) {
+    if (outError) {
+      *outError = "Data is not RefPack-compressed";
+    }
+    return std::nullopt;
+  }
+
+  std::vector<uint8_t> result(*size);
+  if (!decompress(data, result, outError)) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+std::vector<uint8_t> compress(std::span<const uint8_t> data) {
+  std::vector<uint8_t> out;
+  if (data.size() > UINT32_MAX) {
+    return out;
+  }
+
+  // Header: 3-byte size when it fits, 4-byte size otherwise
+  out.reserve(data.size() / 2 + 16);
+  bool large = data.size() > 0xFFFFFF;
+  out.push_back(large ? 0x90 : 0x10);
+  out.push_back(magicByte);
+  for (int shift = large ? 24 : 16; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<uint8_t>(data.size() >> shift));
+  }
+
+  // Greedy matcher over hash chains; chain links are kept for one window only
+  constexpr size_t chainDepth = 32;
+  constexpr int32_t none = -1;
+  std::vector<int32_t> head(1 << 16, none);
+  std::vector<int32_t> prev(maxDistance, none);
+
+  Encoder encoder(out);
+  const uint8_t *base = data.data();
+  const size_t size = data.size();
+  size_t pos = 0;
+  size_t literalStart = 0;
+
+  auto insert = [&](size_t at) {
+    uint32_t h = hash3(base + at);
+    prev[at % maxDistance] = head[h];
+    head[h] = static_cast<int32_t>(at);
+  };
+
+  while (pos + minMatch <= size) {
+    size_t bestLength = 0;
+    size_t bestDistance = 0;
+    size_t limit = std::min(maxMatch, size - pos);
+
+    int32_t candidate = head[hash3(base + pos)];
+    for (size_t depth = 0; candidate != none && depth < chainDepth; ++depth) {
+      size_t distance = pos - static_cast<size_t>(candidate);
+      if (distance > maxDistance) {
+        break;
+      }
+      const uint8_t *a = base + candidate;
+      const uint8_t *b = base + pos;
+      size_t length = 0;
+      while (length < limit && a[length] == b[length]) {
+        ++length;
+      }
+      if (length > bestLength && encodable(distance, length)) {
+        bestLength = length;
+        bestDistance = distance;
+        if (length == limit) {
+          break;
+        }
+      }
+      candidate = prev[static_cast<size_t>(candidate) % maxDistance];
+    }
+
+    if (bestLength == 0) {
+      insert(pos);
+      ++pos;
+      continue;
+    }
+
+    size_t literalCount = pos - literalStart;
+    encoder.flushLiterals(base + literalStart, literalCount);
+    encoder.match(base + pos - literalCount, literalCount, bestDistance, bestLength);
+
+    size_t end = pos + bestLength;
+    for (; pos < end && pos + minMatch <= size; ++pos) {
+      insert(pos);
+    }
+    pos = end;
+    literalStart = pos;
+  }
+
+  size_t literalCount = size - literalStart;
+  encoder.flushLiterals(base + literalStart, literalCount);
+  encoder.finish(base + size - literalCount, literalCount);
+  return out;
+}
+
+} // namespace bigx::refpack
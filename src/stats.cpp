@@ -0,0 +1,61 @@
+#include <bigx/stats.hpp>
+
+namespace bigx {
+
+const char *phaseName(Phase phase) noexcept {
+  switch (phase) {
+  case Phase::Map:
+    return "map";
+  case Phase::ParseHeader:
+    return "parse-header";
+  case Phase::ParseDirectory:
+    return "parse-directory";
+  case Phase::BuildIndex:
+    return "build-index";
+  case Phase::LoadIndex:
+    return "load-index";
+  case Phase::BuildFileEntries:
+    return "build-file-entries";
+  case Phase::BuildTree:
+    return "build-tree";
+  case Phase::SizeSources:
+    return "size-sources";
+  case Phase::Compress:
+    return "compress";
+  case Phase::Deduplicate:
+    return "deduplicate";
+  case Phase::WriteDirectory:
+    return "write-directory";
+  case Phase::CopyPayloads:
+    return "copy-payloads";
+  case Phase::Flush:
+    return "flush";
+  }
+  return "unknown";
+}
+
+namespace detail {
+
+ReaderStats ReaderCounters::snapshot() const noexcept {
+  ReaderStats stats;
+  stats.openNanos = openNanos.load(std::memory_order_relaxed);
+  stats.lookupHits = lookupHits.load(std::memory_order_relaxed);
+  stats.lookupMisses = lookupMisses.load(std::memory_order_relaxed);
+  stats.filesExtracted = filesExtracted.load(std::memory_order_relaxed);
+  stats.bytesExtracted = bytesExtracted.load(std::memory_order_relaxed);
+  stats.ioErrors = ioErrors.load(std::memory_order_relaxed);
+  return stats;
+}
+
+WriterStats WriterCounters::snapshot() const noexcept {
+  WriterStats stats;
+  stats.writeNanos = writeNanos.load(std::memory_order_relaxed);
+  stats.filesWritten = filesWritten.load(std::memory_order_relaxed);
+  stats.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+  stats.ioErrors = ioErrors.load(std::memory_order_relaxed);
+  return stats;
+}
+
+} // namespace detail
+
+} // namespace bigx
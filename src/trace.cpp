@@ -0,0 +1,188 @@
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+
+#include <bigx/reader.hpp>
+#include <bigx/trace.hpp>
+
+#include "format.hpp"
+
+namespace bigx {
+
+namespace {
+
+constexpr char traceMagic[8] = {'B', 'I', 'G', 'X', 'T', 'R', 'C', '1'};
+constexpr size_t traceHeaderSize = 8 + 4 + 8;
+constexpr size_t eventSize = 8 + 4 + 1 + 4;
+
+} // namespace
+
+void AccessTrace::record(TraceOp op, std::string_view path) {
+  auto now = Clock::now();
+  std::lock_guard lock(mutex_);
+
+  auto pathIt = pathIds_.find(path);
+  if (pathIt == pathIds_.end()) {
+    pathIt = pathIds_.emplace(std::string(path), static_cast<uint32_t>(log_.paths.size())).first;
+    log_.paths.emplace_back(path);
+  }
+  auto threadIt =
+      threadIds_.try_emplace(std::this_thread::get_id(), static_cast<uint32_t>(threadIds_.size()))
+          .first;
+
+  TraceEvent event;
+  event.nanos = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count());
+  event.thread = threadIt->second;
+  event.op = op;
+  event.path = pathIt->second;
+  log_.events.push_back(event);
+}
+
+AccessLog AccessTrace::snapshot() const {
+  std::lock_guard lock(mutex_);
+  return log_;
+}
+
+void AccessTrace::clear() {
+  std::lock_guard lock(mutex_);
+  log_ = AccessLog{};
+  pathIds_.clear();
+  threadIds_.clear();
+}
+
+bool saveAccessLog(const AccessLog &log, const std::filesystem::path &path,
+                   std::string *outError) {
+  size_t size = traceHeaderSize + eventSize * log.events.size();
+  for (const std::string &name : log.paths) {
+    size += 4 + name.size();
+  }
+
+  std::vector<uint8_t> bytes(size);
+  uint8_t *pos = bytes.data();
+  std::memcpy(pos, traceMagic, sizeof(traceMagic));
+  detail::storeField(pos + 8, 4, log.paths.size());
+  detail::storeField(pos + 12, 8, log.events.size());
+  pos += traceHeaderSize;
+  for (const std::string &name : log.paths) {
+    detail::storeField(pos, 4, name.size());
+    std::memcpy(pos + 4, name.data(), name.size());
+    pos += 4 + name.size();
+  }
+  for (const TraceEvent &event : log.events) {
+    detail::storeField(pos, 8, event.nanos);
+    detail::storeField(pos + 8, 4, event.thread);
+    pos[12] = static_cast<uint8_t>(event.op);
+    detail::storeField(pos + 13, 4, event.path);
+    pos += eventSize;
+  }
+
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(size));
+  if (!out) {
+    if (outError) {
+      *outError = std::format("Failed to write trace file: {}", path.string());
+    }
+    return false;
+  }
+  return true;
+}
+
+std::optional<AccessLog> loadAccessLog(const std::filesystem::path &path, std::string *outError) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    if (outError) {
+      *outError = std::format("Failed to open trace file: {}", path.string());
+    }
+    return std::nullopt;
+  }
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                             std::istreambuf_iterator<char>());
+
+  auto malformed = [&]() -> std::optional<AccessLog> {
+    if (outError) {
+      *outError = std::format("Malformed trace file: {}", path.string());
+    }
+    return std::nullopt;
+  };
+  if (bytes.size() < traceHeaderSize || std::memcmp(bytes.data(), traceMagic, 8) != 0) {
+    return malformed();
+  }
+
+  // Every count is checked against the bytes left before anything is allocated for it
+  const uint8_t *pos = bytes.data() + traceHeaderSize;
+  const uint8_t *end = bytes.data() + bytes.size();
+  uint64_t pathCount = detail::loadField(bytes.data() + 8, 4);
+  uint64_t eventCount = detail::loadField(bytes.data() + 12, 8);
+  if (pathCount > static_cast<size_t>(end - pos) / 4) {
+    return malformed();
+  }
+
+  AccessLog log;
+  log.paths.reserve(static_cast<size_t>(pathCount));
+  for (uint64_t i = 0; i < pathCount; ++i) {
+    if (end - pos < 4) {
+      return malformed();
+    }
+    uint64_t length = detail::loadField(pos, 4);
+    pos += 4;
+    if (length > static_cast<size_t>(end - pos)) {
+      return malformed();
+    }
+    log.paths.emplace_back(reinterpret_cast<const char *>(pos), static_cast<size_t>(length));
+    pos += length;
+  }
+
+  if (eventCount != static_cast<size_t>(end - pos) / eventSize ||
+      static_cast<size_t>(end - pos) % eventSize != 0) {
+    return malformed();
+  }
+  log.events.resize(static_cast<size_t>(eventCount));
+  for (TraceEvent &event : log.events) {
+    event.nanos = detail::loadField(pos, 8);
+    event.thread = static_cast<uint32_t>(detail::loadField(pos + 8, 4));
+    event.op = static_cast<TraceOp>(pos[12]);
+    event.path = static_cast<uint32_t>(detail::loadField(pos + 13, 4));
+    if (pos[12] > static_cast<uint8_t>(TraceOp::Extract) || event.path >= pathCount) {
+      return malformed();
+    }
+    pos += eventSize;
+  }
+  return log;
+}
+
+std::vector<std::string> layoutProfile(const AccessLog &log) {
+  std::vector<std::string> order;
+  std::vector<bool> seen(log.paths.size());
+  for (const TraceEvent &event : log.events) {
+    if (!seen[event.path]) {
+      seen[event.path] = true;
+      order.push_back(log.paths[event.path]);
+    }
+  }
+  return order;
+}
+
+std::vector<MappedRange> prefetchList(const AccessLog &log, const Reader &reader) {
+  // Resolve through entries() rather than findEntry() so a traced reader records nothing
+  std::span<const EntryView> entries = reader.entries();
+  std::unordered_map<std::string_view, const EntryView *, detail::PathHash, detail::PathEqual>
+      entryOf;
+  entryOf.reserve(entries.size());
+  for (const EntryView &entry : entries) {
+    entryOf.try_emplace(entry.path, &entry);
+  }
+
+  std::vector<MappedRange> ranges;
+  for (const std::string &path : layoutProfile(log)) {
+    auto it = entryOf.find(path);
+    if (it != entryOf.end() && it->second->size > 0) {
+      ranges.push_back({static_cast<size_t>(it->second->offset),
+                        static_cast<size_t>(it->second->size)});
+    }
+  }
+  return ranges;
+}
+
+} // namespace bigx
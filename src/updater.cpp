@@ -0,0 +1,590 @@
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+#include <bigx/reader.hpp>
+#include <bigx/updater.hpp>
+#include <bigx/writer.hpp>
+
+#include "format.hpp"
+#include "path_fold.hpp"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Keep std::min/std::max usable
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace bigx {
+
+namespace {
+
+// Push the file's written data through to the storage device
+// std::fstream::flush() only hands bytes to the OS, which may write them back in any order.
+bool syncFile(const std::filesystem::path &path) {
+#ifdef _WIN32
+  HANDLE handle = CreateFileW(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  bool ok = FlushFileBuffers(handle) != 0;
+  CloseHandle(handle);
+  return ok;
+#else
+  int fd = ::open(path.c_str(), O_WRONLY);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = ::fsync(fd) == 0;
+  ::close(fd);
+  return ok;
+#endif
+}
+
+constexpr size_t chunkSize = 4 * 1024 * 1024; // Bounded copies; archives may be many GiB
+
+bool writeAt(std::fstream &file, uint64_t pos, const uint8_t *data, size_t size) {
+  file.seekp(static_cast<std::streamoff>(pos));
+  file.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+  return static_cast<bool>(file);
+}
+
+// Copy size bytes from one part of the file to a non-overlapping later part
+bool copyWithin(std::fstream &file, uint64_t from, uint64_t to, uint64_t size,
+                std::vector<uint8_t> &buffer) {
+  for (uint64_t done = 0; done < size;) {
+    size_t chunk = static_cast<size_t>(std::min<uint64_t>(chunkSize, size - done));
+    buffer.resize(chunk);
+    file.seekg(static_cast<std::streamoff>(from + done));
+    if (!file.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(chunk)) ||
+        !writeAt(file, to + done, buffer.data(), chunk)) {
+      return false;
+    }
+    done += chunk;
+  }
+  return true;
+}
+
+// Stream a disk source of the expected size into the file at pos
+bool copyFromDisk(std::fstream &file, uint64_t pos, const std::filesystem::path &sourcePath,
+                  uint64_t size, std::vector<uint8_t> &buffer, std::string *outError) {
+  std::ifstream in(sourcePath, std::ios::binary);
+  if (!in) {
+    if (outError) {
+      *outError = std::format("Failed to open source file: {}", sourcePath.string());
+    }
+    return false;
+  }
+
+  for (uint64_t done = 0; done < size;) {
+    size_t chunk = static_cast<size_t>(std::min<uint64_t>(chunkSize, size - done));
+    buffer.resize(chunk);
+    if (!in.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(chunk))) {
+      if (outError) {
+        *outError = std::format("Failed to read source file: {}", sourcePath.string());
+      }
+      return false;
+    }
+    if (!writeAt(file, pos + done, buffer.data(), chunk)) {
+      if (outError) {
+        *outError = "Failed to write archive payload";
+      }
+      return false;
+    }
+    done += chunk;
+  }
+
+  // The file must not have grown since it was sized
+  if (in.peek() != std::ifstream::traits_type::eof()) {
+    if (outError) {
+      *outError = std::format("Source file changed size during commit: {}", sourcePath.string());
+    }
+    return false;
+  }
+  return true;
+}
+
+} // namespace
+
+std::optional<Updater> Updater::open(const std::filesystem::path &path, std::string *outError) {
+  Updater updater;
+  updater.path_ = path;
+  if (!updater.load(outError)) {
+    return std::nullopt;
+  }
+  return updater;
+}
+
+bool Updater::load(std::string *outError) {
+  // Validate and read the directory through a Reader, then drop the mapping before writing
+  auto reader = Reader::open(path_, outError);
+  if (!reader) {
+    return false;
+  }
+
+  std::error_code ec;
+  uint64_t size = std::filesystem::file_size(path_, ec);
+  if (ec) {
+    if (outError) {
+      *outError = std::format("Failed to get file size: {}", path_.string());
+    }
+    return false;
+  }
+
+  format_ = reader->format();
+  checksums_ = reader->hasChecksums();
+  indexTrailer_ = reader->hasIndexTrailer();
+  archiveSize_ = size;
+  entries_ = reader->files();
+  discard();
+  return true;
+}
+
+bool Updater::addFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
+                      std::string *outError) {
+  // Check if file exists
+  std::error_code ec;
+  if (!std::filesystem::exists(sourcePath, ec)) {
+    if (outError) {
+      *outError = std::format("Source file does not exist: {}", sourcePath.string());
+    }
+    return false;
+  }
+
+  Payload payload;
+  payload.sourcePath = sourcePath;
+  payload.source = Source::Disk;
+  return stage(archivePath, std::move(payload), false, outError);
+}
+
+bool Updater::addFile(std::span<const uint8_t> data, const std::string &archivePath,
+                      std::string *outError) {
+  Payload payload;
+  payload.data.assign(data.begin(), data.end());
+  payload.source = Source::Memory;
+  return stage(archivePath, std::move(payload), false, outError);
+}
+
+bool Updater::addFileView(std::span<const uint8_t> data, const std::string &archivePath,
+                          std::string *outError) {
+  Payload payload;
+  payload.view = data;
+  payload.source = Source::View;
+  return stage(archivePath, std::move(payload), false, outError);
+}
+
+bool Updater::replaceFile(const std::filesystem::path &sourcePath,
+                          const std::string &archivePath, std::string *outError) {
+  std::error_code ec;
+  if (!std::filesystem::exists(sourcePath, ec)) {
+    if (outError) {
+      *outError = std::format("Source file does not exist: {}", sourcePath.string());
+    }
+    return false;
+  }
+
+  Payload payload;
+  payload.sourcePath = sourcePath;
+  payload.source = Source::Disk;
+  return stage(archivePath, std::move(payload), true, outError);
+}
+
+bool Updater::replaceFile(std::span<const uint8_t> data, const std::string &archivePath,
+                          std::string *outError) {
+  Payload payload;
+  payload.data.assign(data.begin(), data.end());
+  payload.source = Source::Memory;
+  return stage(archivePath, std::move(payload), true, outError);
+}
+
+bool Updater::removeFile(const std::string &archivePath, std::string *outError) {
+  auto it = lookup_.find(archivePath);
+  if (it == lookup_.end()) {
+    if (outError) {
+      *outError = std::format("File not found in archive: {}", archivePath);
+    }
+    return false;
+  }
+
+  items_[it->second].removed = true;
+  lookup_.erase(it);
+  ++removedCount_;
+  dirty_ = true;
+  return true;
+}
+
+bool Updater::contains(std::string_view archivePath) const {
+  return lookup_.contains(archivePath);
+}
+
+void Updater::discard() {
+  items_.clear();
+  items_.reserve(entries_.size());
+  for (const auto &entry : entries_) {
+    items_.push_back(Item{entry, std::nullopt});
+  }
+  removedCount_ = 0;
+  reindex();
+  dirty_ = false;
+}
+
+bool Updater::stage(const std::string &archivePath, Payload payload, bool replace,
+                    std::string *outError) {
+  std::string key = detail::foldedPath(archivePath);
+  auto it = lookup_.find(key);
+
+  if (replace) {
+    if (it == lookup_.end()) {
+      if (outError) {
+        *outError = std::format("File not found in archive: {}", archivePath);
+      }
+      return false;
+    }
+    items_[it->second].staged = std::move(payload);
+  } else {
+    if (it != lookup_.end()) {
+      if (outError) {
+        *outError = std::format("Duplicate file path in archive: {}", archivePath);
+      }
+      return false;
+    }
+    Item item;
+    item.entry.path = detail::slashedPath(archivePath);
+    item.entry.lowercasePath = key;
+    item.staged = std::move(payload);
+    lookup_.emplace(std::move(key), items_.size());
+    items_.push_back(std::move(item));
+  }
+
+  dirty_ = true;
+  return true;
+}
+
+void Updater::reindex() {
+  lookup_.clear();
+  lookup_.reserve(items_.size());
+  for (size_t i = 0; i < items_.size(); ++i) {
+    lookup_.emplace(items_[i].entry.lowercasePath, i);
+  }
+}
+
+void Updater::compactItems() {
+  if (removedCount_ == 0) {
+    return;
+  }
+  std::erase_if(items_, [](const Item &item) { return item.removed; });
+  removedCount_ = 0;
+  reindex();
+}
+
+uint64_t Updater::directorySize(size_t fieldSize) const {
+  uint64_t size = ArchiveHeader::headerSize;
+  for (const auto &item : items_) {
+    if (item.removed) {
+      continue;
+    }
+    size += 2 * fieldSize + item.entry.path.size() + 1;
+  }
+  return size;
+}
+
+bool Updater::commit(std::string *outError) {
+  return commit(UpdateOptions{}, outError);
+}
+
+bool Updater::commit(const UpdateOptions &options, std::string *outError) {
+  if (!dirty_) {
+    return true;
+  }
+  compactItems();
+
+  const detail::FormatLayout &layout = detail::layoutOf(format_);
+  if (items_.size() > UINT32_MAX) {
+    if (outError) {
+      *outError = std::format("Too many files for a BIG archive: {}", items_.size());
+    }
+    return false;
+  }
+
+  // Step 1: Size staged payloads
+  std::vector<uint64_t> stagedSizes(items_.size());
+  for (size_t i = 0; i < items_.size(); ++i) {
+    const auto &staged = items_[i].staged;
+    if (!staged) {
+      continue;
+    }
+    switch (staged->source) {
+    case Source::Disk: {
+      std::error_code ec;
+      stagedSizes[i] = std::filesystem::file_size(staged->sourcePath, ec);
+      if (ec) {
+        if (outError) {
+          *outError = std::format("Failed to get file size: {}", staged->sourcePath.string());
+        }
+        return false;
+      }
+      break;
+    }
+    case Source::View:
+      stagedSizes[i] = staged->view.size();
+      break;
+    case Source::Memory:
+      stagedSizes[i] = staged->data.size();
+      break;
+    }
+  }
+
+  // Step 2: Make room for the directory
+  // It may grow into dead space up to the first payload that survives the update; if it needs
+  // more, the payloads in its way move to the end of the file (slack included, so the next
+  // update can grow without moving anything).
+  uint64_t directoryEnd = directorySize(layout.fieldSize);
+  std::vector<size_t> byOffset;
+  for (size_t i = 0; i < items_.size(); ++i) {
+    if (!items_[i].staged && items_[i].entry.size > 0) {
+      byOffset.push_back(i);
+    }
+  }
+  std::sort(byOffset.begin(), byOffset.end(), [&](size_t a, size_t b) {
+    const FileEntry &x = items_[a].entry;
+    const FileEntry &y = items_[b].entry;
+    return x.offset != y.offset ? x.offset < y.offset : x.size < y.size;
+  });
+
+  uint64_t room = byOffset.empty() ? archiveSize_ : items_[byOffset.front()].entry.offset;
+  uint64_t reservedEnd = directoryEnd;
+  if (directoryEnd > room) {
+    reservedEnd += options.directorySlack;
+  }
+
+  struct Move {
+    size_t item = 0;
+    uint64_t from = 0;
+    bool shared = false; // Same payload as the previous move, which carries it
+  };
+  std::vector<Move> moves;
+  for (size_t i : byOffset) {
+    if (items_[i].entry.offset >= reservedEnd) {
+      break;
+    }
+    moves.push_back({i, items_[i].entry.offset});
+  }
+
+  // Step 3: Lay out moved and staged payloads after the current end of the file
+  // Entries sharing a payload (see WriteOptions::deduplicate) still share it once moved
+  std::vector<uint64_t> offsets(items_.size());
+  uint64_t end = std::max(archiveSize_, reservedEnd);
+  for (size_t m = 0; m < moves.size(); ++m) {
+    Move &move = moves[m];
+    uint64_t size = items_[move.item].entry.size;
+    if (m > 0 && move.from == moves[m - 1].from && size == items_[moves[m - 1].item].entry.size) {
+      move.shared = true;
+      offsets[move.item] = offsets[moves[m - 1].item];
+      continue;
+    }
+    offsets[move.item] = end;
+    end += size;
+  }
+  for (size_t i = 0; i < items_.size(); ++i) {
+    if (items_[i].staged) {
+      offsets[i] = end;
+      end += stagedSizes[i];
+    }
+  }
+
+  if (end > layout.maxValue()) {
+    if (outError) {
+      *outError = std::format("Update would grow the archive to {} bytes, past the limit of the {} "
+                              "format (compact() into ArchiveFormat::Big64 first)",
+                              end, layout.magic);
+    }
+    return false;
+  }
+
+  // Step 4: Write payloads; the old directory still describes a valid archive until step 5
+  // The payloads reach the disk before the directory is rewritten, so this holds across a power
+  // loss as well as a crash
+  std::fstream file(path_, std::ios::binary | std::ios::in | std::ios::out);
+  if (!file) {
+    if (outError) {
+      *outError = std::format("Failed to open archive for update: {}", path_.string());
+    }
+    return false;
+  }
+
+  std::vector<uint8_t> buffer;
+  for (const auto &move : moves) {
+    if (move.shared) {
+      continue;
+    }
+    if (!copyWithin(file, move.from, offsets[move.item], items_[move.item].entry.size, buffer)) {
+      if (outError) {
+        *outError = std::format("Failed to move payload: {}", items_[move.item].entry.path);
+      }
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < items_.size(); ++i) {
+    const auto &staged = items_[i].staged;
+    if (!staged) {
+      continue;
+    }
+    bool ok = true;
+    switch (staged->source) {
+    case Source::Disk:
+      ok = copyFromDisk(file, offsets[i], staged->sourcePath, stagedSizes[i], buffer, outError);
+      break;
+    case Source::View:
+      ok = writeAt(file, offsets[i], staged->view.data(), staged->view.size());
+      break;
+    case Source::Memory:
+      ok = writeAt(file, offsets[i], staged->data.data(), staged->data.size());
+      break;
+    }
+    if (!ok) {
+      if (outError && staged->source != Source::Disk) {
+        *outError = std::format("Failed to write payload: {}", items_[i].entry.path);
+      }
+      return false;
+    }
+  }
+
+  if (!file.flush() || !syncFile(path_)) {
+    if (outError) {
+      *outError = std::format("Failed to flush archive: {}", path_.string());
+    }
+    return false;
+  }
+
+  // Step 5: Rewrite header and directory in place (reserved slack is zeroed)
+  for (const auto &move : moves) {
+    items_[move.item].entry.offset = offsets[move.item];
+  }
+  for (size_t i = 0; i < items_.size(); ++i) {
+    if (items_[i].staged) {
+      items_[i].entry.offset = offsets[i];
+      items_[i].entry.size = stagedSizes[i];
+    }
+  }
+
+  std::vector<uint8_t> directory(static_cast<size_t>(reservedEnd), 0);
+  detail::storeHeader(directory.data(), layout, static_cast<uint32_t>(items_.size()), end);
+  size_t pos = ArchiveHeader::headerSize;
+  for (const auto &item : items_) {
+    detail::storeField(directory.data() + pos, layout.fieldSize, item.entry.offset);
+    detail::storeField(directory.data() + pos + layout.fieldSize, layout.fieldSize,
+                       item.entry.size);
+    pos += 2 * layout.fieldSize;
+    std::copy(item.entry.path.begin(), item.entry.path.end(), directory.begin() + pos);
+    pos += item.entry.path.size() + 1;
+  }
+
+  if (!writeAt(file, 0, directory.data(), directory.size()) || !file.flush() ||
+      !syncFile(path_)) {
+    if (outError) {
+      *outError = std::format("Failed to write archive directory: {}", path_.string());
+    }
+    return false;
+  }
+
+  // The staged state is now the committed state
+  archiveSize_ = end;
+  entries_.clear();
+  entries_.reserve(items_.size());
+  for (auto &item : items_) {
+    item.staged.reset();
+    entries_.push_back(item.entry);
+  }
+  dirty_ = false;
+  return true;
+}
+
+bool Updater::compact(const UpdateOptions &options, std::string *outError) {
+  if (!commit(options, outError)) {
+    return false;
+  }
+
+  auto reader = Reader::open(path_, outError);
+  if (!reader) {
+    return false;
+  }
+
+  // Payloads are copied straight out of the mapping, in directory order
+  Writer writer;
+  writer.reserve(reader->fileCount());
+  for (const auto &entry : reader->files()) {
+    if (!writer.addFileView(reader->getFileView(entry), entry.path, outError)) {
+      return false;
+    }
+  }
+
+  WriteOptions writeOptions;
+  writeOptions.format = options.format.value_or(format_);
+  writeOptions.directorySlack = options.directorySlack;
+  writeOptions.deduplicate = hasSharedPayloads();
+  writeOptions.checksums = checksums_;
+  writeOptions.indexTrailer = indexTrailer_;
+
+  std::filesystem::path tempPath = path_;
+  tempPath += ".compact";
+  std::error_code ec;
+  if (!writer.write(tempPath, writeOptions, outError)) {
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+  reader->close();
+
+  std::filesystem::rename(tempPath, path_, ec);
+  if (ec) {
+    if (outError) {
+      *outError = std::format("Failed to replace archive: {} ({})", path_.string(), ec.message());
+    }
+    std::filesystem::remove(tempPath, ec);
+    return false;
+  }
+
+  return load(outError);
+}
+
+bool Updater::hasSharedPayloads() const {
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  for (const auto &entry : entries_) {
+    if (entry.size > 0) {
+      ranges.emplace_back(entry.offset, entry.size);
+    }
+  }
+  std::sort(ranges.begin(), ranges.end());
+  return std::adjacent_find(ranges.begin(), ranges.end()) != ranges.end();
+}
+
+uint64_t Updater::deadBytes() const {
+  // Union of the committed payload ranges (entries may share a payload)
+  std::vector<std::pair<uint64_t, uint64_t>> ranges;
+  uint64_t used = ArchiveHeader::headerSize;
+  const size_t fieldSize = detail::layoutOf(format_).fieldSize;
+  for (const auto &entry : entries_) {
+    used += 2 * fieldSize + entry.path.size() + 1;
+    if (entry.size > 0) {
+      ranges.emplace_back(entry.offset, entry.offset + entry.size);
+    }
+  }
+  std::sort(ranges.begin(), ranges.end());
+
+  uint64_t coveredEnd = 0;
+  for (const auto &[begin, end] : ranges) {
+    uint64_t from = std::max(begin, coveredEnd);
+    if (end > from) {
+      used += end - from;
+      coveredEnd = end;
+    }
+  }
+  return archiveSize_ > used ? archiveSize_ - used : 0;
+}
+
+} // namespace bigx
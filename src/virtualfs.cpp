@@ -0,0 +1,100 @@
+#include <algorithm>
+
+#include <bigx/reader.hpp>
+#include <bigx/virtualfs.hpp>
+
+namespace bigx {
+
+// Special member functions defined here where Reader is a complete type
+VirtualFS::VirtualFS() = default;
+VirtualFS::~VirtualFS() = default;
+VirtualFS::VirtualFS(VirtualFS &&) noexcept = default;
+VirtualFS &VirtualFS::operator=(VirtualFS &&) noexcept = default;
+
+MountId VirtualFS::mount(Reader &&reader, int priority) {
+  MountId id = nextId_++;
+  Mount &mounted = mounts_[id];
+  mounted.reader = std::make_unique<Reader>(std::move(reader));
+  mounted.priority = priority;
+  mounted.sequence = nextSequence_++;
+
+  // Merge this archive's entries into the shared table
+  const auto &files = mounted.reader->files();
+  lookup_.reserve(lookup_.size() + files.size());
+  for (const auto &file : files) {
+    Candidate candidate{priority, mounted.sequence, ResolvedFile{mounted.reader.get(), &file, id}};
+    auto &candidates = lookup_[file.lowercasePath];
+    auto pos = std::find_if(candidates.begin(), candidates.end(), [&](const Candidate &other) {
+      return outranks(candidate, other);
+    });
+    candidates.insert(pos, candidate);
+  }
+
+  return id;
+}
+
+std::optional<MountId> VirtualFS::mount(const std::filesystem::path &path, int priority,
+                                        std::string *outError) {
+  auto reader = Reader::open(path, outError);
+  if (!reader) {
+    return std::nullopt;
+  }
+  return mount(std::move(*reader), priority);
+}
+
+bool VirtualFS::unmount(MountId id) {
+  auto it = mounts_.find(id);
+  if (it == mounts_.end()) {
+    return false;
+  }
+
+  // Withdraw this archive's claims; shadowed candidates move to the front automatically
+  for (const auto &file : it->second.reader->files()) {
+    auto slot = lookup_.find(file.lowercasePath);
+    if (slot == lookup_.end()) {
+      continue;
+    }
+    auto &candidates = slot->second;
+    std::erase_if(candidates,
+                  [id](const Candidate &candidate) { return candidate.file.mount == id; });
+    if (candidates.empty()) {
+      lookup_.erase(slot);
+    }
+  }
+
+  mounts_.erase(it);
+  return true;
+}
+
+void VirtualFS::clear() {
+  lookup_.clear();
+  mounts_.clear();
+}
+
+std::optional<ResolvedFile> VirtualFS::findFile(std::string_view path) const {
+  auto it = lookup_.find(path);
+  if (it == lookup_.end()) {
+    return std::nullopt;
+  }
+  return it->second.front().file;
+}
+
+const Reader *VirtualFS::reader(MountId id) const {
+  auto it = mounts_.find(id);
+  return it == mounts_.end() ? nullptr : it->second.reader.get();
+}
+
+void VirtualFS::forEachFile(const std::function<void(const ResolvedFile &)> &visitor) const {
+  for (const auto &[path, candidates] : lookup_) {
+    visitor(candidates.front().file);
+  }
+}
+
+bool VirtualFS::outranks(const Candidate &a, const Candidate &b) {
+  if (a.priority != b.priority) {
+    return a.priority > b.priority;
+  }
+  return a.sequence > b.sequence;
+}
+
+} // namespace bigx
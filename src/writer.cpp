@@ -1,13 +1,26 @@
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <format>
 #include <fstream>
+#include <optional>
+#include <unordered_map>
 #include <unordered_set>
 
-#include <bigx/endian.hpp>
 #include <bigx/mmap.hpp>
+#include <bigx/reader.hpp>
+#include <bigx/refpack.hpp>
 #include <bigx/writer.hpp>
 
+#include "checksum_trailer.hpp"
+#include "crc32c.hpp"
+#include "format.hpp"
+#include "hash.hpp"
+#include "index_trailer.hpp"
+#include "instrument.hpp"
+#include "parallel.hpp"
+#include "path_fold.hpp"
+
 namespace bigx {
 
 bool Writer::addFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
@@ -21,25 +34,20 @@ bool Writer::addFile(const std::filesystem::path &sourcePath, const std::string
     return false;
   }
 
-  // Normalize the archive path (forward slashes)
-  std::string normalizedArchivePath = normalizeSlashes(archivePath);
+  return addDiskFile(sourcePath, archivePath, outError);
+}
 
-  // Check for duplicate paths (case-insensitive)
-  std::string lowered = normalizePath(archivePath);
-  for (const auto &pending : pendingFiles_) {
-    if (normalizePath(pending.archivePath) == lowered) {
-      if (outError) {
-        *outError = std::format("Duplicate file path in archive: {}", archivePath);
-      }
-      return false;
-    }
+bool Writer::addDiskFile(const std::filesystem::path &sourcePath, const std::string &archivePath,
+                         std::string *outError) {
+  if (!claimPath(archivePath, outError)) {
+    return false;
   }
 
   // Add to pending files
   PendingFile pending;
-  pending.archivePath = normalizedArchivePath;
+  pending.archivePath = detail::slashedPath(archivePath);
   pending.sourcePath = sourcePath;
-  pending.fromDisk = true;
+  pending.source = Source::Disk;
   pendingFiles_.push_back(std::move(pending));
 
   return true;
@@ -47,238 +55,725 @@ bool Writer::addFile(const std::filesystem::path &sourcePath, const std::string
 
 bool Writer::addFile(std::span<const uint8_t> data, const std::string &archivePath,
                      std::string *outError) {
-  // Normalize the archive path (forward slashes)
-  std::string normalizedArchivePath = normalizeSlashes(archivePath);
+  if (!claimPath(archivePath, outError)) {
+    return false;
+  }
 
-  // Check for duplicate paths (case-insensitive)
-  std::string lowered = normalizePath(archivePath);
-  for (const auto &pending : pendingFiles_) {
-    if (normalizePath(pending.archivePath) == lowered) {
+  // Add to pending files
+  PendingFile pending;
+  pending.archivePath = detail::slashedPath(archivePath);
+  pending.data.assign(data.begin(), data.end());
+  pending.source = Source::Memory;
+  pendingFiles_.push_back(std::move(pending));
+
+  return true;
+}
+
+bool Writer::addFileView(std::span<const uint8_t> data, const std::string &archivePath,
+                         std::string *outError) {
+  if (!claimPath(archivePath, outError)) {
+    return false;
+  }
+
+  // Add to pending files (no copy, caller keeps data alive)
+  PendingFile pending;
+  pending.archivePath = detail::slashedPath(archivePath);
+  pending.view = data;
+  pending.source = Source::View;
+  pendingFiles_.push_back(std::move(pending));
+
+  return true;
+}
+
+bool Writer::addFromReader(const Reader &reader, const FileEntry &entry,
+                           const std::string &archivePath, std::string *outError) {
+  std::span<const uint8_t> payload = reader.getFileView(entry);
+  if (payload.size() != entry.size) {
+    if (outError) {
+      *outError = std::format("Entry out of bounds in source archive: {}", entry.path);
+    }
+    return false;
+  }
+  return addFileView(payload, archivePath, outError);
+}
+
+bool Writer::addArchive(const Reader &reader, const MergeOptions &options,
+                        std::string *outError) {
+  if (!reader.isOpen()) {
+    if (outError) {
+      *outError = "Source archive is not open";
+    }
+    return false;
+  }
+
+  std::span<const EntryView> entries = reader.entries();
+  reserve(entries.size());
+  for (const EntryView &entry : entries) {
+    if (options.filter && !options.filter(entry)) {
+      continue;
+    }
+    std::span<const uint8_t> payload = reader.getFileView(entry);
+    if (payload.size() != entry.size) {
+      if (outError) {
+        *outError = std::format("Entry out of bounds in source archive: {}", entry.path);
+      }
+      return false;
+    }
+
+    PendingFile incoming;
+    incoming.archivePath = detail::slashedPath(options.prefix + std::string(entry.path));
+    incoming.view = payload;
+    incoming.source = Source::View;
+
+    auto [it, inserted] =
+        lowercasePaths_.try_emplace(detail::foldedPath(incoming.archivePath), pendingFiles_.size());
+    if (inserted) {
+      pendingFiles_.push_back(std::move(incoming));
+      continue;
+    }
+    if (options.onConflict == MergeConflict::Fail) {
       if (outError) {
-        *outError = std::format("Duplicate file path in archive: {}", archivePath);
+        *outError = std::format("Duplicate file path in archive: {}", incoming.archivePath);
       }
       return false;
     }
+    if (options.onConflict == MergeConflict::Replace) {
+      pendingFiles_[it->second] = std::move(incoming);
+    }
   }
+  return true;
+}
 
-  // Add to pending files
-  PendingFile pending;
-  pending.archivePath = normalizedArchivePath;
-  pending.data.assign(data.begin(), data.end());
-  pending.fromDisk = false;
-  pendingFiles_.push_back(std::move(pending));
+bool Writer::addFiles(std::span<const FileSource> files, std::string *outError) {
+  reserve(files.size());
+  for (const auto &file : files) {
+    if (!addFile(file.sourcePath, file.archivePath, outError)) {
+      return false;
+    }
+  }
+  return true;
+}
 
+bool Writer::addDirectory(const std::filesystem::path &root, const std::string &archivePrefix,
+                          std::string *outError) {
+  std::error_code ec;
+  if (!std::filesystem::is_directory(root, ec)) {
+    if (outError) {
+      *outError = std::format("Source directory does not exist: {}", root.string());
+    }
+    return false;
+  }
+
+  // Collect regular files first so capacity can be reserved and order made deterministic
+  std::vector<std::pair<std::string, std::filesystem::path>> found;
+  for (auto it = std::filesystem::recursive_directory_iterator(root, ec);
+       !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+    if (it->is_regular_file(ec)) {
+      found.emplace_back(archivePrefix + it->path().lexically_relative(root).generic_string(),
+                         it->path());
+    }
+  }
+  if (ec) {
+    if (outError) {
+      *outError = std::format("Failed to scan directory: {} ({})", root.string(), ec.message());
+    }
+    return false;
+  }
+
+  std::sort(found.begin(), found.end());
+  reserve(found.size());
+  for (const auto &[archivePath, sourcePath] : found) {
+    if (!addDiskFile(sourcePath, archivePath, outError)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Writer::reserve(size_t count) {
+  pendingFiles_.reserve(pendingFiles_.size() + count);
+  lowercasePaths_.reserve(lowercasePaths_.size() + count);
+}
+
+bool Writer::claimPath(const std::string &archivePath, std::string *outError) {
+  // Check for duplicate paths (case-insensitive)
+  if (!lowercasePaths_.try_emplace(detail::foldedPath(archivePath), pendingFiles_.size()).second) {
+    if (outError) {
+      *outError = std::format("Duplicate file path in archive: {}", archivePath);
+    }
+    return false;
+  }
   return true;
 }
 
 bool Writer::write(const std::filesystem::path &destPath, std::string *outError) {
+  return write(destPath, WriteOptions{}, outError);
+}
+
+bool Writer::write(const std::filesystem::path &destPath, const WriteOptions &options,
+                   std::string *outError) {
+  detail::ScopeClock clock(stats_ ? &stats_->writeNanos : nullptr);
+  size_t archiveSize = 0;
+  if (!writeArchive(destPath, options, &archiveSize, outError)) {
+    clock.cancel();
+    return false;
+  }
+  BIGX_COUNT(stats_, filesWritten, entries_.size());
+  BIGX_COUNT(stats_, bytesWritten, archiveSize);
+  return true;
+}
+
+bool Writer::writeArchive(const std::filesystem::path &destPath, const WriteOptions &options,
+                          size_t *outSize, std::string *outError) {
+  const PhaseCallback *onPhase = &options.onPhase;
+
   // Handle empty archives (header only) by writing directly without mmap
   if (pendingFiles_.empty()) {
     std::ofstream out(destPath, std::ios::binary);
     if (!out) {
+      BIGX_COUNT(stats_, ioErrors, 1);
       if (outError) {
         *outError = std::format("Failed to create output file: {}", destPath.string());
       }
       return false;
     }
 
-    // Write header with zero files
-    out.write("BIGF", 4);
-    uint32_t archiveSizeBE = htobe32(static_cast<uint32_t>(ArchiveHeader::headerSize));
-    out.write(reinterpret_cast<const char *>(&archiveSizeBE), 4);
-    uint32_t fileCountBE = 0;
-    out.write(reinterpret_cast<const char *>(&fileCountBE), 4);
-    uint32_t pad = 0;
-    out.write(reinterpret_cast<const char *>(&pad), 4);
+    // Write header with zero files, followed by any requested slack
+    size_t archiveSize = ArchiveHeader::headerSize + options.directorySlack;
+    uint8_t header[ArchiveHeader::headerSize];
+    detail::storeHeader(header, detail::layoutOf(options.format), 0, archiveSize);
+    out.write(reinterpret_cast<const char *>(header), sizeof(header));
+    for (size_t i = 0; i < options.directorySlack; ++i) {
+      out.put('\0');
+    }
+    if (!out) {
+      BIGX_COUNT(stats_, ioErrors, 1);
+      if (outError) {
+        *outError = std::format("Failed to write output file: {}", destPath.string());
+      }
+      return false;
+    }
 
     entries_.clear();
+    *outSize = archiveSize;
     return true;
   }
 
-  // Step 1: Calculate total archive size
-  size_t headerSize = ArchiveHeader::headerSize;
-  size_t directorySize = 0;
+  if (pendingFiles_.size() > UINT32_MAX) {
+    if (outError) {
+      *outError = std::format("Too many files for a BIG archive: {}", pendingFiles_.size());
+    }
+    return false;
+  }
+
+  if ((options.payloadAlignment & (options.payloadAlignment - 1)) != 0) {
+    if (outError) {
+      *outError = std::format("Payload alignment must be a power of two: {}",
+                              options.payloadAlignment);
+    }
+    return false;
+  }
 
+  // Step 1: Calculate total archive size
+  std::optional<detail::PhaseTimer> timer(std::in_place, onPhase, Phase::SizeSources);
+  uint64_t pathsSize = 0;
   for (const auto &pending : pendingFiles_) {
-    // Each entry: offset (4) + size (4) + null-terminated path
-    directorySize += 8 + pending.archivePath.size() + 1;
+    // Null-terminated path; offset and size fields are added once the format is settled
+    pathsSize += pending.archivePath.size() + 1;
   }
 
   // Calculate file data section size
-  size_t filesDataSize = 0;
-  for (const auto &pending : pendingFiles_) {
-    if (pending.fromDisk) {
+  std::vector<size_t> fileSizes(pendingFiles_.size());
+  for (size_t i = 0; i < pendingFiles_.size(); ++i) {
+    const auto &pending = pendingFiles_[i];
+    switch (pending.source) {
+    case Source::Disk: {
       std::error_code ec;
-      filesDataSize += std::filesystem::file_size(pending.sourcePath, ec);
+      uintmax_t fileSize = std::filesystem::file_size(pending.sourcePath, ec);
+      if (!ec && fileSize > SIZE_MAX) {
+        if (outError) {
+          *outError = std::format("Source file too large for this platform: {}",
+                                  pending.sourcePath.string());
+        }
+        return false;
+      }
+      fileSizes[i] = static_cast<size_t>(fileSize);
       if (ec) {
+        BIGX_COUNT(stats_, ioErrors, 1);
         if (outError) {
           *outError = std::format("Failed to get file size: {}", pending.sourcePath.string());
         }
         return false;
       }
-    } else {
-      filesDataSize += pending.data.size();
+      break;
+    }
+    case Source::View:
+      fileSizes[i] = pending.view.size();
+      break;
+    case Source::Memory:
+      fileSizes[i] = pending.data.size();
+      break;
     }
   }
 
-  size_t totalSize = headerSize + directorySize + filesDataSize;
+  // Optionally compress payloads up front; sizes must be final before layout
+  // Compressed bytes stay in memory until copied (each source is mapped only while compressed)
+  std::vector<std::vector<uint8_t>> compressed;
+  if (options.compress) {
+    timer.emplace(onPhase, Phase::Compress);
+    compressed.resize(pendingFiles_.size());
+    std::vector<std::string> errors(pendingFiles_.size());
+    detail::parallelFor(pendingFiles_.size(), options.threads, [&](size_t i) {
+      compressPayload(pendingFiles_[i], fileSizes[i], compressed[i], &errors[i]);
+    });
+
+    for (size_t i = 0; i < pendingFiles_.size(); ++i) {
+      if (!errors[i].empty()) {
+        if (outError) {
+          *outError = std::move(errors[i]);
+        }
+        return false;
+      }
+      if (!compressed[i].empty()) {
+        fileSizes[i] = compressed[i].size();
+      }
+    }
+  }
+
+  // Optionally store byte-identical payloads once; duplicates share the first copy's range
+  std::vector<size_t> sharedWith;
+  if (options.deduplicate) {
+    timer.emplace(onPhase, Phase::Deduplicate);
+    findDuplicates(fileSizes, compressed, options.threads, sharedWith);
+  }
+  auto isDuplicate = [&sharedWith](size_t i) { return !sharedWith.empty() && sharedWith[i] != i; };
+
+  // Fix the order payloads are stored in; alignment padding adds to the size of the data section
+  std::vector<size_t> order = payloadOrder(options, fileSizes);
+  auto alignedStart = [&](uint64_t pos, size_t fileSize) {
+    if (options.payloadAlignment <= 1 || fileSize == 0 || fileSize < options.alignThreshold) {
+      return pos;
+    }
+    uint64_t mask = options.payloadAlignment - 1;
+    return (pos + mask) & ~mask;
+  };
+  auto payloadsEnd = [&](uint64_t pos) {
+    for (size_t i : order) {
+      if (!isDuplicate(i)) {
+        pos = alignedStart(pos, fileSizes[i]) + fileSizes[i];
+      }
+    }
+    return pos;
+  };
+
+  // Hash the directory up front when a trailer is wanted; its size depends on the table
+  detail::PathIndex trailerIndex;
+  size_t trailerSize = 0;
+  if (options.indexTrailer) {
+    std::vector<EntryView> views;
+    views.reserve(pendingFiles_.size());
+    for (const auto &pending : pendingFiles_) {
+      views.push_back(EntryView{pending.archivePath, 0, 0});
+    }
+    trailerIndex.build(views); // Paths are already unique
+    trailerSize = detail::indexTrailerSize(trailerIndex, pendingFiles_.size());
+  }
+  const size_t checksumSize =
+      options.checksums ? detail::checksumTrailerSize(pendingFiles_.size()) : 0;
+
+  // Pick the layout; 32-bit formats must not silently truncate offsets or sizes
+  const detail::FormatLayout *layout = &detail::layoutOf(options.format);
+  auto archiveSizeFor = [&](const detail::FormatLayout &candidate) {
+    return payloadsEnd(ArchiveHeader::headerSize + 2 * candidate.fieldSize * pendingFiles_.size() +
+                       pathsSize + options.directorySlack) +
+           checksumSize + trailerSize;
+  };
+  uint64_t archiveSize = archiveSizeFor(*layout);
+  if (archiveSize > layout->maxValue()) {
+    if (!options.promoteLarge) {
+      if (outError) {
+        *outError = std::format("Archive size {} exceeds the 4 GiB limit of the {} format "
+                                "(use ArchiveFormat::Big64 or WriteOptions::promoteLarge)",
+                                archiveSize, layout->magic);
+      }
+      return false;
+    }
+    layout = &detail::big64Layout;
+    archiveSize = archiveSizeFor(*layout);
+  }
+  if (archiveSize > SIZE_MAX) {
+    if (outError) {
+      *outError = std::format("Archive size {} is too large to map on this platform", archiveSize);
+    }
+    return false;
+  }
+  const size_t totalSize = static_cast<size_t>(archiveSize);
+  const size_t fieldSize = layout->fieldSize;
+  if (options.indexTrailer &&
+      ArchiveHeader::headerSize + 2 * fieldSize * pendingFiles_.size() + pathsSize > UINT32_MAX) {
+    if (outError) {
+      *outError = "Directory too large for an index trailer";
+    }
+    return false;
+  }
 
   // Step 2: Create memory-mapped file
+  timer.emplace(onPhase, Phase::Map);
   MappedFile outputFile;
   if (!outputFile.openWrite(destPath, totalSize, outError)) {
+    BIGX_COUNT(stats_, ioErrors, 1);
     return false;
   }
 
   auto outputData = outputFile.data();
 
   // Step 3: Write header
-  size_t pos = 0;
-
-  // Magic "BIGF"
-  std::memcpy(outputData.data() + pos, "BIGF", 4);
-  pos += 4;
-
-  // Archive size (big-endian)
-  uint32_t archiveSizeBE = htobe32(static_cast<uint32_t>(totalSize));
-  std::memcpy(outputData.data() + pos, &archiveSizeBE, 4);
-  pos += 4;
-
-  // File count (big-endian)
-  uint32_t fileCountBE = htobe32(static_cast<uint32_t>(pendingFiles_.size()));
-  std::memcpy(outputData.data() + pos, &fileCountBE, 4);
-  pos += 4;
-
-  // Padding
-  uint32_t padding = 0;
-  std::memcpy(outputData.data() + pos, &padding, 4);
-  pos += 4;
+  timer.emplace(onPhase, Phase::WriteDirectory);
+  detail::storeHeader(outputData.data(), *layout, static_cast<uint32_t>(pendingFiles_.size()),
+                      archiveSize);
+  size_t pos = ArchiveHeader::headerSize;
 
   // Step 4: Write directory entries (placeholders for now, we'll come back)
-  size_t directoryStart = pos;
-  for (const auto &pending : pendingFiles_) {
-    // Offset placeholder (will be filled later)
-    pos += 4;
-    // Size placeholder (will be filled later)
-    pos += 4;
+  std::vector<size_t> entryPositions(pendingFiles_.size());
+  for (size_t i = 0; i < pendingFiles_.size(); ++i) {
+    const auto &pending = pendingFiles_[i];
+    entryPositions[i] = pos;
+    // Offset and size placeholders (will be filled later)
+    pos += 2 * fieldSize;
     // Path string (already normalized to forward slashes)
     std::memcpy(outputData.data() + pos, pending.archivePath.data(), pending.archivePath.size());
     pos += pending.archivePath.size();
     // Null terminator
     outputData[pos++] = '\0';
   }
+  const size_t directoryEnd = pos;
+
+  // Step 5: Lay out payloads and fill in directory entries
+  // Every payload's destination range is fixed here, before any data is copied
+  pos += options.directorySlack; // Left zero-filled by the fresh mapping
+  std::vector<size_t> payloadOffsets(pendingFiles_.size());
+  for (size_t i : order) {
+    if (!isDuplicate(i)) {
+      pos = static_cast<size_t>(alignedStart(pos, fileSizes[i])); // Padding stays zero-filled
+      payloadOffsets[i] = pos;
+      pos += fileSizes[i];
+    }
+  }
 
-  // Step 5: Write file data and update directory entries
   entries_.clear();
   entries_.reserve(pendingFiles_.size());
-
   for (size_t i = 0; i < pendingFiles_.size(); ++i) {
     const auto &pending = pendingFiles_[i];
+    size_t fileSize = fileSizes[i];
+    if (isDuplicate(i)) {
+      payloadOffsets[i] = payloadOffsets[sharedWith[i]];
+    }
 
-    // Get file data
-    std::span<const uint8_t> fileData;
-    std::vector<uint8_t> tempBuffer;
+    // Update directory entry
+    size_t entryPos = entryPositions[i];
 
-    if (pending.fromDisk) {
-      // Read from disk
-      std::ifstream inFile(pending.sourcePath, std::ios::binary | std::ios::ate);
-      if (!inFile) {
-        if (outError) {
-          *outError = std::format("Failed to open source file: {}", pending.sourcePath.string());
-        }
-        return false;
-      }
+    // Write offset and size (big-endian; the layout check above guarantees they fit)
+    detail::storeField(outputData.data() + entryPos, fieldSize, payloadOffsets[i]);
+    detail::storeField(outputData.data() + entryPos + fieldSize, fieldSize, fileSize);
 
-      size_t fileSize = inFile.tellg();
-      inFile.seekg(0, std::ios::beg);
+    // Create entry for tracking
+    FileEntry entry;
+    entry.path = pending.archivePath;
+    entry.lowercasePath = detail::foldedPath(pending.archivePath);
+    entry.offset = payloadOffsets[i];
+    entry.size = fileSize;
+    entries_.push_back(std::move(entry));
+  }
 
-      if (fileSize > 0) {
-        tempBuffer.resize(fileSize);
-        if (!inFile.read(reinterpret_cast<char *>(tempBuffer.data()), fileSize)) {
-          if (outError) {
-            *outError = std::format("Failed to read source file: {}", pending.sourcePath.string());
-          }
-          return false;
-        }
-      }
+  // The directory is final, so the prebuilt index can go behind the payloads (and checksums)
+  if (options.indexTrailer) {
+    detail::storeIndexTrailer(outputData.first(directoryEnd), trailerIndex, entryPositions,
+                              outputData.subspan(pos + checksumSize, trailerSize));
+  }
 
-      fileData = tempBuffer;
-    } else {
-      fileData = pending.data;
+  // Step 6: Copy file data into the disjoint payload ranges, possibly in parallel
+  // Ranges never overlap, so the output bytes are identical for any thread count; walking them
+  // in layout order fills the output front to back
+  timer.emplace(onPhase, Phase::CopyPayloads);
+  // Checksums are taken from the output while each payload is still in cache
+  std::vector<std::string> errors(pendingFiles_.size());
+  std::vector<uint32_t> checksums(options.checksums ? pendingFiles_.size() : 0);
+  std::atomic<bool> failed{false};
+  detail::parallelFor(order.size(), options.threads, [&](size_t k) {
+    size_t i = order[k];
+    if (failed.load(std::memory_order_relaxed) || isDuplicate(i)) {
+      return;
+    }
+    std::span<uint8_t> dest = outputData.subspan(payloadOffsets[i], fileSizes[i]);
+    if (!compressed.empty() && !compressed[i].empty()) {
+      std::memcpy(dest.data(), compressed[i].data(), dest.size());
+      std::vector<uint8_t>().swap(compressed[i]); // Release each buffer once it is in the output
+    } else if (!copyPayload(pendingFiles_[i], dest, &errors[i])) {
+      failed.store(true, std::memory_order_relaxed);
+      return;
     }
+    if (!checksums.empty()) {
+      checksums[i] = detail::crc32c(0, dest);
+    }
+  });
 
-    // Write file data
-    if (!fileData.empty()) {
-      std::memcpy(outputData.data() + pos, fileData.data(), fileData.size());
+  if (failed.load()) {
+    BIGX_COUNT(stats_, ioErrors, 1);
+    entries_.clear();
+    // Report the first failing file in archive order
+    for (auto &message : errors) {
+      if (!message.empty()) {
+        if (outError) {
+          *outError = std::move(message);
+        }
+        break;
+      }
     }
+    return false;
+  }
 
-    // Update directory entry
-    size_t entryPos = directoryStart;
-    for (size_t j = 0; j < i; ++j) {
-      entryPos += 8 + pendingFiles_[j].archivePath.size() + 1;
+  if (options.checksums) {
+    for (size_t i = 0; i < checksums.size(); ++i) {
+      if (isDuplicate(i)) {
+        checksums[i] = checksums[sharedWith[i]];
+      }
     }
+    detail::storeChecksumTrailer(outputData.first(directoryEnd), checksums,
+                                 outputData.subspan(pos, checksumSize));
+  }
 
-    // Write offset (big-endian)
-    uint32_t offsetBE = htobe32(static_cast<uint32_t>(pos));
-    std::memcpy(outputData.data() + entryPos, &offsetBE, 4);
+  // Step 7: Flush to disk
+  timer.emplace(onPhase, Phase::Flush);
+  if (!outputFile.flush(outError)) {
+    BIGX_COUNT(stats_, ioErrors, 1);
+    return false;
+  }
 
-    // Write size (big-endian)
-    uint32_t sizeBE = htobe32(static_cast<uint32_t>(fileData.size()));
-    std::memcpy(outputData.data() + entryPos + 4, &sizeBE, 4);
+  *outSize = totalSize;
+  return true;
+}
 
-    // Create entry for tracking
-    FileEntry entry;
-    entry.path = pending.archivePath;
-    entry.lowercasePath = normalizePath(pending.archivePath);
-    entry.offset = pos;
-    entry.size = static_cast<uint32_t>(fileData.size());
-    entries_.push_back(std::move(entry));
+std::vector<size_t> Writer::payloadOrder(const WriteOptions &options,
+                                         std::span<const size_t> sizes) const {
+  std::vector<size_t> order(pendingFiles_.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
 
-    pos += fileData.size();
+  switch (options.payloadOrder) {
+  case PayloadOrder::Insertion:
+    break;
+  case PayloadOrder::Path: {
+    // Sorting folded paths keeps every directory's payloads, and its subdirectories', together
+    std::vector<std::string> keys(pendingFiles_.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      keys[i] = detail::foldedPath(pendingFiles_[i].archivePath);
+    }
+    std::sort(order.begin(), order.end(),
+              [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+    break;
+  }
+  case PayloadOrder::Size:
+    std::stable_sort(order.begin(), order.end(),
+                     [sizes](size_t a, size_t b) { return sizes[a] < sizes[b]; });
+    break;
+  case PayloadOrder::Profile: {
+    // Rank each profiled path by its first appearance; unlisted files keep insertion order
+    std::unordered_map<std::string_view, size_t, detail::PathHash, detail::PathEqual> rankOf;
+    rankOf.reserve(options.accessOrder.size());
+    for (const std::string &path : options.accessOrder) {
+      rankOf.try_emplace(path, rankOf.size());
+    }
+    std::vector<size_t> ranks(pendingFiles_.size(), SIZE_MAX);
+    for (size_t i = 0; i < ranks.size(); ++i) {
+      if (auto it = rankOf.find(pendingFiles_[i].archivePath); it != rankOf.end()) {
+        ranks[i] = it->second;
+      }
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&ranks](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+    break;
   }
+  }
+  return order;
+}
 
-  // Step 6: Flush to disk
-  if (!outputFile.flush(outError)) {
-    return false;
+bool Writer::copyPayload(const PendingFile &pending, std::span<uint8_t> dest,
+                         std::string *outError) {
+  switch (pending.source) {
+  case Source::Disk:
+    // Disk sources are read straight into the mapping
+    return copyFromDisk(pending.sourcePath, dest, outError);
+  case Source::View:
+    if (!dest.empty()) {
+      std::memcpy(dest.data(), pending.view.data(), dest.size());
+    }
+    return true;
+  case Source::Memory:
+    if (!dest.empty()) {
+      std::memcpy(dest.data(), pending.data.data(), dest.size());
+    }
+    return true;
+  }
+  return false;
+}
+
+bool Writer::compressPayload(const PendingFile &pending, size_t size,
+                             std::vector<uint8_t> &outCompressed, std::string *outError) {
+  if (size == 0) {
+    return true;
+  }
+
+  std::span<const uint8_t> raw;
+  MappedFile source;
+  switch (pending.source) {
+  case Source::Disk:
+    if (!source.openRead(pending.sourcePath, outError)) {
+      return false;
+    }
+    raw = source.data();
+    break;
+  case Source::View:
+    raw = pending.view;
+    break;
+  case Source::Memory:
+    raw = pending.data;
+    break;
   }
 
+  // Leave already-compressed payloads alone, and only keep output that actually shrinks
+  // A raw payload that only looks compressed is stored as is; Reader extracts it unchanged
+  if (raw.size() != size || refpack::isCompressed(raw)) {
+    return true;
+  }
+  std::vector<uint8_t> result = refpack::compress(raw);
+  if (!result.empty() && result.size() < raw.size()) {
+    outCompressed = std::move(result);
+  }
   return true;
 }
 
-void Writer::clear() {
-  pendingFiles_.clear();
-  entries_.clear();
+std::span<const uint8_t> Writer::payloadBytes(size_t i,
+                                              const std::vector<std::vector<uint8_t>> &compressed,
+                                              MappedFile &mapping) const {
+  if (!compressed.empty() && !compressed[i].empty()) {
+    return compressed[i];
+  }
+  const auto &pending = pendingFiles_[i];
+  switch (pending.source) {
+  case Source::Disk:
+    if (!mapping.openRead(pending.sourcePath)) {
+      return {};
+    }
+    return mapping.data();
+  case Source::View:
+    return pending.view;
+  case Source::Memory:
+    return pending.data;
+  }
+  return {};
 }
 
-std::string Writer::normalizeSlashes(const std::string &path) {
-  std::string result;
-  result.reserve(path.size());
+void Writer::findDuplicates(std::span<const size_t> sizes,
+                            const std::vector<std::vector<uint8_t>> &compressed,
+                            unsigned threads, std::vector<size_t> &outSharedWith) const {
+  outSharedWith.resize(sizes.size());
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    outSharedWith[i] = i;
+  }
 
-  // Replace backslashes with forward slashes, preserving case
-  for (char c : path) {
-    if (c == '\\') {
-      result += '/';
-    } else {
-      result += c;
+  // Only payloads sharing a (non-zero) size with another one can be duplicates
+  std::unordered_map<size_t, size_t> sizeCounts;
+  for (size_t size : sizes) {
+    if (size > 0) {
+      ++sizeCounts[size];
+    }
+  }
+  std::vector<size_t> candidates;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    if (sizes[i] > 0 && sizeCounts[sizes[i]] > 1) {
+      candidates.push_back(i);
     }
   }
+  if (candidates.empty()) {
+    return;
+  }
+
+  // Hash candidates in parallel; unreadable sources stay unique and fail later in the copy
+  std::vector<std::optional<uint64_t>> hashes(candidates.size());
+  detail::parallelFor(candidates.size(), threads, [&](size_t c) {
+    MappedFile mapping;
+    auto bytes = payloadBytes(candidates[c], compressed, mapping);
+    if (bytes.size() == sizes[candidates[c]]) {
+      hashes[c] = detail::hashBytes(detail::hashSeed, bytes);
+    }
+  });
 
-  return result;
+  // Keep the first payload of each content; later ones are byte-compared before sharing it
+  std::unordered_map<uint64_t, std::vector<size_t>> firstByHash;
+  for (size_t c = 0; c < candidates.size(); ++c) {
+    if (!hashes[c]) {
+      continue;
+    }
+    size_t i = candidates[c];
+    auto &firsts = firstByHash[*hashes[c] ^ sizes[i]];
+    MappedFile mapping;
+    auto bytes = payloadBytes(i, compressed, mapping);
+    for (size_t first : firsts) {
+      MappedFile firstMapping;
+      auto firstBytes = payloadBytes(first, compressed, firstMapping);
+      if (sizes[first] == sizes[i] && bytes.size() == firstBytes.size() &&
+          std::equal(bytes.begin(), bytes.end(), firstBytes.begin())) {
+        outSharedWith[i] = first;
+        break;
+      }
+    }
+    if (outSharedWith[i] == i) {
+      firsts.push_back(i);
+    }
+  }
 }
 
-std::string Writer::normalizePath(const std::string &path) {
-  std::string result;
-  result.reserve(path.size());
+bool Writer::copyFromDisk(const std::filesystem::path &sourcePath, std::span<uint8_t> dest,
+                          std::string *outError) {
+  // Bounded reads directly into the destination; no intermediate buffer is allocated
+  constexpr size_t chunkSize = 4 * 1024 * 1024;
 
-  // Convert to lowercase and replace backslashes with forward slashes
-  for (char c : path) {
-    if (c == '\\') {
-      result += '/';
-    } else {
-      result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  std::ifstream inFile(sourcePath, std::ios::binary);
+  if (!inFile) {
+    if (outError) {
+      *outError = std::format("Failed to open source file: {}", sourcePath.string());
     }
+    return false;
   }
 
-  return result;
+  for (size_t done = 0; done < dest.size();) {
+    size_t chunk = std::min(chunkSize, dest.size() - done);
+    if (!inFile.read(reinterpret_cast<char *>(dest.data() + done),
+                     static_cast<std::streamsize>(chunk))) {
+      if (outError) {
+        *outError = std::format("Failed to read source file: {}", sourcePath.string());
+      }
+      return false;
+    }
+    done += chunk;
+  }
+
+  // The file must not have grown since it was sized
+  if (inFile.peek() != std::ifstream::traits_type::eof()) {
+    if (outError) {
+      *outError = std::format("Source file changed size during write: {}", sourcePath.string());
+    }
+    return false;
+  }
+
+  return true;
+}
+
+void Writer::clear() {
+  pendingFiles_.clear();
+  lowercasePaths_.clear();
+  entries_.clear();
 }
 
 } // namespace bigx
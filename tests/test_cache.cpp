@@ -0,0 +1,131 @@
+#include <filesystem>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bigx/cache.hpp>
+#include <bigx/reader.hpp>
+#include <bigx/writer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class ExtractCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    tempDir_ = fs::temp_directory_path() / "big_test_cache";
+    fs::create_directories(tempDir_);
+
+    // Four 100-byte files with distinct content
+    bigx::Writer writer;
+    for (int i = 0; i < 4; ++i) {
+      writer.addFile(std::vector<uint8_t>(100, static_cast<uint8_t>('a' + i)),
+                     std::format("file{}.bin", i));
+    }
+    archivePath_ = tempDir_ / "cache.big";
+    ASSERT_TRUE(writer.write(archivePath_));
+  }
+
+  void TearDown() override { fs::remove_all(tempDir_); }
+
+  fs::path tempDir_;
+  fs::path archivePath_;
+};
+
+// Test that repeated requests share one buffer
+TEST_F(ExtractCacheTest, HitReturnsSharedBuffer) {
+  auto reader = bigx::Reader::open(archivePath_);
+  ASSERT_TRUE(reader.has_value());
+  const auto &entry = *reader->findFile("file0.bin");
+
+  bigx::ExtractCache cache(1024);
+  auto first = cache.get(*reader, entry);
+  auto second = cache.get(*reader, entry);
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first, second);
+  EXPECT_EQ((*first)[0], 'a');
+
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.bytes, 100);
+  EXPECT_EQ(stats.entries, 1);
+}
+
+// Test least-recently-used eviction under the byte budget
+TEST_F(ExtractCacheTest, EvictsLeastRecentlyUsed) {
+  auto reader = bigx::Reader::open(archivePath_);
+  ASSERT_TRUE(reader.has_value());
+  const auto &files = reader->files();
+
+  bigx::ExtractCache cache(250); // Room for two buffers
+  auto held = cache.get(*reader, files[0]);
+  cache.get(*reader, files[1]);
+  cache.get(*reader, files[0]); // Touch file0 so file1 becomes the LRU victim
+  cache.get(*reader, files[2]);
+
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.evictions, 1);
+  EXPECT_EQ(stats.entries, 2);
+  EXPECT_LE(stats.bytes, 250);
+
+  cache.get(*reader, files[0]);
+  EXPECT_EQ(cache.stats().hits, 2); // file0 survived
+  cache.get(*reader, files[1]);
+  EXPECT_EQ(cache.stats().misses, 4); // file1 was evicted
+
+  // Evicted buffers stay valid for holders
+  cache.clear();
+  EXPECT_EQ((*held)[99], 'a');
+  EXPECT_EQ(cache.stats().bytes, 0);
+}
+
+// Test that oversized payloads bypass the cache and evict(reader) drops its buffers
+TEST_F(ExtractCacheTest, OversizedAndEvictReader) {
+  auto reader = bigx::Reader::open(archivePath_);
+  ASSERT_TRUE(reader.has_value());
+
+  bigx::ExtractCache small(50);
+  EXPECT_NE(small.get(*reader, reader->files()[0]), nullptr);
+  EXPECT_EQ(small.stats().entries, 0);
+
+  bigx::ExtractCache cache(1024);
+  cache.get(*reader, reader->files()[0]);
+  cache.get(*reader, reader->files()[1]);
+  cache.evict(*reader);
+  EXPECT_EQ(cache.stats().entries, 0);
+  EXPECT_EQ(cache.stats().bytes, 0);
+}
+
+// Test concurrent access from several loader threads
+TEST_F(ExtractCacheTest, ConcurrentAccess) {
+  auto reader = bigx::Reader::open(archivePath_);
+  ASSERT_TRUE(reader.has_value());
+
+  bigx::ExtractCache cache(250);
+  std::vector<std::thread> threads;
+  std::vector<int> ok(8, 1);
+  for (size_t t = 0; t < ok.size(); ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < 500; ++i) {
+        const auto &entry = reader->files()[(t + i) % 4];
+        auto buffer = cache.get(*reader, entry);
+        if (!buffer || buffer->size() != 100 || (*buffer)[0] != 'a' + (t + i) % 4) {
+          ok[t] = 0;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  for (int threadOk : ok) {
+    EXPECT_TRUE(threadOk);
+  }
+  auto stats = cache.stats();
+  EXPECT_EQ(stats.hits + stats.misses, 8 * 500);
+  EXPECT_LE(stats.bytes, 250);
+}
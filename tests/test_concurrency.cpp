@@ -0,0 +1,144 @@
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bigx/reader.hpp>
+#include <bigx/trace.hpp>
+#include <bigx/writer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+// Stress tests sharing one Reader between many threads
+// Most useful in a -DBIGX_ENABLE_TSAN=ON build, where ThreadSanitizer reports any data race.
+class ConcurrencyTest : public ::testing::Test {
+protected:
+  static constexpr size_t fileCount = 600;
+  static constexpr unsigned threadCount = 12;
+
+  void SetUp() override {
+    tempDir_ = fs::temp_directory_path() / "big_test_concurrency";
+    fs::create_directories(tempDir_);
+
+    bigx::Writer writer;
+    for (size_t i = 0; i < fileCount; ++i) {
+      std::string content = contentOf(i);
+      ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(content.begin(), content.end()), pathOf(i)));
+    }
+    bigx::WriteOptions options;
+    options.compress = true;
+    archivePath_ = tempDir_ / "shared.big";
+    std::string error;
+    ASSERT_TRUE(writer.write(archivePath_, options, &error)) << error;
+  }
+
+  void TearDown() override { fs::remove_all(tempDir_); }
+
+  static std::string pathOf(size_t i) { return std::format("Data/Dir{}/File{}.ini", i % 7, i); }
+
+  // Compressible for even files, short and stored raw for odd ones
+  static std::string contentOf(size_t i) {
+    return i % 2 == 0 ? std::string(200 + i, static_cast<char>('a' + i % 26))
+                      : std::format("raw {}", i);
+  }
+
+  // Run body(thread) on threadCount threads released together, so first uses race
+  template <typename Body>
+  static void runTogether(Body body) {
+    std::atomic<unsigned> ready{0};
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadCount; ++t) {
+      threads.emplace_back([&, t]() {
+        ready.fetch_add(1);
+        while (ready.load() < threadCount) {
+          std::this_thread::yield();
+        }
+        body(t);
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  fs::path tempDir_;
+  fs::path archivePath_;
+};
+
+// Test lookups, views and extraction from many threads, including the deferred first builds
+TEST_F(ConcurrencyTest, SharedReader) {
+  for (auto mode : {bigx::IndexMode::Standard, bigx::IndexMode::Flat, bigx::IndexMode::Lazy}) {
+    bigx::OpenOptions options;
+    options.index = mode;
+    options.decompress = true;
+    options.trace = std::make_shared<bigx::AccessTrace>();
+    std::string error;
+    auto reader = bigx::Reader::open(archivePath_, options, &error);
+    ASSERT_TRUE(reader.has_value()) << error;
+
+    std::atomic<size_t> failures{0};
+    runTogether([&](unsigned t) {
+      std::vector<uint8_t> buffer(1024);
+      for (size_t n = 0; n < fileCount; ++n) {
+        size_t i = (n * 7 + t * 31) % fileCount; // Each thread walks the files in its own order
+        std::string path = pathOf(i);
+        std::string expected = contentOf(i);
+
+        const bigx::FileEntry *entry = reader->findFile(path);
+        const bigx::EntryView *view = reader->findEntry(path);
+        if (!entry || !view || entry->offset != view->offset ||
+            reader->getFileView(*entry).size() != entry->size) {
+          failures.fetch_add(1);
+          continue;
+        }
+        auto data = reader->extractToMemory(*entry);
+        auto written = reader->extractTo(*entry, buffer);
+        if (!data || std::string(data->begin(), data->end()) != expected || !written ||
+            std::string(buffer.begin(), buffer.begin() + *written) != expected) {
+          failures.fetch_add(1);
+        }
+        if (n % 100 == 0 &&
+            (reader->files().size() != fileCount || reader->glob("Data/Dir3/*.ini").empty() ||
+             !reader->scanFor(path))) {
+          failures.fetch_add(1);
+        }
+      }
+    });
+
+    EXPECT_EQ(failures.load(), 0) << static_cast<int>(mode);
+    bigx::AccessLog log = options.trace->snapshot();
+    EXPECT_EQ(log.paths.size(), fileCount);
+    EXPECT_EQ(log.events.size(), 5 * fileCount * threadCount);
+  }
+}
+
+// Test concurrent bulk extraction next to single-file reads
+TEST_F(ConcurrencyTest, ExtractAllAlongsideReads) {
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath_, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  std::atomic<size_t> failures{0};
+  runTogether([&](unsigned t) {
+    if (t < 2) {
+      bigx::ExtractOptions options;
+      options.threads = 2;
+      auto result = reader->extractAll(tempDir_ / std::format("out{}", t), options);
+      if (!result.ok() || result.extracted != fileCount) {
+        failures.fetch_add(1);
+      }
+      return;
+    }
+    for (size_t i = t; i < fileCount; i += threadCount) {
+      const bigx::FileEntry *entry = reader->findFile(pathOf(i));
+      if (!entry || !reader->prefetch(*entry) || reader->isCompressed(*entry) != (i % 2 == 0)) {
+        failures.fetch_add(1);
+      }
+    }
+  });
+  EXPECT_EQ(failures.load(), 0);
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <bigx/directory_tree.hpp>
+#include <bigx/reader.hpp>
+#include <bigx/writer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class DirectoryTreeTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    for (const char *path : {"Data/INI/GameData.ini", "Data/INI/Object/Tank.ini",
+                             "Data/INI/Object/infantry.ini", "data/ini/armor.ini",
+                             "Art/Textures/b.dds", "Art/Textures/A.DDS", "Art/Textures/c.tga",
+                             "Art/W3D/tank.w3d", "readme.txt"}) {
+      entries_.push_back(bigx::EntryView{path, 0, 0});
+    }
+    tree_.build(entries_);
+  }
+
+  // Paths of a list of entries
+  static std::vector<std::string_view> paths(const std::vector<const bigx::EntryView *> &files) {
+    std::vector<std::string_view> result;
+    for (const auto *entry : files) {
+      result.push_back(entry->path);
+    }
+    return result;
+  }
+
+  std::vector<bigx::EntryView> entries_;
+  bigx::DirectoryTree tree_;
+};
+
+// Test listing immediate children, sorted case-insensitively
+TEST_F(DirectoryTreeTest, ListDirectory) {
+  EXPECT_EQ(tree_.directoryCount(), 6);
+
+  auto root = tree_.list("");
+  ASSERT_TRUE(root.has_value());
+  EXPECT_EQ(root->directories, (std::vector<std::string_view>{"Art", "Data"}));
+  EXPECT_EQ(paths(root->files), (std::vector<std::string_view>{"readme.txt"}));
+
+  // Directories differing only in case are one directory, named as first seen
+  auto ini = tree_.list("DATA\\ini\\");
+  ASSERT_TRUE(ini.has_value());
+  EXPECT_EQ(ini->directories, (std::vector<std::string_view>{"Object"}));
+  EXPECT_EQ(paths(ini->files),
+            (std::vector<std::string_view>{"data/ini/armor.ini", "Data/INI/GameData.ini"}));
+
+  EXPECT_FALSE(tree_.list("Data/Missing").has_value());
+  EXPECT_FALSE(tree_.list("readme.txt").has_value());
+}
+
+// Test recursive iteration order: a directory's files, then its subdirectories
+TEST_F(DirectoryTreeTest, ForEachFile) {
+  std::vector<std::string_view> visited;
+  ASSERT_TRUE(tree_.forEachFile("data", [&](const bigx::EntryView &entry) {
+    visited.push_back(entry.path);
+  }));
+  EXPECT_EQ(visited, (std::vector<std::string_view>{
+                         "data/ini/armor.ini", "Data/INI/GameData.ini",
+                         "Data/INI/Object/infantry.ini", "Data/INI/Object/Tank.ini"}));
+
+  size_t count = 0;
+  ASSERT_TRUE(tree_.forEachFile("", [&](const bigx::EntryView &) { ++count; }));
+  EXPECT_EQ(count, entries_.size());
+  EXPECT_FALSE(tree_.forEachFile("nope", [](const bigx::EntryView &) {}));
+}
+
+// Test glob patterns within and across directories
+TEST_F(DirectoryTreeTest, Glob) {
+  EXPECT_EQ(paths(tree_.glob("art/textures/*.dds")),
+            (std::vector<std::string_view>{"Art/Textures/A.DDS", "Art/Textures/b.dds"}));
+  EXPECT_EQ(paths(tree_.glob("Art/*/t?nk.*")), (std::vector<std::string_view>{"Art/W3D/tank.w3d"}));
+  EXPECT_EQ(paths(tree_.glob("Data/INI/GameData.ini")),
+            (std::vector<std::string_view>{"Data/INI/GameData.ini"}));
+  EXPECT_EQ(paths(tree_.glob("Data/**/*.ini")),
+            (std::vector<std::string_view>{"data/ini/armor.ini", "Data/INI/GameData.ini",
+                                           "Data/INI/Object/infantry.ini",
+                                           "Data/INI/Object/Tank.ini"}));
+  EXPECT_EQ(tree_.glob("**").size(), entries_.size());
+  EXPECT_EQ(paths(tree_.glob("**/Object/**")),
+            (std::vector<std::string_view>{"Data/INI/Object/infantry.ini",
+                                           "Data/INI/Object/Tank.ini"}));
+  EXPECT_EQ(tree_.glob("**/**/*.ini").size(), 4); // No duplicates
+  EXPECT_TRUE(tree_.glob("Art/*.dds").empty());
+  EXPECT_TRUE(tree_.glob("").empty());
+}
+
+// Test that single-path matching agrees with the tree walk
+TEST_F(DirectoryTreeTest, GlobMatch) {
+  for (const char *pattern : {"art/textures/*.dds", "Art/*/t?nk.*", "Data/**/*.ini", "**",
+                              "**/Object/**", "**/**/*.ini", "Art/*.dds", ""}) {
+    std::vector<std::string_view> matched;
+    for (const auto &entry : entries_) {
+      if (bigx::globMatch(pattern, entry.path)) {
+        matched.push_back(entry.path);
+      }
+    }
+    std::vector<std::string_view> expected = paths(tree_.glob(pattern));
+    std::sort(matched.begin(), matched.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(matched, expected) << pattern;
+  }
+  EXPECT_TRUE(bigx::globMatch("data\\ini\\*.INI", "Data/INI/GameData.ini"));
+  EXPECT_FALSE(bigx::globMatch("Data/**", "Data"));
+  EXPECT_FALSE(bigx::globMatch("*.ini", "Data/INI/GameData.ini"));
+}
+
+// Test the Reader entry points
+TEST(DirectoryTreeReaderTest, ReaderTree) {
+  fs::path path = fs::temp_directory_path() / "big_test_directory_tree.big";
+  bigx::Writer writer;
+  std::vector<uint8_t> data = {1, 2, 3};
+  std::string error;
+  ASSERT_TRUE(writer.addFile(data, "Maps\\Alpine\\map.ini", &error)) << error;
+  ASSERT_TRUE(writer.addFile(data, "Maps\\Alpine\\map.tga", &error)) << error;
+  ASSERT_TRUE(writer.addFile(data, "Maps\\Desert\\map.ini", &error)) << error;
+  ASSERT_TRUE(writer.write(path, &error)) << error;
+
+  bigx::OpenOptions options;
+  options.index = bigx::IndexMode::Lazy;
+  auto reader = bigx::Reader::open(path, options, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  auto maps = reader->listDirectory("maps");
+  ASSERT_TRUE(maps.has_value());
+  EXPECT_EQ(maps->directories, (std::vector<std::string_view>{"Alpine", "Desert"}));
+  EXPECT_TRUE(maps->files.empty());
+
+  auto inis = reader->glob("Maps/*/map.ini");
+  ASSERT_EQ(inis.size(), 2);
+  EXPECT_EQ(inis[0]->path, "Maps/Alpine/map.ini");
+  EXPECT_EQ(inis[1], reader->findEntry("maps/desert/MAP.INI"));
+  EXPECT_EQ(reader->tree().directoryCount(), 3);
+
+  reader.reset();
+  fs::remove(path);
+}
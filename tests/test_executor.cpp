@@ -0,0 +1,156 @@
+#include <atomic>
+#include <filesystem>
+#include <format>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <bigx/archive.hpp>
+#include <bigx/executor.hpp>
+#include <bigx/reader.hpp>
+#include <bigx/writer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class AsyncExtractTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    tempDir_ = fs::temp_directory_path() / "big_test_async";
+    fs::create_directories(tempDir_);
+
+    bigx::Writer writer;
+    for (int i = 0; i < 16; ++i) {
+      writer.addFile(std::vector<uint8_t>(64 + i, static_cast<uint8_t>(i)),
+                     std::format("data/file{}.bin", i));
+    }
+    archivePath_ = tempDir_ / "async.big";
+    ASSERT_TRUE(writer.write(archivePath_));
+  }
+
+  void TearDown() override { fs::remove_all(tempDir_); }
+
+  fs::path tempDir_;
+  fs::path archivePath_;
+};
+
+// Executor that runs tasks when asked, to test ordering-independent completion
+class ManualExecutor : public bigx::Executor {
+public:
+  void submit(std::function<void()> task) override { tasks_.push_back(std::move(task)); }
+
+  // Run queued tasks in reverse submission order
+  void drainReversed() {
+    while (!tasks_.empty()) {
+      auto task = std::move(tasks_.back());
+      tasks_.pop_back();
+      task();
+    }
+  }
+
+  size_t pending() const { return tasks_.size(); }
+
+private:
+  std::vector<std::function<void()>> tasks_;
+};
+
+// Test that the pool runs every task and drains on destruction
+TEST(ThreadPoolTest, RunsAllTasks) {
+  std::atomic<int> sum{0};
+  {
+    bigx::ThreadPool pool(4);
+    EXPECT_EQ(pool.threadCount(), 4);
+    for (int i = 1; i <= 100; ++i) {
+      pool.submit([&sum, i]() { sum += i; });
+    }
+  }
+  EXPECT_EQ(sum.load(), 5050);
+}
+
+// Test future-based extraction on the default executor
+TEST_F(AsyncExtractTest, FutureOnDefaultExecutor) {
+  auto reader = bigx::Reader::open(archivePath_);
+  ASSERT_TRUE(reader.has_value());
+
+  std::vector<std::future<bigx::ExtractedFile>> futures;
+  for (const auto &entry : reader->files()) {
+    futures.push_back(reader->extractAsync(entry));
+  }
+
+  for (size_t i = 0; i < futures.size(); ++i) {
+    bigx::ExtractedFile result = futures[i].get();
+    ASSERT_TRUE(result.ok()) << result.error;
+    EXPECT_EQ(result.entry, &reader->files()[i]);
+    EXPECT_EQ(result.data->size(), 64 + i);
+    EXPECT_EQ((*result.data)[0], static_cast<uint8_t>(i));
+  }
+}
+
+// Test callback-based batch extraction on a user-supplied executor
+TEST_F(AsyncExtractTest, BatchOnCustomExecutor) {
+  auto reader = bigx::Reader::open(archivePath_);
+  ASSERT_TRUE(reader.has_value());
+
+  std::vector<const bigx::FileEntry *> batch;
+  for (const auto &entry : reader->files()) {
+    batch.push_back(&entry);
+  }
+
+  ManualExecutor executor;
+  std::vector<const bigx::FileEntry *> completed;
+  reader->extractAsync(
+      batch,
+      [&](bigx::ExtractedFile result) {
+        EXPECT_TRUE(result.ok());
+        EXPECT_EQ(result.data->size(), result.entry->size);
+        completed.push_back(result.entry);
+      },
+      &executor);
+
+  // Nothing runs until the executor does
+  EXPECT_TRUE(completed.empty());
+  EXPECT_EQ(executor.pending(), batch.size());
+
+  executor.drainReversed();
+  ASSERT_EQ(completed.size(), batch.size());
+  EXPECT_EQ(completed.front(), batch.back());
+}
+
+// Test that failures are delivered as results, not lost
+TEST_F(AsyncExtractTest, FailureReported) {
+  auto reader = bigx::Reader::open(archivePath_);
+  ASSERT_TRUE(reader.has_value());
+
+  bigx::FileEntry bogus;
+  bogus.path = "bogus.bin";
+  bogus.offset = 1u << 30;
+  bogus.size = 10;
+
+  bigx::ThreadPool pool(1);
+  std::promise<bigx::ExtractedFile> delivered;
+  reader->extractAsync(
+      bogus, [&](bigx::ExtractedFile result) { delivered.set_value(std::move(result)); }, &pool);
+
+  bigx::ExtractedFile result = delivered.get_future().get();
+  EXPECT_FALSE(result.ok());
+  EXPECT_FALSE(result.error.empty());
+}
+
+// Test the Archive forwarding, including the not-reading case
+TEST_F(AsyncExtractTest, ArchiveForwarding) {
+  auto archive = bigx::Archive::open(archivePath_);
+  ASSERT_TRUE(archive.has_value());
+  const auto *entry = archive->findFile("data/file3.bin");
+  ASSERT_NE(entry, nullptr);
+
+  auto result = archive->extractAsync(*entry).get();
+  ASSERT_TRUE(result.ok()) << result.error;
+  EXPECT_EQ(result.data->size(), 67);
+
+  auto writing = bigx::Archive::create();
+  auto failed = writing.extractAsync(*entry).get();
+  EXPECT_FALSE(failed.ok());
+  EXPECT_EQ(failed.error, "Archive not open for reading");
+}
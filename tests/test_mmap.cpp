@@ -195,3 +195,29 @@ TEST_F(MappedFileTest, LargeFile) {
   EXPECT_EQ(data[fileSize / 2], content[fileSize / 2]);
   EXPECT_EQ(data[fileSize - 1], content[fileSize - 1]);
 }
+
+// Test access-pattern hints and prefetching
+TEST_F(MappedFileTest, AdviseAndPrefetch) {
+  std::vector<uint8_t> content(3 * 4096 + 17, 0x5A);
+  fs::path filePath = createTestFile("test_advise.bin", content);
+
+  bigx::MappedFile mappedFile;
+  EXPECT_FALSE(mappedFile.prefetch(0, 10)); // Not open
+  EXPECT_FALSE(mappedFile.advise(bigx::AccessPattern::Random));
+
+  std::string error;
+  ASSERT_TRUE(mappedFile.openRead(filePath, &error)) << error;
+
+  EXPECT_TRUE(mappedFile.advise(bigx::AccessPattern::Sequential));
+  EXPECT_TRUE(mappedFile.advise(bigx::AccessPattern::Random, 4100, 10)); // Unaligned range
+  EXPECT_TRUE(mappedFile.advise(bigx::AccessPattern::Normal));
+
+  EXPECT_TRUE(mappedFile.prefetch(5000, 8000)); // Clamped to the mapping
+  EXPECT_TRUE(mappedFile.prefetch(content.size() + 1, 10)); // Past the end: nothing to do
+
+  std::vector<bigx::MappedRange> ranges = {{0, 100}, {8192, 4096}};
+  EXPECT_TRUE(mappedFile.prefetch(ranges));
+
+  // Hints never change the data
+  EXPECT_EQ(mappedFile.data()[content.size() - 1], 0x5A);
+}
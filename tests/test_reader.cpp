@@ -1,6 +1,11 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <memory_resource>
+#include <string_view>
 #include <vector>
 
 #include <bigx/endian.hpp>
@@ -21,16 +26,7 @@ protected:
 
   // Create a minimal valid BIG archive for testing
   fs::path createTestArchive(const std::string &name) {
-    fs::path filePath = tempDir_ / name;
-
     // Create a simple BIG archive with a few test files
-    std::ofstream file(filePath, std::ios::binary);
-
-    // Header: "BIGF" + archiveSize (4) + fileCount (4) + padding (4)
-    uint32_t fileCount = 3; // 3 test files
-    uint32_t headerSize = 16;
-
-    // Calculate sizes for directory
     std::vector<std::string> paths = {"test/file1.txt", "test/file2.dat", "test/subdir/file3.bin"};
 
     std::vector<std::vector<uint8_t>> fileContents = {
@@ -39,6 +35,19 @@ protected:
         {'A', 'B', 'C'}
     };
 
+    return createArchive(name, paths, fileContents);
+  }
+
+  // Create a BIG archive with the given paths and contents
+  fs::path createArchive(const std::string &name, const std::vector<std::string> &paths,
+                         const std::vector<std::vector<uint8_t>> &fileContents) {
+    fs::path filePath = tempDir_ / name;
+    std::ofstream file(filePath, std::ios::binary);
+
+    // Header: "BIGF" + archiveSize (4) + fileCount (4) + padding (4)
+    uint32_t fileCount = static_cast<uint32_t>(paths.size());
+    uint32_t headerSize = 16;
+
     // Calculate directory size
     size_t directorySize = 0;
     for (const auto &path : paths) {
@@ -91,6 +100,12 @@ protected:
     return filePath;
   }
 
+  // Read a whole file from disk
+  static std::string readFile(const fs::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  }
+
   fs::path tempDir_;
 };
 
@@ -147,6 +162,11 @@ TEST_F(ReaderTest, FileLookup) {
   const auto *file4 = reader->findFile("test\\file1.txt"); // Backslash
   ASSERT_NE(file4, nullptr);
 
+  // View into a larger buffer, not null-terminated at the path's end
+  std::string_view buffer = "TEST/FILE1.TXT.bak";
+  EXPECT_EQ(reader->findFile(buffer.substr(0, 14)), file1);
+  EXPECT_EQ(reader->findFile(buffer), nullptr);
+
   // Test non-existent file
   const auto *file5 = reader->findFile("does/not/exist.txt");
   EXPECT_EQ(file5, nullptr);
@@ -191,6 +211,64 @@ TEST_F(ReaderTest, ExtractToMemory) {
   EXPECT_EQ((*data)[2], 2);
 }
 
+// Test extraction into caller-provided buffers
+TEST_F(ReaderTest, ExtractToBuffer) {
+  fs::path archivePath = createTestArchive("test.big");
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  const auto *file = reader->findFile("test/file2.dat");
+  ASSERT_NE(file, nullptr);
+  EXPECT_EQ(reader->extractedSize(*file), 6);
+
+  // Extra space is left untouched
+  std::array<uint8_t, 8> buffer;
+  buffer.fill(0xEE);
+  auto written = reader->extractTo(*file, buffer, &error);
+  ASSERT_TRUE(written.has_value()) << error;
+  EXPECT_EQ(*written, 6);
+  EXPECT_EQ(buffer, (std::array<uint8_t, 8>{0, 1, 2, 3, 4, 5, 0xEE, 0xEE}));
+
+  // Exact fit
+  ASSERT_TRUE(reader->extractTo(*file, std::span(buffer).first(6), &error).has_value()) << error;
+
+  // Too small: fails without writing
+  buffer.fill(0xEE);
+  EXPECT_FALSE(reader->extractTo(*file, std::span(buffer).first(5), &error).has_value());
+  EXPECT_NE(error.find("need 6, have 5"), std::string::npos) << error;
+  EXPECT_EQ(buffer[0], 0xEE);
+
+  bigx::FileEntry bogus{"bogus", "bogus", 1000, 10};
+  EXPECT_FALSE(reader->extractTo(bogus, buffer, &error).has_value());
+  EXPECT_EQ(reader->extractedSize(bogus), 0);
+}
+
+// Test extraction into a PMR container
+TEST_F(ReaderTest, ExtractToMemoryResource) {
+  fs::path archivePath = createTestArchive("test.big");
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  // Every allocation is served from the stack arena
+  std::array<std::byte, 256> arena;
+  std::pmr::monotonic_buffer_resource resource(arena.data(), arena.size(),
+                                               std::pmr::null_memory_resource());
+
+  for (const auto &entry : reader->files()) {
+    auto data = reader->extractToMemory(entry, resource, &error);
+    ASSERT_TRUE(data.has_value()) << error;
+    EXPECT_EQ(data->get_allocator().resource(), &resource);
+
+    auto expected = reader->extractToMemory(entry, &error);
+    ASSERT_TRUE(expected.has_value()) << error;
+    EXPECT_TRUE(std::equal(data->begin(), data->end(), expected->begin(), expected->end()));
+  }
+}
+
 // Test extract to disk
 TEST_F(ReaderTest, ExtractToDisk) {
   fs::path archivePath = createTestArchive("test.big");
@@ -212,6 +290,86 @@ TEST_F(ReaderTest, ExtractToDisk) {
   EXPECT_EQ(std::string(content.data(), 5), "Hello");
 }
 
+// Test that BIG4 archives (BIGF layout, different magic) are read
+TEST_F(ReaderTest, Big4Archive) {
+  fs::path archivePath = createTestArchive("test.big");
+  {
+    std::fstream file(archivePath, std::ios::binary | std::ios::in | std::ios::out);
+    file.write("BIG4", 4);
+  }
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_EQ(reader->format(), bigx::ArchiveFormat::Big4);
+  EXPECT_EQ(reader->fileCount(), 3);
+
+  auto data = reader->extractToMemory(*reader->findFile("test/file1.txt"), &error);
+  ASSERT_TRUE(data.has_value()) << error;
+  EXPECT_EQ(*data, (std::vector<uint8_t>{'H', 'e', 'l', 'l', 'o'}));
+}
+
+// Test that 64-bit records whose offset + size would wrap around are rejected
+TEST_F(ReaderTest, Big64OverflowingEntryRejected) {
+  std::vector<uint8_t> bytes(64, 0);
+  std::memcpy(bytes.data(), "BIGX", 4);
+  uint32_t fileCountBE = bigx::htobe32(1);
+  uint64_t archiveSizeBE = bigx::htobe64(bytes.size());
+  uint64_t offsetBE = bigx::htobe64(UINT64_MAX - 4);
+  uint64_t sizeBE = bigx::htobe64(16);
+  std::memcpy(bytes.data() + 4, &fileCountBE, 4);
+  std::memcpy(bytes.data() + 8, &archiveSizeBE, 8);
+  std::memcpy(bytes.data() + 16, &offsetBE, 8);
+  std::memcpy(bytes.data() + 24, &sizeBE, 8);
+  std::memcpy(bytes.data() + 32, "a.bin", 6);
+
+  fs::path archivePath = tempDir_ / "overflow.big";
+  std::ofstream(archivePath, std::ios::binary)
+      .write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+
+  std::string error;
+  EXPECT_FALSE(bigx::Reader::open(archivePath, &error).has_value());
+  EXPECT_NE(error.find("invalid offset/size"), std::string::npos) << error;
+
+  // The lazy single-lookup scan applies the same check
+  bigx::OpenOptions options;
+  options.index = bigx::IndexMode::Lazy;
+  auto lazy = bigx::Reader::open(archivePath, options, &error);
+  ASSERT_TRUE(lazy.has_value()) << error;
+  EXPECT_EQ(lazy->format(), bigx::ArchiveFormat::Big64);
+  EXPECT_FALSE(lazy->scanFor("a.bin").has_value());
+}
+
+// Test that damaged records are reported precisely once the fast directory scan gives up
+TEST_F(ReaderTest, DirectoryErrorsReported) {
+  auto openBytes = [](std::string bytes) {
+    std::string error;
+    auto data = std::span(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size());
+    EXPECT_FALSE(bigx::Reader::openFromMemory(data, &error).has_value());
+    return error;
+  };
+  std::string bytes = readFile(createArchive("damaged.big", {"a.txt", "b.txt"}, {{}, {}}));
+
+  // Last name runs off the end of the file
+  std::string unterminated = bytes;
+  unterminated.back() = 'x';
+  EXPECT_EQ(openBytes(unterminated), "File entry 1 has unterminated path string");
+
+  // Second record's offset points past the end
+  std::string outOfRange = bytes;
+  uint32_t offsetBE = bigx::htobe32(static_cast<uint32_t>(bytes.size() + 1));
+  std::memcpy(outOfRange.data() + 16 + 14, &offsetBE, 4);
+  EXPECT_NE(openBytes(outOfRange).find("File entry 1 has invalid offset/size"), std::string::npos);
+
+  // Well-formed archives still take the fast path end to end
+  std::string error;
+  auto reader = bigx::Reader::openFromMemory(
+      std::span(reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()), &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_EQ(reader->fileCount(), 2);
+  EXPECT_EQ(reader->findFile("b.txt")->offset, 16 + 2 * 14);
+}
+
 // Test opening invalid archive
 TEST_F(ReaderTest, InvalidArchive) {
   fs::path invalidPath = tempDir_ / "invalid.big";
@@ -267,3 +425,349 @@ TEST_F(ReaderTest, Close) {
   reader->close();
   EXPECT_FALSE(reader->isOpen());
 }
+
+// Test bulk extraction of every file
+TEST_F(ReaderTest, ExtractAll) {
+  fs::path archivePath = createTestArchive("test.big");
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  bigx::ExtractOptions options;
+  options.threads = 4;
+  fs::path outDir = tempDir_ / "all";
+  auto result = reader->extractAll(outDir, options);
+
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.extracted, 3);
+  EXPECT_EQ(result.bytesWritten, 14);
+  EXPECT_EQ(readFile(outDir / "test/file1.txt"), "Hello");
+  EXPECT_EQ(readFile(outDir / "test/subdir/file3.bin"), "ABC");
+  EXPECT_EQ(fs::file_size(outDir / "test/file2.dat"), 6);
+}
+
+// Test bulk extraction with a predicate and with an explicit entry list
+TEST_F(ReaderTest, ExtractAllFiltered) {
+  fs::path archivePath = createTestArchive("test.big");
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  fs::path predicateDir = tempDir_ / "predicate";
+  auto byPredicate = reader->extractAll(predicateDir, [](const bigx::FileEntry &entry) {
+    return entry.path.ends_with(".txt");
+  });
+  EXPECT_TRUE(byPredicate.ok());
+  EXPECT_EQ(byPredicate.extracted, 1);
+  EXPECT_TRUE(fs::exists(predicateDir / "test/file1.txt"));
+  EXPECT_FALSE(fs::exists(predicateDir / "test/file2.dat"));
+
+  fs::path listDir = tempDir_ / "list";
+  std::vector<const bigx::FileEntry *> entries = {reader->findFile("test/file2.dat")};
+  auto byList = reader->extractAll(listDir, entries);
+  EXPECT_TRUE(byList.ok());
+  EXPECT_EQ(byList.extracted, 1);
+  EXPECT_TRUE(fs::exists(listDir / "test/file2.dat"));
+  EXPECT_FALSE(fs::exists(listDir / "test/file1.txt"));
+}
+
+// Test that bulk extraction reports failures per entry and keeps going
+TEST_F(ReaderTest, ExtractAllReportsFailures) {
+  fs::path archivePath =
+      createArchive("unsafe.big", {"../escape.txt", "safe/file.txt"}, {{'X'}, {'Y'}});
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  fs::path outDir = tempDir_ / "out";
+  auto result = reader->extractAll(outDir);
+
+  EXPECT_FALSE(result.ok());
+  EXPECT_EQ(result.extracted, 1);
+  ASSERT_EQ(result.failures.size(), 1);
+  EXPECT_EQ(result.failures[0].entry->path, "../escape.txt");
+  EXPECT_FALSE(result.failures[0].error.empty());
+  EXPECT_FALSE(fs::exists(tempDir_ / "escape.txt"));
+  EXPECT_EQ(readFile(outDir / "safe/file.txt"), "Y");
+}
+
+// Test that the batched native backend and the portable backend produce the same files
+TEST_F(ReaderTest, ExtractAllBackendsMatch) {
+  std::vector<std::string> paths;
+  std::vector<std::vector<uint8_t>> contents;
+  for (int i = 0; i < 600; ++i) { // More than one io_uring batch
+    paths.push_back(std::format("dir{}/file{}.bin", i % 7, i));
+    contents.push_back(std::vector<uint8_t>(static_cast<size_t>(i % 5 == 0 ? 0 : i * 13),
+                                            static_cast<uint8_t>(i)));
+  }
+  fs::path archivePath = createArchive("many.big", paths, contents);
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  // An existing longer file must be truncated, and a directory in the way must fail cleanly
+  fs::path batchedDir = tempDir_ / "batched";
+  fs::create_directories(batchedDir / "dir1");
+  { std::ofstream(batchedDir / "dir1/file1.bin") << std::string(4096, 'Z'); }
+  fs::create_directories(batchedDir / "dir2/file2.bin");
+
+  bigx::ExtractOptions options;
+  options.threads = 3;
+  options.backend = bigx::ExtractBackend::Batched;
+  auto batched = reader->extractAll(batchedDir, options);
+  RecordProperty("native", bigx::Reader::batchedExtractSupported() ? "yes" : "no");
+  ASSERT_EQ(batched.failures.size(), 1);
+  EXPECT_EQ(batched.failures[0].entry->path, "dir2/file2.bin");
+  EXPECT_EQ(batched.extracted, 599);
+
+  options.backend = bigx::ExtractBackend::Portable;
+  fs::path portableDir = tempDir_ / "portable";
+  auto portable = reader->extractAll(portableDir, options);
+  ASSERT_TRUE(portable.ok());
+  EXPECT_EQ(batched.bytesWritten + contents[2].size(), portable.bytesWritten);
+
+  for (size_t i = 0; i < paths.size(); ++i) {
+    if (i == 2) {
+      continue;
+    }
+    std::string expected(contents[i].begin(), contents[i].end());
+    ASSERT_EQ(readFile(batchedDir / paths[i]), expected) << paths[i];
+    ASSERT_EQ(readFile(portableDir / paths[i]), expected) << paths[i];
+  }
+}
+
+// Test flat index mode lookups without FileEntry materialization
+TEST_F(ReaderTest, FlatIndexLookup) {
+  fs::path archivePath = createTestArchive("test.big");
+
+  bigx::OpenOptions options;
+  options.index = bigx::IndexMode::Flat;
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, options, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_EQ(reader->fileCount(), 3);
+
+  const auto *entry = reader->findEntry("TEST\\SUBDIR\\FILE3.BIN");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->path, "test/subdir/file3.bin");
+  EXPECT_EQ(entry->size, 3);
+
+  auto view = reader->getFileView(*entry);
+  ASSERT_EQ(view.size(), 3);
+  EXPECT_EQ(view[0], 'A');
+
+  EXPECT_EQ(reader->findEntry("test/missing.bin"), nullptr);
+
+  // FileEntry objects are still available on demand and agree with the views
+  const auto &files = reader->files();
+  ASSERT_EQ(files.size(), reader->entries().size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    EXPECT_EQ(files[i].path, reader->entries()[i].path);
+    EXPECT_EQ(files[i].offset, reader->entries()[i].offset);
+  }
+  EXPECT_EQ(reader->findFile("Test/File1.txt"), &files[0]);
+}
+
+// Test that paths differing only in case or slash style are rejected as duplicates
+TEST_F(ReaderTest, DuplicatePathRejected) {
+  fs::path archivePath =
+      createArchive("dup.big", {"data/File.txt", "DATA\\file.TXT"}, {{'a'}, {'b'}});
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  EXPECT_FALSE(reader.has_value());
+  EXPECT_NE(error.find("Duplicate"), std::string::npos);
+}
+
+// Test folding of paths long enough to take the vector kernels, including non-ASCII bytes
+TEST_F(ReaderTest, LongPathFolding) {
+  std::string stored =
+      "Art\\Textures\\Units\\Infantry\\Ranger_Camo_\xC3\x89t\xC3\xA9_Variant_07.TGA";
+  fs::path archivePath = createArchive("long.big", {stored}, {{'x'}});
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  std::string slashed = stored;
+  std::replace(slashed.begin(), slashed.end(), '\\', '/');
+  EXPECT_EQ(reader->files()[0].path, slashed);
+  EXPECT_EQ(reader->files()[0].lowercasePath,
+            "art/textures/units/infantry/ranger_camo_\xC3\x89t\xC3\xA9_variant_07.tga");
+
+  // Non-ASCII bytes are compared exactly, everything else case- and slash-insensitively
+  std::string dir = "ART/TEXTURES/UNITS/INFANTRY/";
+  EXPECT_NE(reader->findFile(dir + "RANGER_CAMO_\xC3\x89T\xC3\xA9_VARIANT_07.TGA"), nullptr);
+  EXPECT_EQ(reader->findFile(dir + "ranger_camo_\xC3\xA9t\xC3\xA9_variant_07.tga"), nullptr);
+  EXPECT_EQ(reader->findFile(dir + "ranger_camo_\xC3\x89t\xC3\xA9_variant_08.tga"), nullptr);
+}
+
+// Test lazy open: lookups work by scan before the index exists, and the index builds on demand
+TEST_F(ReaderTest, LazyOpen) {
+  fs::path archivePath = createTestArchive("test.big");
+
+  bigx::OpenOptions options;
+  options.index = bigx::IndexMode::Lazy;
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, options, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  auto scanned = reader->scanFor("Test/File2.dat");
+  ASSERT_TRUE(scanned.has_value());
+  EXPECT_EQ(scanned->size, 6);
+  EXPECT_EQ(reader->getFileView(*scanned)[5], 5);
+  EXPECT_FALSE(reader->scanFor("test/nope.dat").has_value());
+
+  const auto *file = reader->findFile("test/subdir/file3.bin");
+  ASSERT_NE(file, nullptr);
+  EXPECT_EQ(file->size, 3);
+  EXPECT_EQ(reader->fileCount(), 3);
+  EXPECT_TRUE(reader->indexError().empty());
+}
+
+// Test that a lazily opened archive with a corrupt directory reports the deferred error
+TEST_F(ReaderTest, LazyOpenCorruptDirectory) {
+  fs::path archivePath =
+      createArchive("corrupt.big", {"a.txt", "A.TXT"}, {{'1'}, {'2'}}); // duplicate paths
+
+  bigx::OpenOptions options;
+  options.index = bigx::IndexMode::Lazy;
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, options, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  EXPECT_EQ(reader->fileCount(), 0);
+  EXPECT_EQ(reader->findFile("a.txt"), nullptr);
+  EXPECT_FALSE(reader->indexError().empty());
+}
+
+// Test entry prefetching and access hints
+TEST_F(ReaderTest, Prefetch) {
+  fs::path archivePath = createTestArchive("test.big");
+
+  bigx::OpenOptions options;
+  options.access = bigx::AccessPattern::Random;
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, options, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  EXPECT_TRUE(reader->prefetch(*reader->findFile("test/file1.txt")));
+
+  std::vector<const bigx::FileEntry *> next = {reader->findFile("test/file2.dat"),
+                                               reader->findFile("test/subdir/file3.bin")};
+  EXPECT_TRUE(reader->prefetch(next));
+  EXPECT_TRUE(reader->advise(bigx::AccessPattern::Sequential));
+
+  bigx::FileEntry bogus;
+  bogus.offset = 1u << 30;
+  bogus.size = 10;
+  EXPECT_FALSE(reader->prefetch(bogus));
+}
+
+// Test opening archives from memory, including one nested inside another
+TEST_F(ReaderTest, OpenFromMemory) {
+  std::string child = readFile(createTestArchive("child.big"));
+  std::vector<uint8_t> childContent(child.begin(), child.end());
+  fs::path parentPath =
+      createArchive("parent.big", {"readme.txt", "nested/child.big"}, {{'h', 'i'}, childContent});
+
+  std::string error;
+  auto parent = bigx::Reader::open(parentPath, &error);
+  ASSERT_TRUE(parent.has_value()) << error;
+  std::span<const uint8_t> childBytes = parent->getFileView(*parent->findFile("nested/child.big"));
+
+  auto nested = bigx::Reader::openFromMemory(childBytes, &error);
+  ASSERT_TRUE(nested.has_value()) << error;
+  EXPECT_TRUE(nested->isOpen());
+  EXPECT_EQ(nested->fileCount(), 3);
+
+  // Views and paths point straight into the parent's mapping
+  const bigx::FileEntry *entry = nested->findFile("TEST/FILE1.TXT");
+  ASSERT_NE(entry, nullptr);
+  std::span<const uint8_t> view = nested->getFileView(*entry);
+  EXPECT_GE(view.data(), childBytes.data());
+  EXPECT_LE(view.data() + view.size(), childBytes.data() + childBytes.size());
+  EXPECT_EQ(std::string(view.begin(), view.end()), "Hello");
+  auto data = nested->extractToMemory(*nested->findFile("test/subdir/file3.bin"));
+  ASSERT_TRUE(data.has_value());
+  EXPECT_EQ(std::string(data->begin(), data->end()), "ABC");
+
+  // A truncated buffer is rejected like a truncated file
+  EXPECT_FALSE(bigx::Reader::openFromMemory(childBytes.first(20), &error).has_value());
+  EXPECT_FALSE(error.empty());
+}
+
+// Test reading an archive through a positioned-read source
+TEST_F(ReaderTest, OpenFromSource) {
+  // In-memory source that counts the bytes it serves
+  class CountingSource : public bigx::ByteSource {
+  public:
+    explicit CountingSource(std::string bytes) : bytes_(std::move(bytes)) {}
+    uint64_t size() const override { return bytes_.size(); }
+    bool read(uint64_t offset, std::span<uint8_t> out, std::string *outError) const override {
+      if (failing) {
+        if (outError) {
+          *outError = "Source unavailable";
+        }
+        return false;
+      }
+      std::memcpy(out.data(), bytes_.data() + offset, out.size());
+      served += out.size();
+      return true;
+    }
+    mutable size_t served = 0;
+    bool failing = false;
+
+  private:
+    std::string bytes_;
+  };
+
+  // Large payloads behind a small directory, so the first read does not cover them
+  std::vector<uint8_t> big(200000, 'x');
+  std::string bytes = readFile(createArchive("remote.big", {"a.txt", "big.bin", "empty.txt"},
+                                             {{'a', 'b', 'c'}, big, {}}));
+  auto source = std::make_shared<CountingSource>(bytes);
+
+  std::string error;
+  auto reader = bigx::Reader::openFromSource(source, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_EQ(reader->fileCount(), 3);
+  EXPECT_LT(source->served, bytes.size() / 2);
+
+  const bigx::FileEntry *entry = reader->findFile("big.bin");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_TRUE(reader->getFileView(*entry).empty());
+  EXPECT_FALSE(reader->isCompressed(*entry));
+  EXPECT_EQ(reader->extractedSize(*entry), big.size());
+  auto data = reader->extractToMemory(*entry, &error);
+  ASSERT_TRUE(data.has_value()) << error;
+  EXPECT_EQ(*data, big);
+  std::array<uint8_t, 8> buffer{};
+  auto written = reader->extractTo(*reader->findFile("a.txt"), buffer, &error);
+  ASSERT_TRUE(written.has_value()) << error;
+  EXPECT_EQ(std::string(buffer.begin(), buffer.begin() + *written), "abc");
+
+  auto result = reader->extractAll(tempDir_ / "out");
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.extracted, 3);
+  EXPECT_EQ(readFile(tempDir_ / "out" / "a.txt"), "abc");
+  EXPECT_TRUE(reader->verify().ok());
+  EXPECT_FALSE(reader->hasChecksums());
+
+  // Read failures surface as extraction errors
+  source->failing = true;
+  EXPECT_FALSE(reader->extractToMemory(*entry, &error).has_value());
+  EXPECT_EQ(error, "Source unavailable");
+  EXPECT_EQ(reader->extractToMemory(*reader->findFile("empty.txt"))->size(), 0);
+
+  EXPECT_FALSE(bigx::Reader::openFromSource(source, &error).has_value());
+  EXPECT_FALSE(bigx::Reader::openFromSource(nullptr, &error).has_value());
+}
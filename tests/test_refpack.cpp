@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <bigx/refpack.hpp>
+
+#include <gtest/gtest.h>
+
+namespace {
+
+std::vector<uint8_t> roundTrip(const std::vector<uint8_t> &input) {
+  auto packed = bigx::refpack::compress(input);
+  EXPECT_TRUE(bigx::refpack::isCompressed(packed));
+  EXPECT_EQ(bigx::refpack::uncompressedSize(packed), input.size());
+
+  std::string error;
+  auto unpacked = bigx::refpack::decompress(packed, &error);
+  EXPECT_TRUE(unpacked.has_value()) << error;
+  return unpacked.value_or(std::vector<uint8_t>{});
+}
+
+} // namespace
+
+// Test decoding a hand-assembled stream with an overlapping match
+TEST(RefPackTest, DecodeKnownStream) {
+  // "abc" literal + match (distance 3, length 6) + end
+  std::vector<uint8_t> stream = {0x10, 0xFB, 0x00, 0x00, 0x09, 0x0F, 0x02, 'a', 'b', 'c', 0xFC};
+
+  std::string error;
+  auto decoded = bigx::refpack::decompress(stream, &error);
+  ASSERT_TRUE(decoded.has_value()) << error;
+  EXPECT_EQ(std::string(decoded->begin(), decoded->end()), "abcabcabc");
+}
+
+// Test header detection
+TEST(RefPackTest, DetectHeader) {
+  EXPECT_TRUE(bigx::refpack::isCompressed(std::vector<uint8_t>{0x10, 0xFB, 0, 0, 0}));
+  EXPECT_TRUE(bigx::refpack::isCompressed(std::vector<uint8_t>{0x11, 0xFB, 0, 0, 0, 0, 0, 0}));
+  EXPECT_FALSE(bigx::refpack::isCompressed(std::vector<uint8_t>{'B', 'I', 'G', 'F'}));
+  EXPECT_FALSE(bigx::refpack::isCompressed(std::vector<uint8_t>{0x10, 0xFB}));
+  EXPECT_FALSE(bigx::refpack::uncompressedSize(std::vector<uint8_t>{}).has_value());
+}
+
+// Test that a header declaring more output than the stream could expand to is rejected
+TEST(RefPackTest, RejectImpossibleSizes) {
+  // Declares 4 GiB with no commands at all
+  std::vector<uint8_t> huge = {0x90, 0xFB, 0xFF, 0xFF, 0xFF, 0xFF};
+  EXPECT_FALSE(bigx::refpack::isCompressed(huge));
+  EXPECT_FALSE(bigx::refpack::uncompressedSize(huge).has_value());
+  std::string error;
+  EXPECT_FALSE(bigx::refpack::decompress(huge, &error).has_value());
+  EXPECT_FALSE(error.empty());
+
+  // One stream byte expands to at most 257 bytes
+  std::vector<uint8_t> limit = {0x10, 0xFB, 0x00, 0x01, 0x01, 0xFC};
+  EXPECT_EQ(bigx::refpack::uncompressedSize(limit), 257);
+  limit[4] = 0x02;
+  EXPECT_FALSE(bigx::refpack::isCompressed(limit));
+
+  // Only the head of a stream is needed when its full size is known
+  std::vector<uint8_t> runs(100000, 'x');
+  auto packed = bigx::refpack::compress(runs);
+  auto head = std::span<const uint8_t>(packed).first(8);
+  EXPECT_FALSE(bigx::refpack::isCompressed(head));
+  EXPECT_TRUE(bigx::refpack::isCompressed(head, packed.size()));
+  EXPECT_EQ(bigx::refpack::uncompressedSize(head, packed.size()), runs.size());
+}
+
+// Test round trips over inputs that exercise every command type
+TEST(RefPackTest, RoundTrip) {
+  EXPECT_TRUE(roundTrip({}).empty());
+
+  std::vector<uint8_t> tiny = {1, 2};
+  EXPECT_EQ(roundTrip(tiny), tiny);
+
+  std::vector<uint8_t> runs(100000, 'x');
+  auto packed = bigx::refpack::compress(runs);
+  EXPECT_LT(packed.size(), runs.size() / 50);
+  EXPECT_EQ(roundTrip(runs), runs);
+
+  std::string text;
+  for (int i = 0; i < 5000; ++i) {
+    text += "Object " + std::to_string(i % 113) + " { Side = America; Cost = 500 }\n";
+  }
+  std::vector<uint8_t> textData(text.begin(), text.end());
+  EXPECT_EQ(roundTrip(textData), textData);
+
+  std::mt19937 rng(1234);
+  std::vector<uint8_t> noise(300000 + 89000);
+  for (size_t i = 0; i < 300000; ++i) {
+    noise[i] = static_cast<uint8_t>(rng());
+  }
+  // Repeat a block far back so long-distance matches are used
+  std::copy(noise.begin() + 1000, noise.begin() + 90000, noise.begin() + 300000);
+  EXPECT_EQ(roundTrip(noise), noise);
+}
+
+// Test that payloads above 16 MiB use the 4-byte size header
+TEST(RefPackTest, LargeSizeHeader) {
+  std::vector<uint8_t> big(17 * 1024 * 1024);
+  for (size_t i = 0; i < big.size(); ++i) {
+    big[i] = static_cast<uint8_t>(i / 4096);
+  }
+  auto packed = bigx::refpack::compress(big);
+  EXPECT_TRUE(packed[0] & 0x80);
+  EXPECT_EQ(roundTrip(big), big);
+}
+
+// Test that corrupt or truncated streams are rejected rather than overrunning
+TEST(RefPackTest, RejectCorruptStreams) {
+  std::vector<uint8_t> data(4096);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<uint8_t>(i % 7);
+  }
+  auto packed = bigx::refpack::compress(data);
+
+  std::string error;
+  auto truncated = packed;
+  truncated.resize(truncated.size() / 2);
+  EXPECT_FALSE(bigx::refpack::decompress(truncated, &error).has_value());
+  EXPECT_FALSE(error.empty());
+
+  // Back-reference before the start of the output
+  std::vector<uint8_t> badDistance = {0x10, 0xFB, 0x00, 0x00, 0x06, 0x0C, 0x10, 0xFC};
+  EXPECT_FALSE(bigx::refpack::decompress(badDistance, &error).has_value());
+
+  // Output buffer smaller than the declared size
+  std::vector<uint8_t> small(10);
+  EXPECT_FALSE(bigx::refpack::decompress(packed, small, &error));
+}
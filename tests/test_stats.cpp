@@ -0,0 +1,126 @@
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <bigx/reader.hpp>
+#include <bigx/stats.hpp>
+#include <bigx/writer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+// These tests pass in both configurations: with BIGX_ENABLE_STATS the counters must match the
+// work done, without it they must stay zero and no callback may fire.
+class StatsTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    tempDir_ = fs::temp_directory_path() / "big_test_stats";
+    fs::create_directories(tempDir_);
+  }
+
+  void TearDown() override { fs::remove_all(tempDir_); }
+
+  // Expected counter value in this build
+  static uint64_t expected(uint64_t value) { return bigx::statsEnabled ? value : 0; }
+
+  fs::path tempDir_;
+};
+
+// Test writer counters and phase callbacks
+TEST_F(StatsTest, WriterCounters) {
+  bigx::Writer writer;
+  for (int i = 0; i < 3; ++i) {
+    writer.addFile(std::vector<uint8_t>(50, static_cast<uint8_t>(i)), std::format("f{}.bin", i));
+  }
+
+  std::vector<bigx::Phase> phases;
+  bigx::WriteOptions options;
+  options.onPhase = [&](bigx::Phase phase, std::chrono::nanoseconds) { phases.push_back(phase); };
+
+  fs::path archivePath = tempDir_ / "stats.big";
+  std::string error;
+  ASSERT_TRUE(writer.write(archivePath, options, &error)) << error;
+
+  auto stats = writer.stats();
+  EXPECT_EQ(stats.filesWritten, expected(3));
+  EXPECT_EQ(stats.bytesWritten, expected(fs::file_size(archivePath)));
+  EXPECT_EQ(stats.ioErrors, 0);
+
+  if (bigx::statsEnabled) {
+    std::vector<bigx::Phase> expectedPhases = {bigx::Phase::SizeSources, bigx::Phase::Map,
+                                               bigx::Phase::WriteDirectory,
+                                               bigx::Phase::CopyPayloads, bigx::Phase::Flush};
+    EXPECT_EQ(phases, expectedPhases);
+  } else {
+    EXPECT_TRUE(phases.empty());
+  }
+
+  // A source that vanished before write() counts as an I/O error, not as a written file
+  fs::path source = tempDir_ / "source.bin";
+  { std::ofstream(source) << "payload"; }
+  bigx::Writer failing;
+  ASSERT_TRUE(failing.addFile(source, "source.bin", &error)) << error;
+  fs::remove(source);
+  EXPECT_FALSE(failing.write(tempDir_ / "failing.big"));
+  EXPECT_EQ(failing.stats().filesWritten, 0);
+  EXPECT_EQ(failing.stats().ioErrors, expected(1));
+}
+
+// Test reader counters across lookups and extraction
+TEST_F(StatsTest, ReaderCounters) {
+  bigx::Writer writer;
+  writer.addFile(std::vector<uint8_t>(10, 'a'), "data/a.txt");
+  writer.addFile(std::vector<uint8_t>(20, 'b'), "data/b.txt");
+  fs::path archivePath = tempDir_ / "stats.big";
+  ASSERT_TRUE(writer.write(archivePath));
+
+  std::vector<std::string> phases;
+  bigx::OpenOptions options;
+  options.index = bigx::IndexMode::Lazy;
+  options.onPhase = [&](bigx::Phase phase, std::chrono::nanoseconds) {
+    phases.push_back(bigx::phaseName(phase));
+  };
+
+  std::string error;
+  auto reader = bigx::Reader::open(archivePath, options, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  if (bigx::statsEnabled) {
+    EXPECT_EQ(phases, (std::vector<std::string>{"map", "parse-header"}));
+    EXPECT_GT(reader->stats().openNanos, 0);
+  }
+
+  // The deferred parse reports through the callback given at open
+  const auto *a = reader->findFile("DATA/A.TXT");
+  ASSERT_NE(a, nullptr);
+  EXPECT_EQ(reader->findFile("data/none.txt"), nullptr);
+  EXPECT_EQ(reader->findEntry("data/none.txt"), nullptr);
+  if (bigx::statsEnabled) {
+    EXPECT_EQ(phases, (std::vector<std::string>{"map", "parse-header", "parse-directory",
+                                                "build-index", "build-file-entries"}));
+  } else {
+    EXPECT_TRUE(phases.empty());
+  }
+
+  ASSERT_TRUE(reader->extractToMemory(*a).has_value());
+  auto result = reader->extractAll(tempDir_ / "out");
+  EXPECT_TRUE(result.ok());
+
+  // Extracting onto an existing directory fails with an I/O error
+  EXPECT_FALSE(reader->extract(*a, tempDir_ / "out"));
+
+  auto stats = reader->stats();
+  EXPECT_EQ(stats.lookupHits, expected(1));
+  EXPECT_EQ(stats.lookupMisses, expected(2));
+  EXPECT_EQ(stats.filesExtracted, expected(3));
+  EXPECT_EQ(stats.bytesExtracted, expected(10 + 10 + 20));
+  EXPECT_EQ(stats.ioErrors, expected(1));
+
+  // Counters move with the reader
+  bigx::Reader moved = std::move(*reader);
+  EXPECT_EQ(moved.stats().filesExtracted, expected(3));
+  EXPECT_EQ(reader->stats().filesExtracted, 0);
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bigx/reader.hpp>
+#include <bigx/trace.hpp>
+#include <bigx/writer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class TraceTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    tempDir_ = fs::temp_directory_path() / "big_test_trace";
+    fs::create_directories(tempDir_);
+
+    bigx::Writer writer;
+    for (const char *path : {"Data/a.ini", "Data/b.ini", "Maps/level.map", "empty.txt"}) {
+      std::string content = std::string(path) == "empty.txt" ? "" : std::string(path) + " data";
+      ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(content.begin(), content.end()), path));
+    }
+    archivePath_ = tempDir_ / "traced.big";
+    ASSERT_TRUE(writer.write(archivePath_));
+  }
+
+  void TearDown() override { fs::remove_all(tempDir_); }
+
+  // Open the test archive with a recorder attached
+  std::optional<bigx::Reader> openTraced(std::shared_ptr<bigx::AccessTrace> trace) {
+    bigx::OpenOptions options;
+    options.trace = std::move(trace);
+    std::string error;
+    auto reader = bigx::Reader::open(archivePath_, options, &error);
+    EXPECT_TRUE(reader.has_value()) << error;
+    return reader;
+  }
+
+  fs::path tempDir_;
+  fs::path archivePath_;
+};
+
+// Test that lookups, views and extractions are recorded once each, in order
+TEST_F(TraceTest, RecordsAccesses) {
+  auto trace = std::make_shared<bigx::AccessTrace>();
+  auto reader = openTraced(trace);
+  ASSERT_TRUE(reader.has_value());
+
+  const bigx::FileEntry *map = reader->findFile("MAPS\\LEVEL.MAP");
+  ASSERT_NE(map, nullptr);
+  EXPECT_EQ(reader->findFile("missing.ini"), nullptr);
+  EXPECT_FALSE(reader->getFileView(*map).empty());
+  const bigx::FileEntry *ini = reader->findFile("data/a.ini");
+  ASSERT_NE(ini, nullptr);
+  EXPECT_TRUE(reader->extractToMemory(*ini).has_value());
+  std::vector<uint8_t> buffer(64);
+  EXPECT_TRUE(reader->extractTo(*map, buffer).has_value());
+
+  bigx::AccessLog log = trace->snapshot();
+  EXPECT_EQ(log.paths, (std::vector<std::string>{"Maps/level.map", "Data/a.ini"}));
+  ASSERT_EQ(log.events.size(), 5);
+  const bigx::TraceOp expected[] = {bigx::TraceOp::Find, bigx::TraceOp::View, bigx::TraceOp::Find,
+                                    bigx::TraceOp::Extract, bigx::TraceOp::Extract};
+  const uint32_t expectedPaths[] = {0, 0, 1, 1, 0};
+  for (size_t i = 0; i < log.events.size(); ++i) {
+    EXPECT_EQ(log.events[i].op, expected[i]) << i;
+    EXPECT_EQ(log.events[i].path, expectedPaths[i]) << i;
+    EXPECT_EQ(log.events[i].thread, 0);
+    if (i > 0) {
+      EXPECT_GE(log.events[i].nanos, log.events[i - 1].nanos);
+    }
+  }
+
+  // A reader without a recorder records nothing, and closing detaches the recorder
+  reader->close();
+  auto untraced = bigx::Reader::open(archivePath_);
+  ASSERT_TRUE(untraced.has_value());
+  EXPECT_NE(untraced->findFile("Data/b.ini"), nullptr);
+  EXPECT_EQ(trace->snapshot().events.size(), 5);
+}
+
+// Test that threads are numbered in order of their first access
+TEST_F(TraceTest, ThreadIds) {
+  auto trace = std::make_shared<bigx::AccessTrace>();
+  auto reader = openTraced(trace);
+  ASSERT_TRUE(reader.has_value());
+
+  reader->findFile("Data/a.ini");
+  std::thread worker([&reader]() { reader->findFile("Data/b.ini"); });
+  worker.join();
+  reader->findFile("Data/b.ini");
+
+  bigx::AccessLog log = trace->snapshot();
+  ASSERT_EQ(log.events.size(), 3);
+  EXPECT_EQ(log.events[0].thread, 0);
+  EXPECT_EQ(log.events[1].thread, 1);
+  EXPECT_EQ(log.events[2].thread, 0);
+  EXPECT_EQ(log.paths.size(), 2);
+
+  trace->clear();
+  EXPECT_TRUE(trace->snapshot().events.empty());
+  EXPECT_TRUE(trace->snapshot().paths.empty());
+}
+
+// Test the binary log round trip and rejection of damaged files
+TEST_F(TraceTest, SaveAndLoad) {
+  auto trace = std::make_shared<bigx::AccessTrace>();
+  auto reader = openTraced(trace);
+  ASSERT_TRUE(reader.has_value());
+  for (const char *path : {"Maps/level.map", "Data/b.ini", "maps/LEVEL.map"}) {
+    const bigx::FileEntry *entry = reader->findFile(path);
+    ASSERT_NE(entry, nullptr);
+    reader->getFileView(*entry);
+  }
+  bigx::AccessLog log = trace->snapshot();
+
+  fs::path logPath = tempDir_ / "access.trace";
+  std::string error;
+  ASSERT_TRUE(bigx::saveAccessLog(log, logPath, &error)) << error;
+  EXPECT_EQ(fs::file_size(logPath), 20 + (4 + 14) + (4 + 10) + 6 * 17);
+
+  auto loaded = bigx::loadAccessLog(logPath, &error);
+  ASSERT_TRUE(loaded.has_value()) << error;
+  EXPECT_EQ(loaded->paths, log.paths);
+  ASSERT_EQ(loaded->events.size(), log.events.size());
+  for (size_t i = 0; i < log.events.size(); ++i) {
+    EXPECT_EQ(loaded->events[i].nanos, log.events[i].nanos);
+    EXPECT_EQ(loaded->events[i].thread, log.events[i].thread);
+    EXPECT_EQ(loaded->events[i].op, log.events[i].op);
+    EXPECT_EQ(loaded->events[i].path, log.events[i].path);
+  }
+
+  // Truncated and unknown files are rejected
+  fs::resize_file(logPath, fs::file_size(logPath) - 1);
+  EXPECT_FALSE(bigx::loadAccessLog(logPath, &error).has_value());
+  EXPECT_NE(error.find("Malformed"), std::string::npos);
+  std::ofstream(logPath, std::ios::binary) << "not a trace file at all";
+  EXPECT_FALSE(bigx::loadAccessLog(logPath).has_value());
+  EXPECT_FALSE(bigx::loadAccessLog(tempDir_ / "missing.trace").has_value());
+}
+
+// Test turning a trace into a layout profile and a prefetch list
+TEST_F(TraceTest, ProfileAndPrefetch) {
+  auto trace = std::make_shared<bigx::AccessTrace>();
+  auto reader = openTraced(trace);
+  ASSERT_TRUE(reader.has_value());
+  for (const char *path : {"empty.txt", "Maps/level.map", "Data/b.ini", "MAPS/level.map"}) {
+    ASSERT_NE(reader->findFile(path), nullptr);
+  }
+  bigx::AccessLog log = trace->snapshot();
+
+  std::vector<std::string> profile = bigx::layoutProfile(log);
+  EXPECT_EQ(profile, (std::vector<std::string>{"empty.txt", "Maps/level.map", "Data/b.ini"}));
+
+  // Building the prefetch list must not add to the trace
+  std::vector<bigx::MappedRange> ranges = bigx::prefetchList(log, *reader);
+  EXPECT_EQ(trace->snapshot().events.size(), log.events.size());
+  ASSERT_EQ(ranges.size(), 2); // The empty file is skipped
+  const bigx::EntryView *map = reader->findEntry("Maps/level.map");
+  const bigx::EntryView *ini = reader->findEntry("Data/b.ini");
+  EXPECT_EQ(ranges[0].offset, map->offset);
+  EXPECT_EQ(ranges[0].length, map->size);
+  EXPECT_EQ(ranges[1].offset, ini->offset);
+  EXPECT_EQ(ranges[1].length, ini->size);
+  EXPECT_TRUE(reader->prefetch(ranges));
+
+  // Rewriting with the profile stores the traced files first
+  bigx::Writer writer;
+  bigx::MergeOptions merge;
+  ASSERT_TRUE(writer.addArchive(*reader, merge));
+  bigx::WriteOptions options;
+  options.payloadOrder = bigx::PayloadOrder::Profile;
+  options.accessOrder = profile;
+  fs::path relaidPath = tempDir_ / "relaid.big";
+  std::string error;
+  ASSERT_TRUE(writer.write(relaidPath, options, &error)) << error;
+
+  auto relaid = bigx::Reader::open(relaidPath, &error);
+  ASSERT_TRUE(relaid.has_value()) << error;
+  const bigx::FileEntry *first = relaid->findFile("Maps/level.map");
+  ASSERT_NE(first, nullptr);
+  for (const auto &entry : relaid->files()) {
+    if (entry.size > 0) {
+      EXPECT_GE(entry.offset, first->offset) << entry.path;
+    }
+  }
+  EXPECT_LT(first->offset, relaid->findFile("Data/b.ini")->offset);
+  EXPECT_LT(relaid->findFile("Data/b.ini")->offset, relaid->findFile("Data/a.ini")->offset);
+}
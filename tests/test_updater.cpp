@@ -0,0 +1,369 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <bigx/archive.hpp>
+#include <bigx/reader.hpp>
+#include <bigx/updater.hpp>
+#include <bigx/writer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class UpdaterTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    tempDir_ = fs::temp_directory_path() / "big_test_updater";
+    fs::create_directories(tempDir_);
+  }
+
+  void TearDown() override { fs::remove_all(tempDir_); }
+
+  static std::vector<uint8_t> bytes(const std::string &text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+  }
+
+  // Write a three-file archive
+  fs::path createArchive(const std::string &name, const bigx::WriteOptions &options = {}) {
+    bigx::Writer writer;
+    std::string error;
+    EXPECT_TRUE(writer.addFile(bytes("first payload"), "data/first.ini", &error)) << error;
+    EXPECT_TRUE(writer.addFile(bytes("second payload"), "data/second.ini", &error)) << error;
+    EXPECT_TRUE(writer.addFile(bytes("third payload"), "art/third.tga", &error)) << error;
+    fs::path path = tempDir_ / name;
+    EXPECT_TRUE(writer.write(path, options, &error)) << error;
+    return path;
+  }
+
+  // Read an archive back as (path, contents) pairs in directory order
+  static std::vector<std::pair<std::string, std::string>> contents(const fs::path &path) {
+    std::vector<std::pair<std::string, std::string>> result;
+    std::string error;
+    auto reader = bigx::Reader::open(path, &error);
+    EXPECT_TRUE(reader.has_value()) << error;
+    if (!reader) {
+      return result;
+    }
+    for (const auto &entry : reader->files()) {
+      auto view = reader->getFileView(entry);
+      result.emplace_back(entry.path, std::string(view.begin(), view.end()));
+    }
+    return result;
+  }
+
+  fs::path tempDir_;
+};
+
+// Test that replacing a payload appends it and leaves every other byte range alone
+TEST_F(UpdaterTest, ReplaceAppendsPayload) {
+  fs::path path = createArchive("replace.big");
+  uint64_t originalSize = fs::file_size(path);
+
+  std::string error;
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  EXPECT_EQ(updater->deadBytes(), 0);
+  std::vector<bigx::FileEntry> before = updater->files();
+
+  std::vector<uint8_t> patched = bytes("second payload, patched and longer");
+  ASSERT_TRUE(updater->replaceFile(patched, "DATA\\SECOND.INI", &error)) << error;
+  EXPECT_TRUE(updater->hasPendingChanges());
+  ASSERT_TRUE(updater->commit(&error)) << error;
+  EXPECT_FALSE(updater->hasPendingChanges());
+
+  // Same directory size, so only the new payload is added
+  EXPECT_EQ(fs::file_size(path), originalSize + patched.size());
+  EXPECT_EQ(updater->archiveSize(), fs::file_size(path));
+  EXPECT_EQ(updater->deadBytes(), before[1].size);
+  EXPECT_EQ(updater->files()[0].offset, before[0].offset);
+  EXPECT_EQ(updater->files()[2].offset, before[2].offset);
+  EXPECT_EQ(updater->files()[1].offset, originalSize);
+
+  auto files = contents(path);
+  ASSERT_EQ(files.size(), 3);
+  EXPECT_EQ(files[0].second, "first payload");
+  EXPECT_EQ(files[1], (std::pair<std::string, std::string>{"data/second.ini",
+                                                           "second payload, patched and longer"}));
+  EXPECT_EQ(files[2].second, "third payload");
+}
+
+// Test adding and removing entries, including a directory that outgrows its space
+TEST_F(UpdaterTest, AddAndRemove) {
+  fs::path path = createArchive("edit.big");
+
+  std::string error;
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+
+  fs::path source = tempDir_ / "disk.txt";
+  std::ofstream(source, std::ios::binary) << "from disk";
+
+  ASSERT_TRUE(updater->removeFile("data/first.ini", &error)) << error;
+  ASSERT_TRUE(updater->addFile(source, "maps/a_rather_long_directory_name/disk.txt", &error))
+      << error;
+  ASSERT_TRUE(updater->addFile(bytes("from memory"), "maps/memory.txt", &error)) << error;
+  EXPECT_FALSE(updater->contains("data/first.ini"));
+  EXPECT_TRUE(updater->contains("MAPS/MEMORY.TXT"));
+  EXPECT_EQ(updater->fileCount(), 4);
+  ASSERT_TRUE(updater->commit(&error)) << error;
+
+  auto files = contents(path);
+  std::vector<std::pair<std::string, std::string>> expected = {
+      {"data/second.ini", "second payload"},
+      {"art/third.tga", "third payload"},
+      {"maps/a_rather_long_directory_name/disk.txt", "from disk"},
+      {"maps/memory.txt", "from memory"},
+  };
+  EXPECT_EQ(files, expected);
+
+  // A second round on the same updater builds on the committed state
+  ASSERT_TRUE(updater->replaceFile(bytes("third, again"), "art/third.tga", &error)) << error;
+  ASSERT_TRUE(updater->commit(&error)) << error;
+  EXPECT_EQ(contents(path)[1].second, "third, again");
+}
+
+// Test removing many entries: survivors stay reachable before and after the commit
+TEST_F(UpdaterTest, RemoveMany) {
+  bigx::Writer writer;
+  std::string error;
+  for (int i = 0; i < 50; ++i) {
+    std::string name = "data/file" + std::to_string(i) + ".ini";
+    ASSERT_TRUE(writer.addFile(bytes("payload " + std::to_string(i)), name, &error)) << error;
+  }
+  fs::path path = tempDir_ / "many.big";
+  ASSERT_TRUE(writer.write(path, &error)) << error;
+
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  for (int i = 0; i < 50; i += 3) {
+    ASSERT_TRUE(updater->removeFile("data/file" + std::to_string(i) + ".ini", &error)) << error;
+  }
+  EXPECT_FALSE(updater->removeFile("data/file0.ini", &error)); // Already removed
+  EXPECT_EQ(updater->fileCount(), 33);
+  ASSERT_TRUE(updater->replaceFile(bytes("patched"), "data/file49.ini", &error)) << error;
+  ASSERT_TRUE(updater->addFile(bytes("re-added"), "data/file3.ini", &error)) << error;
+  for (int i = 0; i < 50; ++i) {
+    std::string name = "data/file" + std::to_string(i) + ".ini";
+    EXPECT_EQ(updater->contains(name), i % 3 != 0 || i == 3) << name;
+  }
+  ASSERT_TRUE(updater->commit(&error)) << error;
+
+  auto files = contents(path);
+  ASSERT_EQ(files.size(), 34);
+  EXPECT_EQ(files[0], (std::pair<std::string, std::string>{"data/file1.ini", "payload 1"}));
+  EXPECT_EQ(files[32], (std::pair<std::string, std::string>{"data/file49.ini", "patched"}));
+  EXPECT_EQ(files[33], (std::pair<std::string, std::string>{"data/file3.ini", "re-added"}));
+  EXPECT_TRUE(updater->contains("data/file2.ini"));
+  ASSERT_TRUE(updater->removeFile("data/file2.ini", &error)) << error;
+  ASSERT_TRUE(updater->commit(&error)) << error;
+  EXPECT_EQ(contents(path).size(), 33);
+}
+
+// Test that reserved slack lets the directory grow without moving payloads
+TEST_F(UpdaterTest, DirectorySlack) {
+  bigx::WriteOptions writeOptions;
+  writeOptions.directorySlack = 256;
+  fs::path path = createArchive("slack.big", writeOptions);
+
+  std::string error;
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  EXPECT_EQ(updater->deadBytes(), 256);
+  uint64_t firstOffset = updater->files()[0].offset;
+
+  std::string name = "data/new_file_in_the_slack.ini";
+  ASSERT_TRUE(updater->addFile(bytes("new"), name, &error)) << error;
+  ASSERT_TRUE(updater->commit(&error)) << error;
+  EXPECT_EQ(updater->files()[0].offset, firstOffset);
+  EXPECT_EQ(updater->deadBytes(), 256 - (8 + name.size() + 1)); // One BIGF record
+
+  // Without slack the first payloads have to move, and fresh slack is reserved behind them
+  fs::path tight = createArchive("tight.big");
+  auto tightUpdater = bigx::Updater::open(tight, &error);
+  ASSERT_TRUE(tightUpdater.has_value()) << error;
+  uint64_t tightFirst = tightUpdater->files()[0].offset;
+
+  bigx::UpdateOptions options;
+  options.directorySlack = 128;
+  ASSERT_TRUE(tightUpdater->addFile(bytes("new"), "data/new.ini", &error)) << error;
+  ASSERT_TRUE(tightUpdater->commit(options, &error)) << error;
+  EXPECT_NE(tightUpdater->files()[0].offset, tightFirst);
+  EXPECT_EQ(contents(tight).size(), 4);
+  EXPECT_EQ(contents(tight)[0].second, "first payload");
+
+  uint64_t sizeAfter = fs::file_size(tight);
+  ASSERT_TRUE(tightUpdater->addFile(bytes("x"), "data/x.ini", &error)) << error;
+  ASSERT_TRUE(tightUpdater->commit(options, &error)) << error;
+  EXPECT_EQ(fs::file_size(tight), sizeAfter + 1); // Fit in the reserved slack
+}
+
+// Test that compact() drops dead space and can change the format
+TEST_F(UpdaterTest, Compact) {
+  fs::path path = createArchive("compact.big");
+
+  std::string error;
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  ASSERT_TRUE(updater->replaceFile(bytes("1"), "data/first.ini", &error)) << error;
+  ASSERT_TRUE(updater->removeFile("art/third.tga", &error)) << error;
+  ASSERT_TRUE(updater->commit(&error)) << error;
+  EXPECT_GT(updater->deadBytes(), 0);
+  auto before = contents(path);
+
+  bigx::UpdateOptions options;
+  options.format = bigx::ArchiveFormat::Big64;
+  ASSERT_TRUE(updater->compact(options, &error)) << error;
+  EXPECT_EQ(updater->deadBytes(), 0);
+  EXPECT_EQ(updater->format(), bigx::ArchiveFormat::Big64);
+  EXPECT_EQ(contents(path), before);
+  EXPECT_FALSE(fs::exists(tempDir_ / "compact.big.compact"));
+
+  auto reader = bigx::Reader::open(path, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_EQ(reader->format(), bigx::ArchiveFormat::Big64);
+}
+
+// Test that compact() rewrites the checksum trailer of a checksummed archive
+TEST_F(UpdaterTest, CompactKeepsChecksums) {
+  bigx::WriteOptions writeOptions;
+  writeOptions.checksums = true;
+  fs::path path = createArchive("checksums.big", writeOptions);
+
+  std::string error;
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  ASSERT_TRUE(updater->replaceFile(bytes("new first"), "data/first.ini", &error)) << error;
+  ASSERT_TRUE(updater->compact({}, &error)) << error;
+
+  auto reader = bigx::Reader::open(path, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_TRUE(reader->hasChecksums());
+  EXPECT_TRUE(reader->verify().ok());
+  reader->close();
+
+  // An archive without checksums does not gain them
+  fs::path plain = createArchive("plain.big");
+  updater = bigx::Updater::open(plain, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  ASSERT_TRUE(updater->compact({}, &error)) << error;
+  reader = bigx::Reader::open(plain, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_FALSE(reader->hasChecksums());
+}
+
+// Test that compact() rewrites the prebuilt index trailer, so reopening stays instant
+TEST_F(UpdaterTest, CompactKeepsIndexTrailer) {
+  bigx::WriteOptions writeOptions;
+  writeOptions.indexTrailer = true;
+  fs::path path = createArchive("indexed.big", writeOptions);
+
+  std::string error;
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  ASSERT_TRUE(updater->removeFile("data/second.ini", &error)) << error;
+  ASSERT_TRUE(updater->compact({}, &error)) << error;
+
+  auto reader = bigx::Reader::open(path, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_TRUE(reader->hasIndexTrailer());
+  EXPECT_NE(reader->findFile("art/third.tga"), nullptr);
+  EXPECT_EQ(reader->findFile("data/second.ini"), nullptr);
+}
+
+// Test staging errors and discard()
+TEST_F(UpdaterTest, StagingErrors) {
+  fs::path path = createArchive("errors.big");
+  uint64_t originalSize = fs::file_size(path);
+
+  std::string error;
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+
+  EXPECT_FALSE(updater->replaceFile(bytes("x"), "missing.ini", &error));
+  EXPECT_NE(error.find("not found"), std::string::npos) << error;
+  EXPECT_FALSE(updater->removeFile("missing.ini", &error));
+  EXPECT_FALSE(updater->addFile(bytes("x"), "Data/First.ini", &error));
+  EXPECT_NE(error.find("Duplicate"), std::string::npos) << error;
+  EXPECT_FALSE(updater->addFile(tempDir_ / "missing.txt", "data/missing.txt", &error));
+
+  ASSERT_TRUE(updater->removeFile("data/first.ini", &error)) << error;
+  updater->discard();
+  EXPECT_FALSE(updater->hasPendingChanges());
+  EXPECT_TRUE(updater->contains("data/first.ini"));
+  ASSERT_TRUE(updater->commit(&error)) << error; // Nothing to do
+  EXPECT_EQ(fs::file_size(path), originalSize);
+
+  EXPECT_FALSE(bigx::Updater::open(tempDir_ / "missing.big", &error).has_value());
+}
+
+// Test the Archive update mode
+TEST_F(UpdaterTest, ArchiveUpdateMode) {
+  fs::path path = createArchive("archive.big");
+
+  std::string error;
+  auto archive = bigx::Archive::openForUpdate(path, &error);
+  ASSERT_TRUE(archive.has_value()) << error;
+  EXPECT_TRUE(archive->isUpdating());
+  EXPECT_TRUE(archive->isOpen());
+  EXPECT_EQ(archive->files().size(), 3);
+
+  ASSERT_TRUE(archive->replaceFile(bytes("patched"), "data/first.ini", &error)) << error;
+  ASSERT_TRUE(archive->addFile(bytes("added"), "data/added.ini", &error)) << error;
+  ASSERT_TRUE(archive->removeFile("data/second.ini", &error)) << error;
+  ASSERT_TRUE(archive->commit({}, &error)) << error;
+  EXPECT_EQ(archive->fileCount(), 3);
+
+  auto files = contents(path);
+  std::vector<std::pair<std::string, std::string>> expected = {
+      {"data/first.ini", "patched"},
+      {"art/third.tga", "third payload"},
+      {"data/added.ini", "added"},
+  };
+  EXPECT_EQ(files, expected);
+
+  // Update operations are refused in other modes
+  auto reading = bigx::Archive::open(path, &error);
+  ASSERT_TRUE(reading.has_value()) << error;
+  EXPECT_FALSE(reading->removeFile("data/first.ini", &error));
+  EXPECT_EQ(error, "Archive not open for update");
+  EXPECT_FALSE(reading->commit({}, &error));
+}
+
+// Test that payloads shared by deduplicated entries stay shared when moved or compacted
+TEST_F(UpdaterTest, SharedPayloadsStayShared) {
+  bigx::Writer writer;
+  std::string error;
+  ASSERT_TRUE(writer.addFile(bytes("shared payload"), "a.ini", &error)) << error;
+  ASSERT_TRUE(writer.addFile(bytes("shared payload"), "b.ini", &error)) << error;
+  ASSERT_TRUE(writer.addFile(bytes("own payload"), "c.ini", &error)) << error;
+  bigx::WriteOptions options;
+  options.deduplicate = true;
+  fs::path path = tempDir_ / "shared.big";
+  ASSERT_TRUE(writer.write(path, options, &error)) << error;
+
+  // The grown directory pushes the shared payload to the end of the file
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  EXPECT_EQ(updater->deadBytes(), 0);
+  std::string name = "a_long_enough_name_to_grow_the_directory.ini";
+  ASSERT_TRUE(updater->addFile(bytes("new"), name, &error)) << error;
+  ASSERT_TRUE(updater->commit(&error)) << error;
+  EXPECT_EQ(updater->files()[0].offset, updater->files()[1].offset);
+
+  // New directory, then the two moved payloads (the shared one copied once) and the new one
+  uint64_t directoryEnd = 16 + 3 * (8 + 6) + (8 + name.size() + 1);
+  EXPECT_EQ(fs::file_size(path), directoryEnd + 14 + 11 + 3);
+
+  ASSERT_TRUE(updater->compact({}, &error)) << error;
+  EXPECT_EQ(updater->files()[0].offset, updater->files()[1].offset);
+  EXPECT_EQ(updater->deadBytes(), 0);
+
+  auto files = contents(path);
+  ASSERT_EQ(files.size(), 4);
+  EXPECT_EQ(files[0].second, "shared payload");
+  EXPECT_EQ(files[1].second, "shared payload");
+  EXPECT_EQ(files[2].second, "own payload");
+}
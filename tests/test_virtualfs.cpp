@@ -0,0 +1,128 @@
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <bigx/reader.hpp>
+#include <bigx/virtualfs.hpp>
+#include <bigx/writer.hpp>
+
+#include <gtest/gtest.h>
+
+namespace fs = std::filesystem;
+
+class VirtualFSTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    tempDir_ = fs::temp_directory_path() / "big_test_virtualfs";
+    fs::create_directories(tempDir_);
+  }
+
+  void TearDown() override { fs::remove_all(tempDir_); }
+
+  // Write an archive where every file contains the given tag
+  fs::path createArchive(const std::string &name, const std::vector<std::string> &paths,
+                         const std::string &tag) {
+    bigx::Writer writer;
+    std::vector<uint8_t> data(tag.begin(), tag.end());
+    for (const auto &path : paths) {
+      writer.addFile(data, path);
+    }
+    fs::path archivePath = tempDir_ / name;
+    writer.write(archivePath);
+    return archivePath;
+  }
+
+  // Read the content of a resolved file as a string
+  static std::string contentOf(const bigx::ResolvedFile &file) {
+    auto view = file.reader->getFileView(*file.entry);
+    return std::string(view.begin(), view.end());
+  }
+
+  fs::path tempDir_;
+};
+
+// Test that later mounts shadow earlier ones at equal priority
+TEST_F(VirtualFSTest, LaterMountShadows) {
+  auto base = createArchive("base.big", {"Data/INI/GameData.ini", "Art/a.dds"}, "base");
+  auto patch = createArchive("patch.big", {"data\\ini\\gamedata.ini"}, "patch");
+
+  bigx::VirtualFS vfs;
+  std::string error;
+  ASSERT_TRUE(vfs.mount(base, 0, &error).has_value()) << error;
+  ASSERT_TRUE(vfs.mount(patch, 0, &error).has_value()) << error;
+
+  EXPECT_EQ(vfs.mountCount(), 2);
+  EXPECT_EQ(vfs.fileCount(), 2);
+
+  auto ini = vfs.findFile("DATA/INI/GAMEDATA.INI");
+  ASSERT_TRUE(ini.has_value());
+  EXPECT_EQ(contentOf(*ini), "patch");
+
+  auto art = vfs.findFile("art/A.dds");
+  ASSERT_TRUE(art.has_value());
+  EXPECT_EQ(contentOf(*art), "base");
+
+  // Views into a larger buffer are probed in place, in either slash style
+  std::string_view script = "load(ART\\A.DDS)";
+  auto viewed = vfs.findFile(script.substr(5, 9));
+  ASSERT_TRUE(viewed.has_value());
+  EXPECT_EQ(viewed->entry, art->entry);
+
+  EXPECT_FALSE(vfs.findFile("missing.txt").has_value());
+}
+
+// Test that priority beats mount order
+TEST_F(VirtualFSTest, PriorityOverridesMountOrder) {
+  auto high = createArchive("high.big", {"shared.txt"}, "high");
+  auto low = createArchive("low.big", {"shared.txt"}, "low");
+
+  bigx::VirtualFS vfs;
+  ASSERT_TRUE(vfs.mount(high, 10).has_value());
+  ASSERT_TRUE(vfs.mount(low, 1).has_value());
+
+  auto file = vfs.findFile("shared.txt");
+  ASSERT_TRUE(file.has_value());
+  EXPECT_EQ(contentOf(*file), "high");
+}
+
+// Test that unmounting reveals shadowed entries and drops unique ones
+TEST_F(VirtualFSTest, UnmountRestoresShadowedFiles) {
+  auto base = createArchive("base.big", {"shared.txt"}, "base");
+  auto mod = createArchive("mod.big", {"shared.txt", "mod_only.txt"}, "mod");
+
+  bigx::VirtualFS vfs;
+  ASSERT_TRUE(vfs.mount(base).has_value());
+  auto modId = vfs.mount(mod);
+  ASSERT_TRUE(modId.has_value());
+
+  EXPECT_EQ(contentOf(*vfs.findFile("shared.txt")), "mod");
+  EXPECT_TRUE(vfs.findFile("mod_only.txt").has_value());
+
+  EXPECT_TRUE(vfs.unmount(*modId));
+  EXPECT_FALSE(vfs.unmount(*modId));
+  EXPECT_EQ(vfs.reader(*modId), nullptr);
+
+  EXPECT_EQ(contentOf(*vfs.findFile("shared.txt")), "base");
+  EXPECT_FALSE(vfs.findFile("mod_only.txt").has_value());
+  EXPECT_EQ(vfs.fileCount(), 1);
+}
+
+// Test enumeration visits each visible path once
+TEST_F(VirtualFSTest, ForEachFileVisitsWinners) {
+  auto a = createArchive("a.big", {"one.txt", "two.txt"}, "a");
+  auto b = createArchive("b.big", {"two.txt", "three.txt"}, "b");
+
+  bigx::VirtualFS vfs;
+  ASSERT_TRUE(vfs.mount(a).has_value());
+  ASSERT_TRUE(vfs.mount(b).has_value());
+
+  size_t visited = 0;
+  vfs.forEachFile([&](const bigx::ResolvedFile &file) {
+    ++visited;
+    if (file.entry->lowercasePath == "two.txt") {
+      EXPECT_EQ(contentOf(file), "b");
+    }
+  });
+  EXPECT_EQ(visited, 3);
+}
@@ -1,9 +1,13 @@
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <iterator>
 
 #include <bigx/endian.hpp>
 #include <bigx/reader.hpp>
+#include <bigx/updater.hpp>
 #include <bigx/writer.hpp>
 
 #include <gtest/gtest.h>
@@ -253,3 +257,837 @@ TEST_F(WriterTest, ArchiveHeader) {
   EXPECT_EQ(padding, 0);
   EXPECT_EQ(bigx::betoh32(fileCount), 1); // Convert from big-endian
 }
+
+// Test adding borrowed memory without copying
+TEST_F(WriterTest, AddFileView) {
+  std::vector<uint8_t> data = {'V', 'i', 'e', 'w'};
+
+  bigx::Writer writer;
+  std::string error;
+  ASSERT_TRUE(writer.addFileView(data, "view/file.bin", &error)) << error;
+  EXPECT_FALSE(writer.addFileView(data, "VIEW\\FILE.BIN", &error));
+
+  fs::path archivePath = tempDir_ / "view.big";
+  ASSERT_TRUE(writer.write(archivePath, &error)) << error;
+
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  const auto *file = reader->findFile("view/file.bin");
+  ASSERT_NE(file, nullptr);
+  auto content = reader->extractToMemory(*file, &error);
+  ASSERT_TRUE(content.has_value()) << error;
+  EXPECT_EQ(*content, data);
+}
+
+// Test that disk sources larger than one copy chunk are streamed intact
+TEST_F(WriterTest, LargeDiskSourceStreamed) {
+  std::string content(5 * 1024 * 1024 + 123, '\0');
+  for (size_t i = 0; i < content.size(); ++i) {
+    content[i] = static_cast<char>(i * 31 + 7);
+  }
+  fs::path sourcePath = tempDir_ / "large.bin";
+  {
+    std::ofstream out(sourcePath, std::ios::binary);
+    out.write(content.data(), content.size());
+  }
+
+  bigx::Writer writer;
+  std::string error;
+  ASSERT_TRUE(writer.addFile(sourcePath, "large.bin", &error)) << error;
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>{1, 2, 3}, "after.bin", &error)) << error;
+
+  fs::path archivePath = tempDir_ / "large.big";
+  ASSERT_TRUE(writer.write(archivePath, &error)) << error;
+
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  auto view = reader->getFileView(*reader->findFile("large.bin"));
+  ASSERT_EQ(view.size(), content.size());
+  EXPECT_TRUE(std::equal(view.begin(), view.end(), content.begin(), [](uint8_t a, char b) {
+    return a == static_cast<uint8_t>(b);
+  }));
+  EXPECT_EQ(reader->getFileView(*reader->findFile("after.bin"))[2], 3);
+}
+
+// Test adding a directory tree recursively
+TEST_F(WriterTest, AddDirectory) {
+  fs::create_directories(tempDir_ / "mod/Data/INI");
+  createTestFile("mod/Data/INI/GameData.ini", "ini");
+  createTestFile("mod/readme.txt", "readme");
+
+  bigx::Writer writer;
+  std::string error;
+  ASSERT_TRUE(writer.addDirectory(tempDir_ / "mod", "Mods/", &error)) << error;
+  EXPECT_EQ(writer.fileCount(), 2);
+
+  fs::path archivePath = tempDir_ / "dir.big";
+  ASSERT_TRUE(writer.write(archivePath, &error)) << error;
+
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_EQ(reader->files()[0].path, "Mods/Data/INI/GameData.ini");
+  EXPECT_EQ(reader->files()[1].path, "Mods/readme.txt");
+
+  EXPECT_FALSE(writer.addDirectory(tempDir_ / "missing", "", &error));
+}
+
+// Test bulk add stops at the first duplicate
+TEST_F(WriterTest, AddFilesStopsAtDuplicate) {
+  createTestFile("a.txt", "a");
+  createTestFile("b.txt", "b");
+
+  std::vector<bigx::FileSource> sources = {
+      {tempDir_ / "a.txt", "a.txt"},
+      {tempDir_ / "b.txt", "A.TXT"},
+  };
+
+  bigx::Writer writer;
+  std::string error;
+  EXPECT_FALSE(writer.addFiles(sources, &error));
+  EXPECT_NE(error.find("Duplicate"), std::string::npos);
+  EXPECT_EQ(writer.fileCount(), 1);
+
+  // Clearing releases claimed paths
+  writer.clear();
+  EXPECT_TRUE(writer.addFile(tempDir_ / "b.txt", "A.TXT", &error)) << error;
+}
+
+// Test that many small files round-trip with correct directory offsets
+TEST_F(WriterTest, ManySmallFiles) {
+  constexpr size_t count = 20000;
+  std::vector<std::vector<uint8_t>> payloads(count);
+
+  bigx::Writer writer;
+  writer.reserve(count);
+  std::string error;
+  for (size_t i = 0; i < count; ++i) {
+    std::string name = std::format("dir{}/file{}.bin", i % 97, i);
+    payloads[i] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+    ASSERT_TRUE(writer.addFileView(payloads[i], name, &error)) << error;
+  }
+
+  fs::path archivePath = tempDir_ / "many.big";
+  ASSERT_TRUE(writer.write(archivePath, &error)) << error;
+
+  auto reader = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  ASSERT_EQ(reader->fileCount(), count);
+  for (size_t i : {size_t{0}, size_t{1}, count / 2, count - 1}) {
+    const auto *file = reader->findFile(std::format("DIR{}/FILE{}.BIN", i % 97, i));
+    ASSERT_NE(file, nullptr);
+    auto view = reader->getFileView(*file);
+    ASSERT_EQ(view.size(), 2);
+    EXPECT_EQ(view[0], static_cast<uint8_t>(i));
+    EXPECT_EQ(view[1], static_cast<uint8_t>(i >> 8));
+  }
+}
+
+// Test that a threaded write produces byte-identical output to the serial path
+TEST_F(WriterTest, ParallelWriteMatchesSerial) {
+  std::vector<std::vector<uint8_t>> payloads;
+  for (size_t i = 0; i < 64; ++i) {
+    payloads.emplace_back(1000 + i * 37, static_cast<uint8_t>(i));
+  }
+  for (size_t i = 0; i < 8; ++i) {
+    createTestFile(std::format("disk{}.txt", i), std::string(5000 + i, static_cast<char>('a' + i)));
+  }
+
+  auto build = [&](unsigned threads, const std::string &name) {
+    bigx::Writer writer;
+    for (size_t i = 0; i < payloads.size(); ++i) {
+      writer.addFileView(payloads[i], std::format("mem/{}.bin", i));
+    }
+    for (size_t i = 0; i < 8; ++i) {
+      writer.addFile(tempDir_ / std::format("disk{}.txt", i), std::format("disk/{}.txt", i));
+    }
+    bigx::WriteOptions options;
+    options.threads = threads;
+    std::string error;
+    EXPECT_TRUE(writer.write(tempDir_ / name, options, &error)) << error;
+    std::ifstream in(tempDir_ / name, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  };
+
+  std::string serial = build(1, "serial.big");
+  std::string parallel = build(8, "parallel.big");
+  ASSERT_FALSE(serial.empty());
+  EXPECT_EQ(serial, parallel);
+}
+
+// Test that a failing source in a threaded write is reported
+TEST_F(WriterTest, ParallelWriteReportsFailure) {
+  createTestFile("vanishing.txt", "soon gone");
+
+  bigx::Writer writer;
+  std::string error;
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>{1, 2}, "ok.bin", &error)) << error;
+  ASSERT_TRUE(writer.addFile(tempDir_ / "vanishing.txt", "gone.txt", &error)) << error;
+  fs::remove(tempDir_ / "vanishing.txt");
+
+  bigx::WriteOptions options;
+  options.threads = 4;
+  EXPECT_FALSE(writer.write(tempDir_ / "fail.big", options, &error));
+  EXPECT_FALSE(error.empty());
+}
+
+// Test writing compressed entries and decoding them on extraction
+TEST_F(WriterTest, CompressedRoundTrip) {
+  std::string text;
+  for (int i = 0; i < 2000; ++i) {
+    text += "Weapon RangerAdvancedCombatRifle { Damage = 10 }\n";
+  }
+  std::vector<uint8_t> compressible(text.begin(), text.end());
+  std::vector<uint8_t> incompressible = {9, 4, 1};
+  createTestFile("disk.ini", text);
+
+  bigx::Writer writer;
+  std::string error;
+  ASSERT_TRUE(writer.addFile(compressible, "data/mem.ini", &error)) << error;
+  ASSERT_TRUE(writer.addFile(incompressible, "data/raw.bin", &error)) << error;
+  ASSERT_TRUE(writer.addFile(tempDir_ / "disk.ini", "data/disk.ini", &error)) << error;
+
+  bigx::WriteOptions writeOptions;
+  writeOptions.compress = true;
+  writeOptions.threads = 2;
+  fs::path archivePath = tempDir_ / "compressed.big";
+  ASSERT_TRUE(writer.write(archivePath, writeOptions, &error)) << error;
+
+  // Without decoding, payloads come back as stored
+  auto raw = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(raw.has_value()) << error;
+  const auto *mem = raw->findFile("data/mem.ini");
+  ASSERT_NE(mem, nullptr);
+  EXPECT_TRUE(raw->isCompressed(*mem));
+  EXPECT_LT(mem->size, compressible.size());
+  EXPECT_EQ(raw->uncompressedSize(*mem), compressible.size());
+  EXPECT_FALSE(raw->isCompressed(*raw->findFile("data/raw.bin")));
+
+  // With decoding enabled, every extraction path yields the original bytes
+  bigx::OpenOptions openOptions;
+  openOptions.decompress = true;
+  auto reader = bigx::Reader::open(archivePath, openOptions, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+
+  auto decoded = reader->extractToMemory(*reader->findFile("data/mem.ini"), &error);
+  ASSERT_TRUE(decoded.has_value()) << error;
+  EXPECT_EQ(*decoded, compressible);
+
+  const auto *memEntry = reader->findFile("data/mem.ini");
+  ASSERT_EQ(reader->extractedSize(*memEntry), compressible.size());
+  std::vector<uint8_t> buffer(compressible.size());
+  EXPECT_FALSE(reader->extractTo(*memEntry, std::span(buffer).first(100), &error).has_value());
+  auto written = reader->extractTo(*memEntry, buffer, &error);
+  ASSERT_TRUE(written.has_value()) << error;
+  EXPECT_EQ(*written, compressible.size());
+  EXPECT_EQ(buffer, compressible);
+
+  auto rawBin = reader->extractToMemory(*reader->findFile("data/raw.bin"), &error);
+  ASSERT_TRUE(rawBin.has_value()) << error;
+  EXPECT_EQ(*rawBin, incompressible);
+
+  fs::path extracted = tempDir_ / "disk_out.ini";
+  ASSERT_TRUE(reader->extract(*reader->findFile("data/disk.ini"), extracted, &error)) << error;
+  EXPECT_EQ(fs::file_size(extracted), text.size());
+}
+
+// Test that raw payloads which only look RefPack-compressed survive a compressed round trip
+TEST_F(WriterTest, CompressedLookalikeRoundTrip) {
+  std::vector<uint8_t> lookalike = {0x10, 0xFB, 0x00, 0x00, 0x04, 'r', 'a', 'w', '!', '!'};
+  std::vector<uint8_t> hugeHeader = {0x90, 0xFB, 0xFF, 0xFF, 0xFF, 0xFF};
+
+  bigx::Writer writer;
+  std::string error;
+  ASSERT_TRUE(writer.addFile(lookalike, "data/lookalike.bin", &error)) << error;
+  ASSERT_TRUE(writer.addFile(hugeHeader, "data/huge.bin", &error)) << error;
+  bigx::WriteOptions writeOptions;
+  writeOptions.compress = true;
+  fs::path archivePath = tempDir_ / "lookalike.big";
+  ASSERT_TRUE(writer.write(archivePath, writeOptions, &error)) << error;
+
+  bigx::OpenOptions openOptions;
+  openOptions.decompress = true;
+  auto reader = bigx::Reader::open(archivePath, openOptions, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  const auto *entry = reader->findFile("data/lookalike.bin");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_TRUE(reader->isCompressed(*entry));
+
+  auto data = reader->extractToMemory(*entry, &error);
+  ASSERT_TRUE(data.has_value()) << error;
+  EXPECT_EQ(*data, lookalike);
+  std::vector<uint8_t> buffer(lookalike.size());
+  auto written = reader->extractTo(*entry, buffer, &error);
+  ASSERT_TRUE(written.has_value()) << error;
+  EXPECT_EQ(*written, lookalike.size());
+  EXPECT_EQ(buffer, lookalike);
+
+  const auto *huge = reader->findFile("data/huge.bin");
+  ASSERT_NE(huge, nullptr);
+  EXPECT_FALSE(reader->isCompressed(*huge));
+  EXPECT_EQ(reader->extractedSize(*huge), hugeHeader.size());
+  EXPECT_EQ(reader->extractToMemory(*huge, &error), hugeHeader) << error;
+
+  auto result = reader->extractAll(tempDir_ / "out");
+  EXPECT_TRUE(result.ok());
+  std::ifstream in(tempDir_ / "out" / "data" / "lookalike.bin", std::ios::binary);
+  std::vector<uint8_t> extracted((std::istreambuf_iterator<char>(in)), {});
+  EXPECT_EQ(extracted, lookalike);
+}
+
+// Test writing and reading back every archive variant
+TEST_F(WriterTest, FormatRoundTrip) {
+  std::vector<uint8_t> payload = {'B', 'F', 'M', 'E'};
+  for (auto format : {bigx::ArchiveFormat::BigF, bigx::ArchiveFormat::Big4,
+                      bigx::ArchiveFormat::Big64}) {
+    bigx::Writer writer;
+    std::string error;
+    ASSERT_TRUE(writer.addFile(payload, "data/a.ini", &error)) << error;
+    ASSERT_TRUE(writer.addFile(payload, "data/b.ini", &error)) << error;
+
+    bigx::WriteOptions options;
+    options.format = format;
+    fs::path archivePath = tempDir_ / "format.big";
+    ASSERT_TRUE(writer.write(archivePath, options, &error)) << error;
+
+    // Check the raw header: magic, then entry count and archive size at the variant's offsets
+    std::ifstream archiveFile(archivePath, std::ios::binary);
+    uint8_t header[16];
+    archiveFile.read(reinterpret_cast<char *>(header), sizeof(header));
+    std::string magic(reinterpret_cast<const char *>(header), 4);
+    uint32_t fileCount;
+    uint64_t archiveSize;
+    if (format == bigx::ArchiveFormat::Big64) {
+      EXPECT_EQ(magic, "BIGX");
+      std::memcpy(&fileCount, header + 4, 4);
+      std::memcpy(&archiveSize, header + 8, 8);
+      archiveSize = bigx::betoh64(archiveSize);
+    } else {
+      EXPECT_EQ(magic, format == bigx::ArchiveFormat::Big4 ? "BIG4" : "BIGF");
+      uint32_t size32;
+      std::memcpy(&size32, header + 4, 4);
+      std::memcpy(&fileCount, header + 8, 4);
+      archiveSize = bigx::betoh32(size32);
+    }
+    EXPECT_EQ(bigx::betoh32(fileCount), 2);
+    EXPECT_EQ(archiveSize, fs::file_size(archivePath));
+
+    auto reader = bigx::Reader::open(archivePath, &error);
+    ASSERT_TRUE(reader.has_value()) << error;
+    EXPECT_EQ(reader->format(), format);
+    ASSERT_EQ(reader->fileCount(), 2);
+    for (const auto &entry : reader->files()) {
+      auto data = reader->extractToMemory(entry, &error);
+      ASSERT_TRUE(data.has_value()) << error;
+      EXPECT_EQ(*data, payload);
+    }
+    EXPECT_EQ(reader->findEntry("DATA/B.INI")->size, payload.size());
+  }
+}
+
+// Test that 32-bit formats refuse archives over 4 GiB instead of truncating offsets
+TEST_F(WriterTest, OversizeArchiveRefused) {
+  // A sparse source just over 4 GiB; sizing fails before any byte is read or written
+  fs::path source = tempDir_ / "huge.bin";
+  std::ofstream(source, std::ios::binary).put('\0');
+  std::error_code ec;
+  fs::resize_file(source, uint64_t{UINT32_MAX} + 1, ec);
+  if (ec) {
+    GTEST_SKIP() << "Cannot create a large sparse file: " << ec.message();
+  }
+
+  bigx::Writer writer;
+  std::string error;
+  ASSERT_TRUE(writer.addFile(source, "huge.bin", &error)) << error;
+
+  fs::path archivePath = tempDir_ / "huge.big";
+  for (auto format : {bigx::ArchiveFormat::BigF, bigx::ArchiveFormat::Big4}) {
+    bigx::WriteOptions options;
+    options.format = format;
+    error.clear();
+    EXPECT_FALSE(writer.write(archivePath, options, &error));
+    EXPECT_NE(error.find("exceeds the 4 GiB limit"), std::string::npos) << error;
+  }
+  EXPECT_FALSE(fs::exists(archivePath));
+}
+
+// Test that an index trailer is adopted by readers and invisible to everything else
+TEST_F(WriterTest, IndexTrailer) {
+  for (auto format : {bigx::ArchiveFormat::BigF, bigx::ArchiveFormat::Big64}) {
+    bigx::Writer writer;
+    std::string error;
+    for (int i = 0; i < 40; ++i) {
+      std::string text = std::format("payload {}", i);
+      std::vector<uint8_t> data(text.begin(), text.end());
+      ASSERT_TRUE(writer.addFile(data, std::format("Data/File_{:02}.ini", i), &error)) << error;
+    }
+
+    bigx::WriteOptions options;
+    options.format = format;
+    fs::path plainPath = tempDir_ / "plain.big";
+    ASSERT_TRUE(writer.write(plainPath, options, &error)) << error;
+    options.indexTrailer = true;
+    fs::path indexedPath = tempDir_ / "indexed.big";
+    ASSERT_TRUE(writer.write(indexedPath, options, &error)) << error;
+    EXPECT_GT(fs::file_size(indexedPath), fs::file_size(plainPath));
+
+    auto plain = bigx::Reader::open(plainPath, &error);
+    ASSERT_TRUE(plain.has_value()) << error;
+    EXPECT_FALSE(plain->hasIndexTrailer());
+
+    auto indexed = bigx::Reader::open(indexedPath, &error);
+    ASSERT_TRUE(indexed.has_value()) << error;
+    EXPECT_TRUE(indexed->hasIndexTrailer());
+    ASSERT_EQ(indexed->fileCount(), 40);
+    for (size_t i = 0; i < 40; ++i) {
+      EXPECT_EQ(indexed->files()[i].path, plain->files()[i].path);
+      EXPECT_EQ(indexed->findFile(std::format("DATA\\FILE_{:02}.INI", i)), &indexed->files()[i]);
+    }
+    EXPECT_EQ(indexed->findFile("data/file_40.ini"), nullptr);
+
+    // Readers that ignore the trailer see the same archive
+    bigx::OpenOptions ignore;
+    ignore.indexTrailer = false;
+    auto legacy = bigx::Reader::open(indexedPath, ignore, &error);
+    ASSERT_TRUE(legacy.has_value()) << error;
+    EXPECT_FALSE(legacy->hasIndexTrailer());
+    EXPECT_EQ(legacy->fileCount(), 40);
+
+    // A lazy reader answers scanFor() from the trailer table
+    bigx::OpenOptions lazy;
+    lazy.index = bigx::IndexMode::Lazy;
+    auto reader = bigx::Reader::open(indexedPath, lazy, &error);
+    ASSERT_TRUE(reader.has_value()) << error;
+    auto entry = reader->scanFor("data/FILE_07.ini");
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->path, "Data/File_07.ini");
+    auto view = reader->getFileView(*entry);
+    EXPECT_EQ(std::string(view.begin(), view.end()), "payload 7");
+    EXPECT_FALSE(reader->scanFor("data/file_40.ini").has_value());
+  }
+}
+
+// Test that a trailer which no longer matches its archive is ignored
+TEST_F(WriterTest, StaleIndexTrailerIgnored) {
+  bigx::Writer writer;
+  std::string error;
+  std::vector<uint8_t> data = {'x', 'y', 'z'};
+  ASSERT_TRUE(writer.addFile(data, "data/a.ini", &error)) << error;
+  ASSERT_TRUE(writer.addFile(data, "data/b.ini", &error)) << error;
+  ASSERT_TRUE(writer.addFile(data, "data/c.ini", &error)) << error;
+
+  bigx::WriteOptions options;
+  options.indexTrailer = true;
+  fs::path archivePath = tempDir_ / "stale.big";
+  ASSERT_TRUE(writer.write(archivePath, options, &error)) << error;
+
+  // Flip a byte of the slot table
+  {
+    std::fstream file(archivePath, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekg(-64, std::ios::end);
+    char byte = 0;
+    file.get(byte);
+    file.seekp(-64, std::ios::end);
+    file.put(static_cast<char>(byte ^ 0x01));
+  }
+  auto corrupted = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(corrupted.has_value()) << error;
+  EXPECT_FALSE(corrupted->hasIndexTrailer());
+  EXPECT_NE(corrupted->findFile("data/c.ini"), nullptr);
+
+  // Rewriting the directory in place leaves the old trailer behind
+  ASSERT_TRUE(writer.write(archivePath, options, &error)) << error;
+  auto updater = bigx::Updater::open(archivePath, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  ASSERT_TRUE(updater->removeFile("data/b.ini", &error)) << error;
+  ASSERT_TRUE(updater->commit(&error)) << error;
+
+  auto updated = bigx::Reader::open(archivePath, &error);
+  ASSERT_TRUE(updated.has_value()) << error;
+  EXPECT_FALSE(updated->hasIndexTrailer());
+  EXPECT_EQ(updated->fileCount(), 2);
+  EXPECT_EQ(updated->findFile("data/b.ini"), nullptr);
+  EXPECT_NE(updated->findFile("data/c.ini"), nullptr);
+}
+
+// Test that identical payloads are stored once and shared by every entry naming them
+TEST_F(WriterTest, DeduplicatedWrite) {
+  std::string text(4096, 'x');
+  std::vector<uint8_t> same(text.begin(), text.end());
+  std::vector<uint8_t> sameSize = same;
+  sameSize.back() = 'y';
+  std::vector<uint8_t> other = {'o', 't', 'h', 'e', 'r'};
+  fs::path source = createTestFile("same.txt", text);
+
+  for (bool compress : {false, true}) {
+    bigx::Writer writer;
+    std::string error;
+    ASSERT_TRUE(writer.addFile(same, "data/a.ini", &error)) << error;
+    ASSERT_TRUE(writer.addFile(sameSize, "data/b.ini", &error)) << error;
+    ASSERT_TRUE(writer.addFile(source, "data/c.ini", &error)) << error;
+    ASSERT_TRUE(writer.addFileView(same, "data/d.ini", &error)) << error;
+    ASSERT_TRUE(writer.addFile(other, "data/e.ini", &error)) << error;
+
+    bigx::WriteOptions options;
+    options.compress = compress;
+    fs::path plainPath = tempDir_ / "plain.big";
+    ASSERT_TRUE(writer.write(plainPath, options, &error)) << error;
+    options.deduplicate = true;
+    fs::path dedupPath = tempDir_ / "dedup.big";
+    ASSERT_TRUE(writer.write(dedupPath, options, &error)) << error;
+
+    auto plain = bigx::Reader::open(plainPath, &error);
+    ASSERT_TRUE(plain.has_value()) << error;
+    auto dedup = bigx::Reader::open(dedupPath, &error);
+    ASSERT_TRUE(dedup.has_value()) << error;
+    const auto &files = dedup->files();
+    ASSERT_EQ(files.size(), 5);
+    EXPECT_EQ(fs::file_size(dedupPath), fs::file_size(plainPath) - 2 * files[0].size);
+
+    EXPECT_EQ(files[2].offset, files[0].offset);
+    EXPECT_EQ(files[3].offset, files[0].offset);
+    EXPECT_NE(files[1].offset, files[0].offset);
+    EXPECT_EQ(writer.files()[3].offset, files[3].offset);
+    for (size_t i = 0; i < files.size(); ++i) {
+      auto expected = plain->getFileView(plain->files()[i]);
+      auto actual = dedup->getFileView(files[i]);
+      EXPECT_TRUE(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()))
+          << files[i].path;
+    }
+  }
+}
+
+// Test copying entries of one archive into another without extracting them
+TEST_F(WriterTest, AddFromReader) {
+  std::string text(2048, 'a');
+  std::vector<uint8_t> data(text.begin(), text.end());
+  bigx::Writer source;
+  std::string error;
+  ASSERT_TRUE(source.addFile(data, "Data/big.ini", &error)) << error;
+  ASSERT_TRUE(source.addFile(std::vector<uint8_t>{'h', 'i'}, "Data/small.txt", &error)) << error;
+  bigx::WriteOptions options;
+  options.compress = true;
+  fs::path sourcePath = tempDir_ / "source.big";
+  ASSERT_TRUE(source.write(sourcePath, options, &error)) << error;
+
+  auto reader = bigx::Reader::open(sourcePath, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  const bigx::FileEntry *big = reader->findFile("data/big.ini");
+  ASSERT_NE(big, nullptr);
+  ASSERT_TRUE(reader->isCompressed(*big));
+
+  bigx::Writer writer;
+  ASSERT_TRUE(writer.addFromReader(*reader, *big, "Copied/big.ini", &error)) << error;
+  EXPECT_FALSE(writer.addFromReader(*reader, *big, "copied\\BIG.ini", &error));
+  fs::path outputPath = tempDir_ / "output.big";
+  ASSERT_TRUE(writer.write(outputPath, &error)) << error;
+
+  auto output = bigx::Reader::open(outputPath, &error);
+  ASSERT_TRUE(output.has_value()) << error;
+  ASSERT_EQ(output->fileCount(), 1);
+  const bigx::FileEntry &copied = output->files()[0];
+  EXPECT_EQ(copied.path, "Copied/big.ini");
+  auto expected = reader->getFileView(*big);
+  auto actual = output->getFileView(copied);
+  EXPECT_TRUE(std::equal(actual.begin(), actual.end(), expected.begin(), expected.end()));
+  EXPECT_TRUE(output->isCompressed(copied));
+}
+
+// Test merging archives under each conflict policy
+TEST_F(WriterTest, MergeArchives) {
+  auto makeArchive = [this](const std::string &name,
+                            const std::vector<std::pair<std::string, std::string>> &files) {
+    bigx::Writer writer;
+    for (const auto &[path, content] : files) {
+      EXPECT_TRUE(writer.addFile(std::vector<uint8_t>(content.begin(), content.end()), path));
+    }
+    fs::path path = tempDir_ / name;
+    EXPECT_TRUE(writer.write(path));
+    return path;
+  };
+  fs::path basePath = makeArchive("base.big", {{"Data/a.ini", "base a"}, {"Data/b.ini", "base b"}});
+  fs::path patchPath =
+      makeArchive("patch.big", {{"data/B.ini", "patch b"}, {"Data/c.ini", "patch c"},
+                                {"Art/skip.tga", "skipped"}});
+
+  std::string error;
+  auto base = bigx::Reader::open(basePath, &error);
+  ASSERT_TRUE(base.has_value()) << error;
+  auto patch = bigx::Reader::open(patchPath, &error);
+  ASSERT_TRUE(patch.has_value()) << error;
+
+  auto contentOf = [](const bigx::Reader &reader, const std::string &path) {
+    const bigx::FileEntry *entry = reader.findFile(path);
+    if (!entry) {
+      return std::string("<missing>");
+    }
+    auto view = reader.getFileView(*entry);
+    return std::string(view.begin(), view.end());
+  };
+
+  bigx::MergeOptions options;
+  options.filter = [](const bigx::EntryView &entry) { return !entry.path.starts_with("Art/"); };
+
+  {
+    bigx::Writer writer;
+    ASSERT_TRUE(writer.addArchive(*base, {}, &error)) << error;
+    EXPECT_FALSE(writer.addArchive(*patch, options, &error));
+    EXPECT_NE(error.find("Duplicate"), std::string::npos);
+  }
+
+  for (auto policy : {bigx::MergeConflict::KeepExisting, bigx::MergeConflict::Replace}) {
+    bigx::Writer writer;
+    ASSERT_TRUE(writer.addArchive(*base, {}, &error)) << error;
+    options.onConflict = policy;
+    ASSERT_TRUE(writer.addArchive(*patch, options, &error)) << error;
+    fs::path mergedPath = tempDir_ / "merged.big";
+    ASSERT_TRUE(writer.write(mergedPath, &error)) << error;
+
+    auto merged = bigx::Reader::open(mergedPath, &error);
+    ASSERT_TRUE(merged.has_value()) << error;
+    ASSERT_EQ(merged->fileCount(), 3);
+    bool replaced = policy == bigx::MergeConflict::Replace;
+    EXPECT_EQ(merged->files()[1].path, replaced ? "data/B.ini" : "Data/b.ini");
+    EXPECT_EQ(contentOf(*merged, "Data/a.ini"), "base a");
+    EXPECT_EQ(contentOf(*merged, "Data/b.ini"), replaced ? "patch b" : "base b");
+    EXPECT_EQ(contentOf(*merged, "Data/c.ini"), "patch c");
+    EXPECT_EQ(contentOf(*merged, "Art/skip.tga"), "<missing>");
+  }
+
+  // A prefix keeps both copies apart
+  bigx::Writer writer;
+  ASSERT_TRUE(writer.addArchive(*base, {}, &error)) << error;
+  bigx::MergeOptions prefixed;
+  prefixed.prefix = "Patch\\";
+  ASSERT_TRUE(writer.addArchive(*patch, prefixed, &error)) << error;
+  EXPECT_EQ(writer.fileCount(), 5);
+}
+
+// Test payload ordering policies; the directory keeps insertion order either way
+TEST_F(WriterTest, PayloadOrder) {
+  const std::vector<std::pair<std::string, size_t>> files = {
+      {"Maps/b.map", 30}, {"Data/z.ini", 10}, {"Maps/a.map", 20}, {"Data/a.ini", 40}};
+  bigx::Writer writer;
+  for (size_t i = 0; i < files.size(); ++i) {
+    ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(files[i].second, static_cast<uint8_t>(i)),
+                               files[i].first));
+  }
+
+  // Paths of the written payloads sorted by offset
+  auto storedOrder = [&](const bigx::WriteOptions &options) {
+    fs::path path = tempDir_ / "ordered.big";
+    std::string error;
+    EXPECT_TRUE(writer.write(path, options, &error)) << error;
+    auto reader = bigx::Reader::open(path, &error);
+    EXPECT_TRUE(reader.has_value()) << error;
+    std::vector<std::string> paths;
+    std::vector<bigx::FileEntry> entries = reader->files();
+    for (size_t i = 0; i < entries.size(); ++i) {
+      EXPECT_EQ(entries[i].path, files[i].first);
+      auto view = reader->getFileView(entries[i]);
+      EXPECT_EQ(view.size(), files[i].second);
+      EXPECT_TRUE(std::all_of(view.begin(), view.end(), [i](uint8_t b) { return b == i; }));
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto &a, const auto &b) { return a.offset < b.offset; });
+    for (const auto &entry : entries) {
+      paths.push_back(entry.path);
+    }
+    return paths;
+  };
+
+  bigx::WriteOptions options;
+  using Paths = std::vector<std::string>;
+  EXPECT_EQ(storedOrder(options), (Paths{"Maps/b.map", "Data/z.ini", "Maps/a.map", "Data/a.ini"}));
+  options.payloadOrder = bigx::PayloadOrder::Path;
+  EXPECT_EQ(storedOrder(options), (Paths{"Data/a.ini", "Data/z.ini", "Maps/a.map", "Maps/b.map"}));
+  options.payloadOrder = bigx::PayloadOrder::Size;
+  EXPECT_EQ(storedOrder(options), (Paths{"Data/z.ini", "Maps/a.map", "Maps/b.map", "Data/a.ini"}));
+  options.payloadOrder = bigx::PayloadOrder::Profile;
+  options.accessOrder = {"maps\\A.map", "Unknown.ini", "data/a.ini"};
+  EXPECT_EQ(storedOrder(options), (Paths{"Maps/a.map", "Data/a.ini", "Maps/b.map", "Data/z.ini"}));
+}
+
+// Test aligning large payloads to page boundaries
+TEST_F(WriterTest, PayloadAlignment) {
+  bigx::Writer writer;
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(100, 1), "small.txt"));
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(5000, 2), "large1.bin"));
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(10, 3), "tiny.txt"));
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(4096, 4), "large2.bin"));
+
+  bigx::WriteOptions options;
+  options.payloadAlignment = 4096;
+  options.alignThreshold = 4096;
+  fs::path path = tempDir_ / "aligned.big";
+  std::string error;
+  ASSERT_TRUE(writer.write(path, options, &error)) << error;
+
+  auto reader = bigx::Reader::open(path, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  const auto &entries = reader->files();
+  ASSERT_EQ(entries.size(), 4);
+  EXPECT_EQ(entries[1].offset % 4096, 0);
+  EXPECT_EQ(entries[3].offset % 4096, 0);
+  EXPECT_EQ(entries[2].offset, entries[1].offset + 5000); // Below the threshold: packed
+  EXPECT_EQ(fs::file_size(path), entries[3].offset + 4096);
+  for (const auto &entry : entries) {
+    auto view = reader->getFileView(entry);
+    ASSERT_EQ(view.size(), entry.size);
+    EXPECT_EQ(view[0], static_cast<uint8_t>(&entry - entries.data() + 1));
+  }
+
+  options.payloadAlignment = 3000;
+  EXPECT_FALSE(writer.write(path, options, &error));
+  EXPECT_NE(error.find("power of two"), std::string::npos);
+}
+
+// Test that the checksum trailer stores standard CRC-32C values
+TEST_F(WriterTest, ChecksumTrailerLayout) {
+  std::string text = "123456789";
+  bigx::Writer writer;
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(text.begin(), text.end()), "a"));
+  bigx::WriteOptions options;
+  options.checksums = true;
+  fs::path path = tempDir_ / "crc.big";
+  std::string error;
+  ASSERT_TRUE(writer.write(path, options, &error)) << error;
+
+  // Header, one record, the payload, one CRC and the footer
+  std::ifstream in(path, std::ios::binary);
+  std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)),
+                             std::istreambuf_iterator<char>());
+  ASSERT_EQ(bytes.size(), 16 + 10 + 9 + 4 + 24);
+  uint32_t crc;
+  std::memcpy(&crc, bytes.data() + 35, 4);
+  EXPECT_EQ(bigx::betoh32(crc), 0xe3069283u);
+  EXPECT_EQ(std::memcmp(bytes.data() + 39, "BIGXCRC1", 8), 0);
+
+  auto reader = bigx::Reader::open(path, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_TRUE(reader->hasChecksums());
+  EXPECT_EQ(reader->files()[0].size, 9);
+}
+
+// Test verifying checksummed archives and finding corrupt payloads
+TEST_F(WriterTest, VerifyChecksums) {
+  bigx::Writer writer;
+  std::string error;
+  for (int i = 0; i < 50; ++i) {
+    std::string text = std::format("payload {} {}", i, std::string(i * 10, 'x'));
+    ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(text.begin(), text.end()),
+                               std::format("Data/File_{:02}.ini", i), &error));
+  }
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>{}, "empty.txt", &error));
+
+  for (bool indexTrailer : {false, true}) {
+    bigx::WriteOptions options;
+    options.checksums = true;
+    options.indexTrailer = indexTrailer;
+    options.deduplicate = true;
+    fs::path path = tempDir_ / "checked.big";
+    ASSERT_TRUE(writer.write(path, options, &error)) << error;
+
+    {
+      auto reader = bigx::Reader::open(path, &error);
+      ASSERT_TRUE(reader.has_value()) << error;
+      EXPECT_EQ(reader->hasIndexTrailer(), indexTrailer);
+      EXPECT_TRUE(reader->hasChecksums());
+      bigx::VerifyOptions verifyOptions;
+      verifyOptions.threads = 4;
+      bigx::VerifyResult result = reader->verify(verifyOptions);
+      EXPECT_TRUE(result.ok()) << (result.failures.empty() ? result.error
+                                                            : result.failures[0].error);
+      EXPECT_TRUE(result.checksummed);
+      EXPECT_EQ(result.checked, 51);
+    }
+
+    // Flip one byte in three payloads
+    const auto &files = writer.files();
+    {
+      std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+      for (size_t i : {40, 7, 30}) {
+        file.seekp(static_cast<std::streamoff>(files[i].offset + 3));
+        file.put('#');
+      }
+    }
+
+    auto reader = bigx::Reader::open(path, &error);
+    ASSERT_TRUE(reader.has_value()) << error;
+    bigx::VerifyOptions verifyOptions;
+    verifyOptions.maxFailures = 2;
+    bigx::VerifyResult result = reader->verify(verifyOptions);
+    EXPECT_FALSE(result.ok());
+    EXPECT_EQ(result.corrupt, 3);
+    ASSERT_EQ(result.failures.size(), 2);
+    EXPECT_EQ(result.failures[0].entry->path, "Data/File_07.ini");
+    EXPECT_EQ(result.failures[1].entry->path, "Data/File_30.ini");
+    EXPECT_NE(result.failures[0].error.find("Checksum"), std::string::npos);
+  }
+}
+
+// Test the structural checks that also apply to archives without checksums
+TEST_F(WriterTest, VerifyLegacyArchive) {
+  bigx::Writer writer;
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(100, 'a'), "a.bin"));
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(100, 'b'), "b.bin"));
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(100, 'c'), "c.bin"));
+  fs::path path = tempDir_ / "legacy.big";
+  ASSERT_TRUE(writer.write(path));
+
+  {
+    auto reader = bigx::Reader::open(path);
+    ASSERT_TRUE(reader.has_value());
+    EXPECT_FALSE(reader->hasChecksums());
+    bigx::VerifyResult result = reader->verify();
+    EXPECT_TRUE(result.ok());
+    EXPECT_FALSE(result.checksummed);
+    EXPECT_EQ(result.checked, 3);
+    EXPECT_EQ(result.bytesChecked, 0);
+  }
+
+  // Point b into the middle of a, and c into the directory (BigF records: offset, size, path)
+  const auto &files = writer.files();
+  auto patchOffset = [&](size_t record, uint64_t offset) {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    uint32_t be = bigx::htobe32(static_cast<uint32_t>(offset));
+    file.seekp(static_cast<std::streamoff>(16 + record * (8 + 6)));
+    file.write(reinterpret_cast<const char *>(&be), 4);
+  };
+  patchOffset(1, files[0].offset + 50);
+  patchOffset(2, 20);
+
+  auto reader = bigx::Reader::open(path);
+  ASSERT_TRUE(reader.has_value());
+  bigx::VerifyResult result = reader->verify();
+  EXPECT_EQ(result.corrupt, 2);
+  ASSERT_EQ(result.failures.size(), 2);
+  EXPECT_EQ(result.failures[0].entry->path, "b.bin");
+  EXPECT_EQ(result.failures[0].error, "Payload overlaps a.bin");
+  EXPECT_EQ(result.failures[1].entry->path, "c.bin");
+  EXPECT_NE(result.failures[1].error.find("directory"), std::string::npos);
+}
+
+// Test that an in-place update leaves a stale checksum trailer ignored
+TEST_F(WriterTest, StaleChecksumsIgnored) {
+  bigx::Writer writer;
+  ASSERT_TRUE(writer.addFile(std::vector<uint8_t>(10, 'a'), "a.bin"));
+  bigx::WriteOptions options;
+  options.checksums = true;
+  options.directorySlack = 256;
+  fs::path path = tempDir_ / "updated.big";
+  ASSERT_TRUE(writer.write(path, options));
+
+  std::string error;
+  auto updater = bigx::Updater::open(path, &error);
+  ASSERT_TRUE(updater.has_value()) << error;
+  ASSERT_TRUE(updater->addFile(std::vector<uint8_t>(5, 'b'), "b.bin", &error)) << error;
+  ASSERT_TRUE(updater->commit({}, &error)) << error;
+
+  auto reader = bigx::Reader::open(path, &error);
+  ASSERT_TRUE(reader.has_value()) << error;
+  EXPECT_EQ(reader->fileCount(), 2);
+  EXPECT_FALSE(reader->hasChecksums());
+  bigx::VerifyResult result = reader->verify();
+  EXPECT_TRUE(result.ok());
+  EXPECT_FALSE(result.checksummed);
+}
@@ -0,0 +1,593 @@
+// bigx: command-line front end for packing, unpacking and inspecting BIG archives
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <bigx/bigx.hpp>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr int exitOk = 0;
+constexpr int exitFailed = 1; // Operation failed, or verify/diff found problems
+constexpr int exitUsage = 2;
+
+constexpr std::string_view usageText = R"(Usage: bigx <command> [options] <arguments>
+
+Commands:
+  list    [-l] <archive> [pattern...]     List entries (optionally matching glob patterns)
+  unpack  <archive> <dir>                 Extract entries into a directory
+  pack    <archive> <path...>             Create an archive from files and directories
+  verify  <archive>                       Check the directory and payload checksums
+  merge   <archive> <input...>            Combine archives into a new one (later inputs win
+                                          with --on-conflict replace)
+  diff    <archive> <archive>             Compare the contents of two archives
+
+Options:
+  -j, --jobs N          Worker threads (default: 0 = one per hardware thread)
+  -i, --include GLOB    Only take paths matching GLOB (repeatable)
+  -x, --exclude GLOB    Skip paths matching GLOB (repeatable, wins over --include)
+  -l, --long            list: show offsets, stored and extracted sizes
+      --raw             list/unpack/diff: keep RefPack payloads compressed
+      --batched         unpack: write files through batched native I/O
+      --prefix P        pack/merge: prepend P to every stored path
+      --format F        pack/merge: bigf (default), big4 or bigx (64-bit)
+      --compress        pack/merge: RefPack-compress payloads
+      --dedupe          pack/merge: store identical payloads once
+      --checksums       pack/merge: append a CRC-32C trailer for verify
+      --index           pack/merge: append a prebuilt lookup index
+      --order O         pack/merge: insertion (default), path or size
+      --align N         pack/merge: start payloads on an N-byte boundary
+      --on-conflict C   merge: fail (default), keep or replace duplicate paths
+      --stats           Print file counts, throughput and phase timings to stderr
+  -h, --help            Show this help
+
+Globs match whole archive paths case-insensitively: '*' and '?' stay within one directory and
+a "**" segment spans any number of them, e.g. "Data/**/*.ini".
+)";
+
+// Command-line settings shared by every command
+struct Settings {
+  std::vector<std::string> args; // Positional arguments after the command
+  unsigned threads = 0;
+  std::vector<std::string> include;
+  std::vector<std::string> exclude;
+  bool longList = false;
+  bool raw = false;
+  bool batched = false;
+  std::string prefix;
+  bigx::ArchiveFormat format = bigx::ArchiveFormat::BigF;
+  bool compress = false;
+  bool dedupe = false;
+  bool checksums = false;
+  bool index = false;
+  bigx::PayloadOrder order = bigx::PayloadOrder::Insertion;
+  size_t align = 0;
+  bigx::MergeConflict onConflict = bigx::MergeConflict::Fail;
+  bool stats = false;
+
+  // Whether path passes the --include and --exclude globs
+  bool selected(std::string_view path) const {
+    auto matches = [path](const std::string &pattern) { return bigx::globMatch(pattern, path); };
+    if (!include.empty() && std::none_of(include.begin(), include.end(), matches)) {
+      return false;
+    }
+    return std::none_of(exclude.begin(), exclude.end(), matches);
+  }
+
+  bool filtered() const { return !include.empty() || !exclude.empty(); }
+
+  unsigned resolvedThreads() const {
+    return threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  bigx::WriteOptions writeOptions() const {
+    bigx::WriteOptions options;
+    options.threads = threads;
+    options.format = format;
+    options.promoteLarge = true;
+    options.compress = compress;
+    options.deduplicate = dedupe;
+    options.checksums = checksums;
+    options.indexTrailer = index;
+    options.payloadOrder = order;
+    options.payloadAlignment = align;
+    return options;
+  }
+};
+
+// Work totals and phase timings reported by --stats
+class Report {
+public:
+  size_t files = 0;   // Entries listed, extracted, packed, checked or compared
+  uint64_t bytes = 0; // Payload or archive bytes processed
+
+  // Callback for OpenOptions::onPhase / WriteOptions::onPhase (may run on worker threads)
+  bigx::PhaseCallback phaseCallback() {
+    return [this](bigx::Phase phase, std::chrono::nanoseconds duration) {
+      std::lock_guard lock(mutex_);
+      auto it = std::find_if(phases_.begin(), phases_.end(),
+                             [phase](const auto &entry) { return entry.first == phase; });
+      if (it == phases_.end()) {
+        phases_.emplace_back(phase, duration);
+      } else {
+        it->second += duration;
+      }
+    };
+  }
+
+  void print() const {
+    double seconds = std::chrono::duration<double>(Clock::now() - start_).count();
+    double mib = static_cast<double>(bytes) / (1024.0 * 1024.0);
+    std::cerr << std::format("files:      {}\n", files);
+    std::cerr << std::format("bytes:      {} ({:.2f} MiB)\n", bytes, mib);
+    std::cerr << std::format("elapsed:    {:.3f} ms\n", seconds * 1000.0);
+    if (seconds > 0) {
+      std::cerr << std::format("throughput: {:.1f} MiB/s, {:.0f} files/s\n", mib / seconds,
+                               static_cast<double>(files) / seconds);
+    }
+    if constexpr (!bigx::statsEnabled) {
+      std::cerr << "phases:     (library built without BIGX_ENABLE_STATS)\n";
+    }
+    std::lock_guard lock(mutex_);
+    for (const auto &[phase, duration] : phases_) {
+      std::cerr << std::format("  {:<18} {:.3f} ms\n", bigx::phaseName(phase),
+                               std::chrono::duration<double, std::milli>(duration).count());
+    }
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  Clock::time_point start_ = Clock::now();
+  mutable std::mutex mutex_;
+  std::vector<std::pair<bigx::Phase, std::chrono::nanoseconds>> phases_;
+};
+
+int fail(const std::string &message) {
+  std::cerr << "bigx: " << message << "\n";
+  return exitFailed;
+}
+
+int usageError(const std::string &message) {
+  std::cerr << "bigx: " << message << "\nRun 'bigx --help' for usage.\n";
+  return exitUsage;
+}
+
+std::optional<bigx::Reader> openArchive(const std::string &path, const Settings &settings,
+                                        Report &report, std::string *outError) {
+  bigx::OpenOptions options;
+  options.decompress = !settings.raw;
+  options.onPhase = report.phaseCallback();
+  auto reader = bigx::Reader::open(path, options, outError);
+  if (!reader && outError) {
+    *outError = std::format("{}: {}", path, *outError);
+  }
+  return reader;
+}
+
+int runList(const Settings &settings, Report &report) {
+  std::string error;
+  auto reader = openArchive(settings.args[0], settings, report, &error);
+  if (!reader) {
+    return fail(error);
+  }
+  std::vector<std::string> patterns(settings.args.begin() + 1, settings.args.end());
+
+  for (const bigx::FileEntry &entry : reader->files()) {
+    bool matched = patterns.empty() ||
+                   std::any_of(patterns.begin(), patterns.end(), [&entry](const auto &pattern) {
+                     return bigx::globMatch(pattern, entry.path);
+                   });
+    if (!matched || !settings.selected(entry.path)) {
+      continue;
+    }
+    ++report.files;
+    report.bytes += entry.size;
+    if (settings.longList) {
+      std::cout << std::format("{:>12} {:>12} {:>12} {} {}\n", entry.offset, entry.size,
+                               reader->extractedSize(entry),
+                               reader->isCompressed(entry) ? 'C' : '-', entry.path);
+    } else {
+      std::cout << entry.path << "\n";
+    }
+  }
+  if (settings.longList) {
+    std::cout << std::format("{} of {} entries, {} stored bytes\n", report.files,
+                             reader->fileCount(), report.bytes);
+  }
+  return exitOk;
+}
+
+int runUnpack(const Settings &settings, Report &report) {
+  std::string error;
+  auto reader = openArchive(settings.args[0], settings, report, &error);
+  if (!reader) {
+    return fail(error);
+  }
+
+  bigx::ExtractOptions options;
+  options.threads = settings.threads;
+  options.backend = settings.batched ? bigx::ExtractBackend::Batched
+                                     : bigx::ExtractBackend::Portable;
+  fs::path destDir = settings.args[1];
+  bigx::ExtractResult result =
+      settings.filtered()
+          ? reader->extractAll(
+                destDir,
+                [&settings](const bigx::FileEntry &entry) { return settings.selected(entry.path); },
+                options)
+          : reader->extractAll(destDir, options);
+
+  report.files = result.extracted;
+  report.bytes = result.bytesWritten;
+  for (const auto &failure : result.failures) {
+    std::cerr << std::format("bigx: {}: {}\n", failure.entry ? failure.entry->path : "<archive>",
+                             failure.error);
+  }
+  return result.ok() ? exitOk : exitFailed;
+}
+
+// Write writer to settings.args[0] and account for the result
+int finishWrite(bigx::Writer &writer, const Settings &settings, Report &report) {
+  bigx::WriteOptions options = settings.writeOptions();
+  options.onPhase = report.phaseCallback();
+  std::error_code ec;
+  fs::path destPath = settings.args[0];
+  if (destPath.has_parent_path()) {
+    fs::create_directories(destPath.parent_path(), ec);
+  }
+  std::string error;
+  if (!writer.write(destPath, options, &error)) {
+    return fail(std::format("{}: {}", settings.args[0], error));
+  }
+  report.files = writer.fileCount();
+  report.bytes = fs::file_size(settings.args[0], ec);
+  return exitOk;
+}
+
+int runPack(const Settings &settings, Report &report) {
+  std::vector<bigx::FileSource> sources;
+  for (size_t i = 1; i < settings.args.size(); ++i) {
+    fs::path input = settings.args[i];
+    std::error_code ec;
+    if (fs::is_regular_file(input, ec)) {
+      sources.push_back({input, settings.prefix + input.filename().generic_string()});
+      continue;
+    }
+    if (!fs::is_directory(input, ec)) {
+      return fail(std::format("{}: no such file or directory", input.string()));
+    }
+    for (fs::recursive_directory_iterator it(input, ec), end; !ec && it != end; it.increment(ec)) {
+      if (it->is_regular_file(ec)) {
+        sources.push_back(
+            {it->path(), settings.prefix + it->path().lexically_relative(input).generic_string()});
+      }
+    }
+    if (ec) {
+      return fail(std::format("{}: {}", input.string(), ec.message()));
+    }
+  }
+  std::erase_if(sources, [&settings](const bigx::FileSource &source) {
+    return !settings.selected(source.archivePath);
+  });
+
+  // Sorted so the archive does not depend on directory iteration order
+  std::sort(sources.begin(), sources.end(), [](const auto &a, const auto &b) {
+    return a.archivePath < b.archivePath;
+  });
+
+  bigx::Writer writer;
+  std::string error;
+  if (!writer.addFiles(sources, &error)) {
+    return fail(error);
+  }
+  return finishWrite(writer, settings, report);
+}
+
+int runVerify(const Settings &settings, Report &report) {
+  std::string error;
+  auto reader = openArchive(settings.args[0], settings, report, &error);
+  if (!reader) {
+    return fail(error);
+  }
+
+  bigx::VerifyOptions options;
+  options.threads = settings.threads;
+  bigx::VerifyResult result = reader->verify(options);
+  report.files = result.checked;
+  report.bytes = result.bytesChecked;
+  if (!result.error.empty()) {
+    return fail(std::format("{}: {}", settings.args[0], result.error));
+  }
+  for (const auto &failure : result.failures) {
+    std::cout << std::format("CORRUPT {}: {}\n", failure.entry->path, failure.error);
+  }
+  if (result.corrupt > result.failures.size()) {
+    std::cout << std::format("... and {} more\n", result.corrupt - result.failures.size());
+  }
+  std::cout << std::format("{}: {} entries, {} corrupt, {}\n", settings.args[0], result.checked,
+                           result.corrupt,
+                           result.checksummed ? "payload checksums checked"
+                                              : "no checksums (directory checked only)");
+  return result.ok() ? exitOk : exitFailed;
+}
+
+int runMerge(const Settings &settings, Report &report) {
+  // Inputs stay open until the output is written, since payloads are copied from their mappings
+  std::vector<bigx::Reader> inputs;
+  inputs.reserve(settings.args.size() - 1);
+  std::error_code ec;
+  for (size_t i = 1; i < settings.args.size(); ++i) {
+    if (fs::equivalent(settings.args[0], settings.args[i], ec)) {
+      return fail(std::format("{}: output must not be one of the inputs", settings.args[0]));
+    }
+    std::string error;
+    auto reader = openArchive(settings.args[i], settings, report, &error);
+    if (!reader) {
+      return fail(error);
+    }
+    inputs.push_back(std::move(*reader));
+  }
+
+  bigx::MergeOptions options;
+  options.onConflict = settings.onConflict;
+  options.prefix = settings.prefix;
+  if (settings.filtered()) {
+    options.filter = [&settings](const bigx::EntryView &entry) {
+      return settings.selected(entry.path);
+    };
+  }
+  bigx::Writer writer;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    std::string error;
+    if (!writer.addArchive(inputs[i], options, &error)) {
+      return fail(std::format("{}: {}", settings.args[i + 1], error));
+    }
+  }
+  return finishWrite(writer, settings, report);
+}
+
+int runDiff(const Settings &settings, Report &report) {
+  std::string error;
+  auto left = openArchive(settings.args[0], settings, report, &error);
+  if (!left) {
+    return fail(error);
+  }
+  auto right = openArchive(settings.args[1], settings, report, &error);
+  if (!right) {
+    return fail(error);
+  }
+
+  // Pair up entries present on both sides; compare them in parallel
+  std::vector<std::pair<const bigx::FileEntry *, const bigx::FileEntry *>> pairs;
+  std::vector<std::string> removed;
+  std::vector<std::string> added;
+  for (const bigx::FileEntry &entry : left->files()) {
+    if (!settings.selected(entry.path)) {
+      continue;
+    }
+    if (const bigx::FileEntry *other = right->findFile(entry.path)) {
+      pairs.emplace_back(&entry, other);
+    } else {
+      removed.push_back(entry.path);
+    }
+  }
+  for (const bigx::FileEntry &entry : right->files()) {
+    if (settings.selected(entry.path) && !left->findFile(entry.path)) {
+      added.push_back(entry.path);
+    }
+  }
+
+  // Identical stored bytes are equal; otherwise compare the extracted contents
+  std::vector<char> differs(pairs.size());
+  std::atomic<size_t> next{0};
+  std::atomic<uint64_t> compared{0};
+  auto worker = [&]() {
+    for (size_t i = next.fetch_add(1); i < pairs.size(); i = next.fetch_add(1)) {
+      const auto &[a, b] = pairs[i];
+      auto viewA = left->getFileView(*a);
+      auto viewB = right->getFileView(*b);
+      compared.fetch_add(viewA.size() + viewB.size(), std::memory_order_relaxed);
+      if (std::equal(viewA.begin(), viewA.end(), viewB.begin(), viewB.end())) {
+        continue;
+      }
+      auto dataA = left->extractToMemory(*a);
+      auto dataB = right->extractToMemory(*b);
+      differs[i] = !dataA || !dataB || *dataA != *dataB;
+    }
+  };
+  std::vector<std::thread> threads;
+  auto threadCount =
+      static_cast<unsigned>(std::min<size_t>(settings.resolvedThreads(), pairs.size() / 64 + 1));
+  for (unsigned t = 1; t < threadCount; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  size_t changes = removed.size() + added.size();
+  for (const std::string &path : removed) {
+    std::cout << "- " << path << "\n";
+  }
+  for (const std::string &path : added) {
+    std::cout << "+ " << path << "\n";
+  }
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    if (differs[i]) {
+      std::cout << "M " << pairs[i].first->path << "\n";
+      ++changes;
+    }
+  }
+  report.files = pairs.size() + removed.size() + added.size();
+  report.bytes = compared.load();
+  return changes == 0 ? exitOk : exitFailed;
+}
+
+struct Command {
+  std::string_view name;
+  size_t minArgs;
+  size_t maxArgs;
+  int (*run)(const Settings &, Report &);
+};
+
+constexpr size_t unlimited = SIZE_MAX;
+constexpr Command commands[] = {
+    {"list", 1, unlimited, runList},   {"unpack", 2, 2, runUnpack},
+    {"pack", 2, unlimited, runPack},   {"verify", 1, 1, runVerify},
+    {"merge", 2, unlimited, runMerge}, {"diff", 2, 2, runDiff},
+};
+
+// Parse the options and positional arguments that follow the command name
+// Returns an error message, empty on success
+std::string parseSettings(int argc, char *argv[], Settings &settings) {
+  for (int i = 2; i < argc; ++i) {
+    std::string_view arg = argv[i];
+    auto value = [&]() -> std::optional<std::string_view> {
+      if (i + 1 >= argc) {
+        return std::nullopt;
+      }
+      return std::string_view(argv[++i]);
+    };
+    auto number = [](std::string_view text) -> std::optional<size_t> {
+      if (text.empty() || text.size() > 9 ||
+          !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return std::nullopt;
+      }
+      return std::stoul(std::string(text));
+    };
+
+    if (arg == "-l" || arg == "--long") {
+      settings.longList = true;
+    } else if (arg == "--raw") {
+      settings.raw = true;
+    } else if (arg == "--batched") {
+      settings.batched = true;
+    } else if (arg == "--compress") {
+      settings.compress = true;
+    } else if (arg == "--dedupe") {
+      settings.dedupe = true;
+    } else if (arg == "--checksums") {
+      settings.checksums = true;
+    } else if (arg == "--index") {
+      settings.index = true;
+    } else if (arg == "--stats") {
+      settings.stats = true;
+    } else if (arg == "-j" || arg == "--jobs" || arg == "--align") {
+      auto text = value();
+      auto parsed = text ? number(*text) : std::nullopt;
+      if (!parsed) {
+        return std::format("{} needs a number", arg);
+      }
+      if (arg == "--align") {
+        settings.align = *parsed;
+      } else {
+        settings.threads = static_cast<unsigned>(*parsed);
+      }
+    } else if (arg == "-i" || arg == "--include" || arg == "-x" || arg == "--exclude" ||
+               arg == "--prefix" || arg == "--format" || arg == "--order" ||
+               arg == "--on-conflict") {
+      auto text = value();
+      if (!text) {
+        return std::format("{} needs a value", arg);
+      }
+      if (arg == "-i" || arg == "--include") {
+        settings.include.emplace_back(*text);
+      } else if (arg == "-x" || arg == "--exclude") {
+        settings.exclude.emplace_back(*text);
+      } else if (arg == "--prefix") {
+        settings.prefix = *text;
+      } else if (arg == "--format") {
+        if (*text == "bigf") {
+          settings.format = bigx::ArchiveFormat::BigF;
+        } else if (*text == "big4") {
+          settings.format = bigx::ArchiveFormat::Big4;
+        } else if (*text == "bigx") {
+          settings.format = bigx::ArchiveFormat::Big64;
+        } else {
+          return std::format("unknown format '{}'", *text);
+        }
+      } else if (arg == "--order") {
+        if (*text == "insertion") {
+          settings.order = bigx::PayloadOrder::Insertion;
+        } else if (*text == "path") {
+          settings.order = bigx::PayloadOrder::Path;
+        } else if (*text == "size") {
+          settings.order = bigx::PayloadOrder::Size;
+        } else {
+          return std::format("unknown payload order '{}'", *text);
+        }
+      } else if (*text == "fail") {
+        settings.onConflict = bigx::MergeConflict::Fail;
+      } else if (*text == "keep") {
+        settings.onConflict = bigx::MergeConflict::KeepExisting;
+      } else if (*text == "replace") {
+        settings.onConflict = bigx::MergeConflict::Replace;
+      } else {
+        return std::format("unknown conflict mode '{}'", *text);
+      }
+    } else if (arg.size() > 1 && arg.front() == '-') {
+      return std::format("unknown option '{}'", arg);
+    } else {
+      settings.args.emplace_back(arg);
+    }
+  }
+  return {};
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::cerr << usageText;
+    return exitUsage;
+  }
+  std::string_view name = argv[1];
+  if (name == "-h" || name == "--help" || name == "help") {
+    std::cout << usageText;
+    return exitOk;
+  }
+  for (int i = 2; i < argc; ++i) {
+    if (std::string_view(argv[i]) == "-h" || std::string_view(argv[i]) == "--help") {
+      std::cout << usageText;
+      return exitOk;
+    }
+  }
+
+  auto command = std::find_if(std::begin(commands), std::end(commands),
+                              [name](const Command &c) { return c.name == name; });
+  if (command == std::end(commands)) {
+    return usageError(std::format("unknown command '{}'", name));
+  }
+
+  Settings settings;
+  if (std::string error = parseSettings(argc, argv, settings); !error.empty()) {
+    return usageError(error);
+  }
+  if (settings.args.size() < command->minArgs || settings.args.size() > command->maxArgs) {
+    return usageError(std::format("wrong number of arguments for '{}'", name));
+  }
+
+  Report report;
+  int status = command->run(settings, report);
+  if (settings.stats) {
+    report.print();
+  }
+  return status;
+}